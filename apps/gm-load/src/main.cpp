@@ -6,6 +6,7 @@
 #include <gmCore/Updateable.hh>
 #include <gmCore/ExitException.hh>
 #include <gmCore/TimeTools.hh>
+#include <gmCore/Profiler.hh>
 
 #include <gmGraphics/Window.hh>
 #include <gmGraphics/CallbackRenderer.hh>
@@ -211,6 +212,8 @@ int main(int argc, char *argv[]) {
   try {
     while (alive) {
 
+      GM_PROFILE_SCOPE("gm-load frame");
+
       alive = windows.empty();
 
       if (is_primary_and_sync_time)
@@ -4,6 +4,7 @@
 
 #include <gmCore/config.hh>
 #include <gmCore/Console.hh>
+#include <gmCore/ParamSidecar.hh>
 
 #include <vector>
 #include <map>
@@ -37,6 +38,16 @@ class Object;
    In XML every node accepts attributes KEY, for specifying container,
    DEF, for specifying handle, and USE, for reusing node with
    specified handle.
+
+   Long lists of parameter values can be read from a sidecar file,
+   by specifying a param node with attribute `file` instead of
+   `value`, and optionally `format`. The file is memory mapped and
+   its values are passed directly to the object's setter. See
+   gmCore::ParamSidecar for the file formats.
+
+   ~~~~~{.xml}
+   <param name="value" file="urn:gramods:recording/poses.bin" format="float32"/>
+   ~~~~~
 */
 class Configuration {
 
@@ -214,8 +225,25 @@ private:
       : value(value), checked(false) {}
     std::string value;
     bool checked;
+    std::shared_ptr<ParamSidecar> sidecar;
   };
 
+  /**
+     Parses the specified string as a parameter value of type T.
+  */
+  template<class T>
+  static bool parseParam(const std::string &str, T &value);
+
+  /**
+     Adds the value of the specified parameter, or all values of its
+     sidecar, parsed as type T, to the specified vector. Returns false,
+     leaving the vector unchanged, if the values cannot be parsed.
+  */
+  template<class T>
+  static bool readParam(const std::string &name,
+                        const parameter_t &param,
+                        std::vector<T> &values);
+
   typedef std::vector<std::pair<std::string, parameter_t>> parameter_list;
   typedef std::map<std::string, std::shared_ptr<parameter_t>> overrides_list;
   struct child_t {
@@ -340,62 +368,36 @@ void Configuration::addObject(std::shared_ptr<T> ptr,
 }
 
 template<class T>
-bool Configuration::getParam(std::string name, T &value) const {
-
-  std::string string_value;
-  if (!getParam(name, string_value))
-    return false;
+bool Configuration::parseParam(const std::string &str, T &value) {
 
   try {
 
-    std::stringstream string_value_stream(string_value);
+    std::stringstream string_value_stream(str);
 
     T _value;
     string_value_stream >> _value;
 
-    if (!string_value_stream) {
-      GM_WRN("Configuration", "While getting '" << name << "', could not parse '" << string_value << "' as " << typeid(T).name() << "!");
+    if (!string_value_stream)
       return false;
-    }
 
     value = _value;
     return true;
   }
-  catch (std::exception){
-    GM_WRN("Configuration", "While getting '" << name << "', could not parse '" << string_value << "' as " << typeid(T).name() << "!");
+  catch (std::exception &){
     return false;
   }
 }
 
-template <>
-inline bool Configuration::getParam(std::string name, std::string &value) const {
-
-  Configuration * _this = const_cast<Configuration*>(this);
-
-  auto it = std::find_if(_this->parameters.begin(),
-                         _this->parameters.end(),
-                         [name](std::pair<std::string, parameter_t> pair) {
-                           return pair.first == name;
-                         });
-  if (it == _this->parameters.end()) {
-    GM_DBG1("Configuration", "Could not find " << name);
-    return false;
-  }
-
-  value = it->second.value;
-  it->second.checked = true;
-  GM_DBG1("Configuration", "Read " << name << " = " << value);
+template<>
+inline bool Configuration::parseParam(const std::string &str, std::string &value) {
+  value = str;
   return true;
 }
 
 template<>
-inline bool Configuration::getParam(std::string name, bool &value) const {
-
-  std::string string_value;
-
-  if (!getParam(name, string_value))
-    return false;
+inline bool Configuration::parseParam(const std::string &str, bool &value) {
 
+  std::string string_value = str;
   std::transform(string_value.begin(), string_value.end(), string_value.begin(),
                  [](unsigned char c){ return std::tolower(c); });
 
@@ -407,76 +409,93 @@ inline bool Configuration::getParam(std::string name, bool &value) const {
   if (string_value == "off") { value = false; return true; }
   if (string_value == "0") { value = false; return true; }
 
-  GM_WRN("Configuration", "Could not parse '" << string_value << "' as bool!");
   return false;
 }
 
-template<>
-inline std::size_t Configuration::getAllParams(std::string name, std::vector<std::string> &value) const {
+template<class T>
+bool Configuration::readParam(const std::string &name,
+                              const parameter_t &param,
+                              std::vector<T> &values) {
 
-  Configuration * _this = const_cast<Configuration*>(this);
-  std::size_t original_size = value.size();
+  if (!param.sidecar) {
+    T _value;
+    if (!parseParam(param.value, _value)) {
+      GM_WRN("Configuration", "While getting '" << name << "', could not parse '" << param.value << "' as " << typeid(T).name() << "!");
+      return false;
+    }
+    values.push_back(_value);
+    return true;
+  }
 
-  for (auto &param : _this->parameters)
-    if (param.first == name) {
-      value.push_back(param.second.value);
-      param.second.checked = true;
-      GM_DBG1("Configuration", "Read " << name << " = " << param.second.value);
+  auto parse = [](std::string_view line, T &value) {
+    if (!parseParam(std::string(line), value))
+      throw InvalidArgument(GM_STR("could not parse '" << line << "' as " << typeid(T).name()));
+  };
+
+  std::vector<T> sidecar_values;
+  try {
+    if constexpr (NumericLayout<T>::components > 0) {
+      param.sidecar->forEachValue<T>([&](const T &value) { sidecar_values.push_back(value); },
+                                     parse);
+    } else {
+      param.sidecar->forEachLine([&](std::string_view line) {
+        T value;
+        parse(line, value);
+        sidecar_values.push_back(value);
+      });
     }
+  } catch (const InvalidArgument &e) {
+    GM_WRN("Configuration", "While getting '" << name << "': " << e.what);
+    return false;
+  }
 
-  return value.size() - original_size;
+  values.insert(values.end(), sidecar_values.begin(), sidecar_values.end());
+  return true;
 }
 
-template<>
-inline std::size_t Configuration::getAllParams(std::string name, std::vector<bool> &value) const {
-   std::vector<std::string> values;
-  getAllParams(name, values);
+template<class T>
+bool Configuration::getParam(std::string name, T &value) const {
 
-  std::size_t original_size = value.size();
-  for (auto string_value : values)
-    try {
-      std::transform(string_value.begin(), string_value.end(), string_value.begin(),
-                     [](unsigned char c){ return std::tolower(c); });
-
-      if (string_value == "true") { value.push_back(true); continue; }
-      if (string_value == "on") { value.push_back(true); continue; }
-      if (string_value == "1") { value.push_back(true); continue; }
-
-      if (string_value == "false") { value.push_back(false); continue; }
-      if (string_value == "off") { value.push_back(false); continue; }
-      if (string_value == "0") { value.push_back(false); continue; }
-
-      GM_WRN("Configuration", "Could not parse '" << string_value << "' as bool!");
-    } catch (std::exception &) {
-      GM_WRN("Configuration", "Could not parse '" << string_value << "' as bool!");
-    }
-  return value.size() - original_size;
+  Configuration * _this = const_cast<Configuration*>(this);
+
+  auto it = std::find_if(_this->parameters.begin(),
+                         _this->parameters.end(),
+                         [name](std::pair<std::string, parameter_t> pair) {
+                           return pair.first == name;
+                         });
+  if (it == _this->parameters.end()) {
+    GM_DBG1("Configuration", "Could not find " << name);
+    return false;
+  }
+
+  it->second.checked = true;
+
+  // A sidecar is resolved into its values, of which the first is used
+  std::vector<T> values;
+  if (!readParam(name, it->second, values) || values.empty())
+    return false;
+
+  value = values.front();
+  GM_DBG1("Configuration", "Read " << name << " = " << it->second.value
+          << (it->second.sidecar ? " (sidecar)" : ""));
+  return true;
 }
 
 template<class T>
 inline std::size_t Configuration::getAllParams(std::string name, std::vector<T> &value) const {
-  std::vector<std::string> values;
-  getAllParams(name, values);
 
+  Configuration * _this = const_cast<Configuration*>(this);
   std::size_t original_size = value.size();
-  for (auto string_value : values)
-    try {
-
-      std::stringstream string_value_stream(string_value);
 
-      T _value;
-      string_value_stream >> _value;
-
-      if (!string_value_stream) {
-      GM_WRN("Configuration", "While getting '" << name << "', could not parse '" << string_value << "' as " << typeid(T).name() << "!");
-        return false;
+  for (auto &param : _this->parameters)
+    if (param.first == name) {
+      param.second.checked = true;
+      if (readParam(name, param.second, value)) {
+        GM_DBG1("Configuration", "Read " << name << " = " << param.second.value
+                << (param.second.sidecar ? " (sidecar)" : ""));
       }
-
-      value.push_back(_value);
-    }
-    catch (std::exception){
-      GM_WRN("Configuration", "While getting '" << name << "', could not parse '" << string_value << "' as " << typeid(T).name() << "!");
     }
+
   return value.size() - original_size;
 }
 
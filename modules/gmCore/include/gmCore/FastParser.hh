@@ -0,0 +1,239 @@
+#ifndef GRAMODS_CORE_FASTPARSER
+#define GRAMODS_CORE_FASTPARSER
+
+#include <gmCore/config.hh>
+
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Non-allocating parser of string data into values of type T, used
+   by OFactory::ParamSetter to avoid constructing a std::stringstream
+   for every parsed value.
+
+   The primary template is not available. Specializations set
+   `available` to true and provide a static method
+
+   ~~~~~{.cpp}
+   static bool parse(std::string_view str, T &value);
+   ~~~~~
+
+   that returns true and sets the value only if the string could be
+   parsed exactly as the corresponding istream operator would have
+   parsed it. In any other case, including malformed input, it must
+   return false without side effects so that the caller can fall back
+   to the istream operator. This keeps both results and error
+   reporting identical to the stream based parsing, while the common
+   case avoids stream and locale overhead.
+
+   Specializations are provided for arithmetic types and std::array
+   of arithmetic types (e.g. gmCore::float3 and gmCore::size2) in
+   this header, and for Eigen and gmCore::Pose types in the headers
+   declaring their istream operators.
+*/
+template<class T, class Enable = void>
+struct FastParser {
+  static constexpr bool available = false;
+};
+
+namespace detail {
+
+  /**
+     True for the arithmetic types that FastParser handles as
+     numbers. Character types are excluded since the istream
+     operator reads these as characters.
+  */
+  template<class T>
+  constexpr bool is_fast_number_v =
+    std::is_same_v<T, float> ||
+    std::is_same_v<T, double> ||
+    std::is_same_v<T, short> ||
+    std::is_same_v<T, unsigned short> ||
+    std::is_same_v<T, int> ||
+    std::is_same_v<T, unsigned int> ||
+    std::is_same_v<T, long> ||
+    std::is_same_v<T, unsigned long> ||
+    std::is_same_v<T, long long> ||
+    std::is_same_v<T, unsigned long long>;
+
+  /// Returns true for white space, as classified in the "C" locale.
+  constexpr bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' ||
+      c == '\v' || c == '\f' || c == '\r';
+  }
+
+  /// Returns true for decimal digits.
+  constexpr bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Advances the pointer past any white space.
+  inline void skip_space(const char *&first, const char *last) {
+    while (first != last && is_space(*first)) ++first;
+  }
+
+  /**
+     Parses one number from the specified range, skipping leading
+     white space, and advances the pointer past the number. Returns
+     false, without advancing, if the number cannot be parsed or if it
+     is written in a form that the istream operator could interpret
+     differently, such as integers with octal or hex prefix, floating
+     point infinity or values out of range.
+  */
+  template<class T>
+  bool parse_number(const char *&first, const char *last, T &value) {
+    static_assert(is_fast_number_v<T>);
+
+    const char *ptr = first;
+    skip_space(ptr, last);
+    if (ptr == last) return false;
+
+    if (*ptr == '+') {
+      ++ptr;
+      if (ptr == last) return false;
+      if (*ptr == '-') return false;
+    } else if (*ptr == '-') {
+      if constexpr (std::is_unsigned_v<T>)
+        // istream wraps negative values into unsigned types
+        return false;
+    }
+
+    const char *digits = *ptr == '-' ? ptr + 1 : ptr;
+    if (digits == last) return false;
+
+    if constexpr (std::is_floating_point_v<T>) {
+      // Leave inf, nan and hex floats to the istream operator
+      if (!is_digit(*digits) && *digits != '.') return false;
+    } else {
+      if (!is_digit(*digits)) return false;
+      // Leave base prefixed integers to the istream operator
+      if (*digits == '0' && digits + 1 != last &&
+          (is_digit(digits[1]) || digits[1] == 'x' || digits[1] == 'X'))
+        return false;
+    }
+
+    T result;
+    auto [end, ec] = std::from_chars(ptr, last, result);
+    if (ec != std::errc()) return false;
+
+    if constexpr (std::is_floating_point_v<T>)
+      // istream fails on an incomplete exponent, e.g. "1e"
+      if (end != last && (*end == 'e' || *end == 'E')) return false;
+
+    value = result;
+    first = end;
+    return true;
+  }
+
+  /**
+     Parses N numbers into the specified array, skipping white space,
+     and advances the pointer past the last number. Returns false
+     without advancing if not all N numbers can be parsed.
+  */
+  template<class T, size_t N>
+  bool parse_numbers(const char *&first, const char *last, T *values) {
+    const char *ptr = first;
+    for (size_t idx = 0; idx < N; ++idx)
+      if (!parse_number(ptr, last, values[idx])) return false;
+    first = ptr;
+    return true;
+  }
+}
+
+/**
+   FastParser for single numbers, e.g. int, size_t, float and double.
+*/
+template<class T>
+struct FastParser<T, std::enable_if_t<detail::is_fast_number_v<T>>> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, T &value) {
+    const char *ptr = str.data();
+    return detail::parse_number(ptr, str.data() + str.size(), value);
+  }
+};
+
+/**
+   FastParser for arrays of numbers, e.g. gmCore::float3 and
+   gmCore::size2, read as white space separated values.
+*/
+template<class T, size_t N>
+struct FastParser<std::array<T, N>, std::enable_if_t<detail::is_fast_number_v<T>>> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, std::array<T, N> &value) {
+    std::array<T, N> result;
+    const char *ptr = str.data();
+    if (!detail::parse_numbers<T, N>(ptr, str.data() + str.size(), result.data()))
+      return false;
+    value = result;
+    return true;
+  }
+};
+
+/**
+   Layout of types that are composed of a fixed number of numbers,
+   used to construct values directly from numeric data, such as the
+   columns of a CSV file or an array of binary floats, without going
+   through strings (see gmCore::ParamSidecar).
+
+   The primary template has no components. Specializations set
+   `components` to the number of numbers making up a value and
+   provide the static methods
+
+   ~~~~~{.cpp}
+   static void assign(const double *numbers, T &value);
+   static void extract(const T &value, double *numbers);
+   ~~~~~
+
+   reading and writing the numbers in the same order as they are
+   written in the text form of the type.
+*/
+template<class T, class Enable = void>
+struct NumericLayout {
+  static constexpr size_t components = 0;
+};
+
+/// NumericLayout for single numbers.
+template<class T>
+struct NumericLayout<T, std::enable_if_t<detail::is_fast_number_v<T>>> {
+  static constexpr size_t components = 1;
+  static void assign(const double *numbers, T &value) {
+    value = static_cast<T>(numbers[0]);
+  }
+  static void extract(const T &value, double *numbers) {
+    numbers[0] = static_cast<double>(value);
+  }
+};
+
+/// NumericLayout for bool, true for any non-zero number.
+template<>
+struct NumericLayout<bool> {
+  static constexpr size_t components = 1;
+  static void assign(const double *numbers, bool &value) {
+    value = numbers[0] != 0;
+  }
+  static void extract(const bool &value, double *numbers) {
+    numbers[0] = value ? 1 : 0;
+  }
+};
+
+/// NumericLayout for arrays of numbers, e.g. gmCore::float3.
+template<class T, size_t N>
+struct NumericLayout<std::array<T, N>, std::enable_if_t<detail::is_fast_number_v<T>>> {
+  static constexpr size_t components = N;
+  static void assign(const double *numbers, std::array<T, N> &value) {
+    for (size_t idx = 0; idx < N; ++idx)
+      value[idx] = static_cast<T>(numbers[idx]);
+  }
+  static void extract(const std::array<T, N> &value, double *numbers) {
+    for (size_t idx = 0; idx < N; ++idx)
+      numbers[idx] = static_cast<double>(value[idx]);
+  }
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
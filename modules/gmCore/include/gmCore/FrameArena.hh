@@ -0,0 +1,103 @@
+#ifndef GRAMODS_CORE_FRAMEARENA
+#define GRAMODS_CORE_FRAMEARENA
+
+#include <gmCore/config.hh>
+
+#include <memory>
+#include <memory_resource>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Linear memory resource for short-lived data, such as temporary
+   containers used during one frame's update or rendering. Each
+   thread has its own arena, retrieved with FrameArena::get(), from
+   which allocations are made by advancing a pointer within a block
+   of memory, without locking. Deallocation, which may be done from
+   any thread, does not free any memory; instead each block is
+   rewound and reused when all of its allocations have been
+   deallocated, typically at the latest by the end of the frame. New
+   blocks are allocated from the heap only when no block is free, so
+   that steady state operation does not allocate from the heap at
+   all.
+
+   ~~~~~{.cpp}
+   std::pmr::vector<Eigen::Vector3f> points(gmCore::FrameArena::get());
+   ~~~~~
+
+   Updateable::updateAll calls nextFrame at its end, which makes
+   statistics available for the last frame, to verify that hot paths
+   run without heap allocations.
+
+   When a thread exits, the blocks of its arena are freed as soon as
+   their allocations have been deallocated, and the arena is reused
+   by threads started later. Data that must outlive the current frame
+   should not be allocated from the arena, since it would keep its
+   block from being reused.
+*/
+class FrameArena
+  : public std::pmr::memory_resource {
+
+public:
+
+  /**
+     Allocation statistics over one frame.
+  */
+  struct Statistics {
+
+    /**
+       Number of allocations made from the arenas.
+    */
+    size_t allocation_count = 0;
+
+    /**
+       Number of bytes allocated from the arenas.
+    */
+    size_t allocated_bytes = 0;
+
+    /**
+       Number of allocations the arenas made from the heap.
+    */
+    size_t upstream_allocation_count = 0;
+  };
+
+  ~FrameArena();
+
+  /**
+     Returns the frame arena of the calling thread.
+  */
+  static FrameArena * get();
+
+  /**
+     Ends the current frame, collecting statistics over all
+     threads' arenas.
+  */
+  static void nextFrame();
+
+  /**
+     Returns the statistics over all threads' arenas, collected for
+     the last frame.
+  */
+  static Statistics getFrameStatistics();
+
+protected:
+
+  void * do_allocate(size_t bytes, size_t alignment) override;
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override;
+
+private:
+
+  FrameArena();
+
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef GRAMODS_CORE_JOBSYSTEM
+#define GRAMODS_CORE_JOBSYSTEM
+
+#include <gmCore/config.hh>
+#include <gmCore/OFactory.hh>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Shared pool of worker threads for CPU bound work, such as per-pixel
+   loops or detection over multiple images. Work is distributed over
+   per-worker double ended queues: a worker takes its own most recent
+   job first and steals the oldest job of other workers when its own
+   queue is empty. Threads that wait for a group of jobs, for example
+   in TaskGroup::wait or parallelFor, run pending jobs of that group
+   while waiting, so work may be spawned from within jobs without
+   deadlocking. Other jobs are never run by waiting threads, so that
+   for example the render thread is not held up by unrelated long
+   running jobs.
+
+   Modules should use the shared instance, from JobSystem::get(),
+   instead of spawning their own threads for CPU work, to avoid
+   oversubscribing the cores. Keep the returned pointer for as long
+   as the job system is used. An instance created by Configuration
+   becomes the shared instance when initialized, making it possible
+   to set the worker count in the configuration:
+
+   ~~~~~{.xml}
+   <JobSystem workerCount="6" frameBarrier="true" parallelUpdate="true"/>
+   ~~~~~
+
+   Threads dedicated to blocking work, such as network or file I/O,
+   should not use the job system since these would occupy workers
+   without using the CPU.
+*/
+class JobSystem
+  : public Object {
+
+public:
+
+  /**
+     A job is a function without arguments or return value.
+  */
+  typedef std::function<void()> Job;
+
+  JobSystem();
+  virtual ~JobSystem();
+
+  /**
+     Returns the shared job system instance. If no instance is alive
+     then a new one is created and initialized with default settings.
+  */
+  static std::shared_ptr<JobSystem> get();
+
+  /**
+     Starts the worker threads and makes this the shared instance.
+  */
+  void initialize() override;
+
+  /**
+     Sets the number of worker threads. Default is zero, meaning one
+     less than the number of hardware threads, but at least one,
+     since the thread waiting for jobs takes part in the work.
+
+     \gmXmlTag{gmCore,JobSystem,workerCount}
+  */
+  void setWorkerCount(size_t N);
+
+  /**
+     Returns the number of worker threads, excluding waiting threads
+     helping out.
+  */
+  size_t getWorkerCount();
+
+  /**
+     Activates or deactivates the per-frame barrier. When active, jobs
+     added with submitFrameJob are completed before
+     Updateable::updateAll returns, so that jobs spawned by
+     updateables during one frame are finished before rendering of
+     that frame starts. Default is false.
+
+     \gmXmlTag{gmCore,JobSystem,frameBarrier}
+  */
+  void setFrameBarrier(bool on);
+
+  /**
+     Activates or deactivates concurrent calls to updateables with
+     the same priority, using this job system, when initialized. See
+     Updateable::setJobSystem. Default is false.
+
+     \gmXmlTag{gmCore,JobSystem,parallelUpdate}
+  */
+  void setParallelUpdate(bool on);
+
+  /**
+     Adds a job to be executed by any worker. Exceptions thrown by
+     the job are caught and reported as errors. If the job system is
+     not initialized, the job is executed immediately in the calling
+     thread.
+  */
+  void submit(Job job);
+
+  /**
+     Adds a job to be executed by any worker and returns a future for
+     the result. Exceptions thrown by the job are passed on through
+     the future.
+
+     Do not wait for the future from within another job, since that
+     will occupy a worker without helping out. Use TaskGroup for
+     nested work instead.
+  */
+  template<class FUNC>
+  std::future<std::invoke_result_t<FUNC>> async(FUNC &&func) {
+    typedef std::invoke_result_t<FUNC> RESULT;
+    auto task =
+      std::make_shared<std::packaged_task<RESULT()>>(std::forward<FUNC>(func));
+    auto future = task->get_future();
+    submit([task] { (*task)(); });
+    return future;
+  }
+
+  /**
+     Calls the specified function over the range [begin, end) split
+     into chunks, as body(chunk_begin, chunk_end), and returns when
+     all chunks have been processed. The calling thread processes
+     chunks as well. If grain is zero, the chunk size is selected
+     based on the number of workers, otherwise no chunk will be
+     smaller than grain, unless the whole range is. The first
+     exception thrown by the body is rethrown after all chunks are
+     finished.
+  */
+  void parallelFor(size_t begin, size_t end,
+                   const std::function<void(size_t, size_t)> &body,
+                   size_t grain = 0);
+
+  /**
+     Group of jobs that can be waited for together. Jobs may be added
+     from any thread, including from jobs in the group itself.
+
+     ~~~~~{.cpp}
+     gmCore::JobSystem::TaskGroup group(*job_system);
+     for (auto &camera : cameras)
+       group.run([&camera] { camera.detect(); });
+     group.wait();
+     ~~~~~
+  */
+  class TaskGroup {
+
+  public:
+
+    TaskGroup(JobSystem &system);
+
+    /**
+       Waits for all jobs in the group, discarding any exception.
+    */
+    ~TaskGroup();
+
+    /**
+       Adds a job to the group.
+    */
+    void run(Job job);
+
+    /**
+       Runs pending jobs of this group until all jobs in the group
+       are finished and then rethrows the first exception thrown by
+       any of them, if any. Jobs not in this group are left to the
+       workers.
+    */
+    void wait();
+
+  private:
+
+    struct State;
+
+    JobSystem &system;
+    std::shared_ptr<State> state;
+  };
+
+  /**
+     Adds a job to the frame group. When the frame barrier is active
+     (see setFrameBarrier) these jobs are waited for at the end of
+     Updateable::updateAll, otherwise by calling waitFrame.
+  */
+  void submitFrameJob(Job job);
+
+  /**
+     Waits for all jobs added with submitFrameJob. Exceptions thrown
+     by the jobs are reported as errors.
+  */
+  void waitFrame();
+
+  /**
+     Returns the default key, in Configuration, for the
+     Object.
+  */
+  std::string getDefaultKey() override { return "jobSystem"; }
+
+  GM_OFI_DECLARE;
+
+private:
+
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GRAMODS_CORE_MAPPEDFILE
+#define GRAMODS_CORE_MAPPEDFILE
+
+#include <gmCore/config.hh>
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Read-only memory mapping of a whole file, for reading large data
+   sets, such as recorded samples, without first copying them into
+   memory. Pages are loaded by the operating system when first
+   accessed, so opening a file is fast independently of its size.
+
+   ~~~~~{.cpp}
+   gmCore::MappedFile file("samples.bin");
+   const float *values = reinterpret_cast<const float *>(file.data());
+   size_t count = file.size() / sizeof(float);
+   ~~~~~
+
+   The mapping stays valid until the object is destroyed. Changes to
+   the file while it is mapped may or may not be visible through the
+   mapping, depending on the platform.
+*/
+class MappedFile {
+
+public:
+
+  /**
+     Maps the specified file, or throws gmCore::InvalidArgument if it
+     cannot be opened.
+  */
+  explicit MappedFile(std::filesystem::path file);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+     Returns the start of the mapped file. This is a null pointer if
+     the file is empty.
+  */
+  const char * data() const;
+
+  /**
+     Returns the size of the mapped file, in bytes.
+  */
+  size_t size() const;
+
+  /**
+     Returns the mapped file as a view of characters.
+  */
+  std::string_view view() const { return { data(), size() }; }
+
+  /**
+     Returns the path of the mapped file.
+  */
+  const std::filesystem::path & getPath() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef GRAMODS_CORE_MPSCQUEUE
+#define GRAMODS_CORE_MPSCQUEUE
+
+#include <gmCore/config.hh>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Bounded lock-free queue for passing values from any number of
+   producer threads to one single consumer thread, for example
+   messages from network callbacks to the render loop. Producers
+   claim slots with an atomic compare-and-swap and never wait for
+   each other or for the consumer; a push to a full queue and a pop
+   from an empty queue fail immediately.
+
+   The slots are default constructed when the queue is created and
+   values are move assigned into and out of them.
+
+   ~~~~~{.cpp}
+   gmCore::MpscQueue<Message> queue(256);
+
+   // Any producer thread
+   if (!queue.tryPush(std::move(message)))
+     GM_WRN("Receiver", "Message queue full; dropping message");
+
+   // Consumer thread
+   while (auto message = queue.tryPop()) handle(*message);
+   ~~~~~
+*/
+template<class TYPE>
+class MpscQueue {
+
+public:
+
+  /**
+     Creates a queue holding at least the specified number of
+     values. The capacity is rounded up to a power of two.
+  */
+  explicit MpscQueue(size_t capacity)
+    : mask(roundUp(capacity) - 1),
+      cells(new Cell[mask + 1]) {
+    for (size_t idx = 0; idx <= mask; ++idx)
+      cells[idx].sequence.store(idx, std::memory_order_relaxed);
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+     Adds a value to the queue, if there is room. This may be called
+     from any number of threads concurrently.
+
+     @returns True if the value was added, false if the queue is full.
+  */
+  bool tryPush(TYPE value) {
+    size_t tail = tail_idx.value.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = &cells[tail & mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = intptr_t(sequence) - intptr_t(tail);
+      if (diff == 0) {
+        if (tail_idx.value.compare_exchange_weak(tail, tail + 1,
+                                                 std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        // The consumer has not yet emptied this cell
+        return false;
+      } else {
+        tail = tail_idx.value.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+     Moves the oldest value in the queue into the argument, if the
+     queue is not empty. Call only from the consumer thread.
+
+     A value whose producer has claimed its slot but not yet finished
+     writing it blocks later values until it is written, so this may
+     fail even though size is not zero.
+
+     @returns True if a value was popped, false if the queue is empty.
+  */
+  bool tryPop(TYPE &value) {
+    size_t head = head_idx.value.load(std::memory_order_relaxed);
+    Cell &cell = cells[head & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+      return false;
+    value = std::move(cell.value);
+    cell.sequence.store(head + mask + 1, std::memory_order_release);
+    head_idx.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+     Pops the oldest value in the queue, if the queue is not
+     empty. Call only from the consumer thread.
+  */
+  std::optional<TYPE> tryPop() {
+    TYPE value;
+    if (!tryPop(value)) return std::nullopt;
+    return std::optional<TYPE>(std::move(value));
+  }
+
+  /**
+     Returns the approximate number of values in the queue, including
+     values currently being pushed.
+  */
+  size_t size() const {
+    size_t head = head_idx.value.load(std::memory_order_acquire);
+    size_t tail = tail_idx.value.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  /**
+     Returns true if the queue is approximately empty.
+  */
+  bool empty() const { return size() == 0; }
+
+  /**
+     Returns the number of values the queue can hold.
+  */
+  size_t capacity() const { return mask + 1; }
+
+private:
+
+  static size_t roundUp(size_t N) {
+    size_t result = 1;
+    while (result < N) result <<= 1;
+    return result;
+  }
+
+  /**
+     Slot with a sequence number telling whether it is free for the
+     producer of a specific position (sequence == position) or holds
+     a value for the consumer (sequence == position + 1).
+  */
+  struct Cell {
+    std::atomic<size_t> sequence;
+    TYPE value;
+  };
+
+  // Separate cache lines for the consumer and producer side
+  struct alignas(64) Index {
+    std::atomic<size_t> value = 0;
+  };
+
+  const size_t mask;
+  std::unique_ptr<Cell[]> cells;
+
+  Index head_idx;
+  Index tail_idx;
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -4,11 +4,14 @@
 
 #include <gmCore/config.hh>
 #include <gmCore/Object.hh>
+#include <gmCore/FastParser.hh>
+#include <gmCore/ParamSidecar.hh>
 #include <gmCore/Stringify.hh>
 #include <gmCore/InvalidArgument.hh>
 
 #include <map>
 #include <string>
+#include <vector>
 #include <filesystem>
 #include <iomanip>
 #include <typeinfo>
@@ -209,6 +212,13 @@ class OFactory {
    */
   struct ParamSetterBase {
     virtual void setValueFromString(Object *n, std::string s) const = 0;
+
+    /**
+       Sets each value in the specified sidecar, in order. This
+       default implementation passes each line of a text sidecar to
+       setValueFromString.
+    */
+    virtual void setValuesFromSidecar(Object *n, const ParamSidecar &sidecar) const;
   };
 
   /**
@@ -279,6 +289,15 @@ public:
     */
     bool setParamValueFromString(Object *node, std::string name, std::string value) const;
 
+    /**
+       Finds a parameter setter for the specified attribute name and
+       calls it for each value in the specified sidecar file. Returns
+       false if there is no setter associated with the specified
+       attribute name.
+    */
+    bool setParamValuesFromSidecar(Object *node, std::string name,
+                                   const ParamSidecar &sidecar) const;
+
     /**
        Finds a pointer setter for the specified attribute name and
        calls it to set that attribute pointer for the specified object
@@ -331,6 +350,15 @@ public:
     }
   };
 
+  /**
+     Parses the specified string as a value of type T, with the
+     FastParser if available and otherwise the istream operator, or
+     throws gmCore::InvalidArgument. This is used both for inline
+     values and for lines of text sidecars.
+  */
+  template<class T>
+  static T parseValue(const std::string &s);
+
   /**
      General parameter setter, templated to determine the type to set
      value for. Any type, even types unknown to the library, can be
@@ -338,6 +366,14 @@ public:
      header code defining the istream operator before including this
      header, to make sure that the template class is instantiated
      against that type.
+
+     If there is a FastParser specialization available for the type,
+     this is tried first and the istream operator is used only if the
+     FastParser cannot parse the string.
+
+     Types with a NumericLayout, and std::vector of such types, are
+     read from sidecar files without string conversion. A vector
+     parameter is set once, with all values of the sidecar.
   */
   template<class Node, class T>
   struct ParamSetter : ParamSetterBase {
@@ -347,6 +383,8 @@ public:
 
     void setValueFromString(Object *n, std::string s) const;
 
+    void setValuesFromSidecar(Object *n, const ParamSidecar &sidecar) const override;
+
     void (Node::*method)(T val);
   };
 
@@ -439,11 +477,15 @@ private:
 };
 
 
-template<class Node, class T>
-void OFactory::ParamSetter<Node, T>::setValueFromString
-(Object *n, std::string s) const {
-  assert(dynamic_cast<Node*>(n) != nullptr);
-  Node *node = static_cast<Node*>(n);
+template<class T>
+T OFactory::parseValue(const std::string &s) {
+
+  if constexpr (FastParser<T>::available) {
+    T val;
+    if (FastParser<T>::parse(s, val))
+      return val;
+  }
+
   std::stringstream ss(s);
   T val;
   ss >> std::setbase(0) >> val;
@@ -451,7 +493,77 @@ void OFactory::ParamSetter<Node, T>::setValueFromString
   if (!ss)
     throw gmCore::InvalidArgument(GM_STR("cannot parse '" << s << "' as type " << typeid(T).name()));
 
-  (node->*method)(val);
+  return val;
+}
+
+/**
+   Parses named states, such as "on" and "true", as bool.
+*/
+template<>
+inline bool OFactory::parseValue<bool>(const std::string &s) {
+
+  if (s == "true" ||
+      s == "True" ||
+      s == "TRUE" ||
+      s == "on" ||
+      s == "On" ||
+      s == "ON" ||
+      s == "1")
+    return true;
+
+  if (s == "false" ||
+      s == "False" ||
+      s == "FALSE" ||
+      s == "off" ||
+      s == "Off" ||
+      s == "OFF" ||
+      s == "0")
+    return false;
+
+  std::stringstream ss;
+  ss << "Cannot convert " << s << " to boolean";
+  throw gmCore::InvalidArgument(ss.str());
+}
+
+template<class Node, class T>
+void OFactory::ParamSetter<Node, T>::setValueFromString
+(Object *n, std::string s) const {
+  assert(dynamic_cast<Node*>(n) != nullptr);
+  Node *node = static_cast<Node*>(n);
+  (node->*method)(parseValue<T>(s));
+}
+
+template<class Node, class T>
+void OFactory::ParamSetter<Node, T>::setValuesFromSidecar
+(Object *n, const ParamSidecar &sidecar) const {
+  assert(dynamic_cast<Node*>(n) != nullptr);
+  Node *node = static_cast<Node*>(n);
+
+  if constexpr (NumericLayout<T>::components > 0) {
+
+    sidecar.forEachValue<T>([&](const T &value) { (node->*method)(value); },
+                            [](std::string_view line, T &value) {
+                              value = parseValue<T>(std::string(line));
+                            });
+
+  } else if constexpr (requires { typename T::value_type; }) {
+
+    typedef typename T::value_type E;
+    if constexpr (std::is_same_v<T, std::vector<E>> &&
+                  NumericLayout<E>::components > 0) {
+      T values;
+      sidecar.forEachValue<E>([&](const E &value) { values.push_back(value); },
+                              [](std::string_view line, E &value) {
+                                value = parseValue<E>(std::string(line));
+                              });
+      (node->*method)(values);
+    } else {
+      ParamSetterBase::setValuesFromSidecar(n, sidecar);
+    }
+
+  } else {
+    ParamSetterBase::setValuesFromSidecar(n, sidecar);
+  }
 }
 
 template<class Node>
@@ -477,28 +589,7 @@ void OFactory::ParamSetter<Node, bool>::setValueFromString
 (Object *n, std::string s) const {
   assert(dynamic_cast<Node*>(n) != nullptr);
   Node *node = static_cast<Node*>(n);
-
-  if (s == "true" ||
-      s == "True" ||
-      s == "TRUE" ||
-      s == "on" ||
-      s == "On" ||
-      s == "ON" ||
-      s == "1") {
-    (node->*method)(true);
-  } else if (s == "false" ||
-             s == "False" ||
-             s == "FALSE" ||
-             s == "off" ||
-             s == "Off" ||
-             s == "OFF" ||
-             s == "0") {
-    (node->*method)(false);
-  } else {
-    std::stringstream ss;
-    ss << "Cannot convert " << s << " to boolean";
-    throw gmCore::InvalidArgument(ss.str());
-  }
+  (node->*method)(parseValue<bool>(s));
 }
 
 template<class Node, class T>
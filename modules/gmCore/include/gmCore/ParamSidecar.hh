@@ -0,0 +1,223 @@
+#ifndef GRAMODS_CORE_PARAMSIDECAR
+#define GRAMODS_CORE_PARAMSIDECAR
+
+#include <gmCore/config.hh>
+#include <gmCore/FastParser.hh>
+#include <gmCore/MappedFile.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/Stringify.hh>
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Memory mapped file holding a long list of values for one
+   parameter, e.g. recorded tracker samples or a camera path, to be
+   used instead of one XML param entry per value. The file is either
+   text, with one value per line, or binary, with the numeric
+   components of each value (see gmCore::NumericLayout) stored as
+   native float32 or float64, one value after the other.
+
+   In text files, empty lines and lines starting with # are
+   skipped. Values of numeric types may have their components
+   separated by white space, comma or semicolon, which makes CSV
+   files usable directly. Any other line is parsed just as the value
+   of an XML attribute, so that e.g. named values accepted inline are
+   accepted in the sidecar as well.
+
+   In XML, a sidecar is referenced with the attribute `file` instead
+   of `value`, optionally with `format` (text, float32 or float64):
+
+   ~~~~~{.xml}
+   <PoseTimeSampleTracker>
+     <param name="key" value="head"/>
+     <param name="value" file="head_poses.bin" format="float32"/>
+     <param name="time" file="head_times.csv"/>
+   </PoseTimeSampleTracker>
+   ~~~~~
+*/
+class ParamSidecar {
+
+public:
+
+  /**
+     The encoding of the sidecar file.
+  */
+  enum struct Format {
+    Text,    //< One value per line
+    Float32, //< Binary native 32 bit floats
+    Float64  //< Binary native 64 bit floats
+  };
+
+  /**
+     Maps the specified file, or throws gmCore::InvalidArgument if it
+     cannot be opened.
+  */
+  ParamSidecar(std::filesystem::path file, Format format);
+
+  /**
+     Returns the format with the specified name (text, csv, float32 or
+     float64), or throws gmCore::InvalidArgument. An empty name
+     selects text for files with extension .csv or .txt, float64 for
+     .f64 and otherwise float32.
+  */
+  static Format parseFormat(std::string name,
+                            const std::filesystem::path &file);
+
+  /**
+     Returns the format of the sidecar file.
+  */
+  Format getFormat() const { return format; }
+
+  /**
+     Returns the path to the sidecar file.
+  */
+  const std::filesystem::path & getPath() const { return file->getPath(); }
+
+  /**
+     Calls the specified function with each line of a text sidecar,
+     as a std::string_view, skipping empty lines and comments. Throws
+     gmCore::InvalidArgument if the sidecar is not text.
+  */
+  template<class FUNC>
+  void forEachLine(FUNC func) const;
+
+  /**
+     Calls the specified function with each value of type T in the
+     sidecar, constructing the values directly from their numeric
+     components. Lines of a text sidecar that are not plain numbers
+     are passed to the specified parser, as parse(line, value), which
+     should parse them as inline parameter values or throw
+     gmCore::InvalidArgument. Throws gmCore::InvalidArgument if the
+     data cannot be read as values of type T.
+
+     @returns The number of values read.
+  */
+  template<class T, class FUNC, class PARSE>
+  size_t forEachValue(FUNC func, PARSE parse) const;
+
+private:
+
+  template<class T, class SCALAR, class FUNC>
+  size_t forEachBinaryValue(FUNC func) const;
+
+  std::shared_ptr<MappedFile> file;
+  Format format;
+};
+
+template<class FUNC>
+void ParamSidecar::forEachLine(FUNC func) const {
+
+  if (format != Format::Text)
+    throw InvalidArgument(GM_STR("Cannot read lines from binary sidecar "
+                                 << getPath()));
+
+  std::string_view data = file->view();
+
+  size_t pos = 0;
+  while (pos < data.size()) {
+
+    size_t end = data.find('\n', pos);
+    if (end == std::string_view::npos) end = data.size();
+
+    std::string_view line = data.substr(pos, end - pos);
+    pos = end + 1;
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    size_t first = 0;
+    while (first < line.size() && detail::is_space(line[first])) ++first;
+    if (first == line.size() || line[first] == '#') continue;
+
+    func(line);
+  }
+}
+
+template<class T, class FUNC, class PARSE>
+size_t ParamSidecar::forEachValue(FUNC func, PARSE parse) const {
+
+  constexpr size_t N = NumericLayout<T>::components;
+  static_assert(N > 0, "Sidecar values require a NumericLayout");
+
+  if (format == Format::Float32) return forEachBinaryValue<T, float>(func);
+  if (format == Format::Float64) return forEachBinaryValue<T, double>(func);
+
+  size_t count = 0;
+  double numbers[N];
+  T value;
+
+  forEachLine([&](std::string_view line) {
+
+    const char *ptr = line.data();
+    const char *last = line.data() + line.size();
+
+    size_t idx = 0;
+    for (; idx < N; ++idx) {
+      while (ptr != last && (detail::is_space(*ptr) || *ptr == ',' || *ptr == ';'))
+        ++ptr;
+      // Leave base prefixed numbers to the parser, since the
+      // components may be integers
+      const char *digits = ptr != last && (*ptr == '-' || *ptr == '+') ? ptr + 1 : ptr;
+      if (digits != last && *digits == '0' && digits + 1 != last &&
+          (detail::is_digit(digits[1]) || digits[1] == 'x' || digits[1] == 'X'))
+        break;
+      if (!detail::parse_number(ptr, last, numbers[idx])) break;
+    }
+
+    while (ptr != last && (detail::is_space(*ptr) || *ptr == ',' || *ptr == ';'))
+      ++ptr;
+
+    if (idx == N && ptr == last) {
+      NumericLayout<T>::assign(numbers, value);
+    } else {
+      try {
+        parse(line, value);
+      } catch (const InvalidArgument &e) {
+        throw InvalidArgument(GM_STR(e.what << " (in " << getPath() << ")"));
+      }
+    }
+
+    func(value);
+    ++count;
+  });
+
+  return count;
+}
+
+template<class T, class SCALAR, class FUNC>
+size_t ParamSidecar::forEachBinaryValue(FUNC func) const {
+
+  constexpr size_t N = NumericLayout<T>::components;
+  constexpr size_t stride = N * sizeof(SCALAR);
+
+  if (file->size() % stride != 0)
+    throw InvalidArgument(GM_STR("Size of sidecar " << getPath() << " ("
+                                 << file->size() << " bytes) is not a multiple of "
+                                 << N << " " << sizeof(SCALAR) << " byte numbers"));
+
+  size_t count = file->size() / stride;
+  const char *data = file->data();
+
+  SCALAR scalars[N];
+  double numbers[N];
+  T value;
+
+  for (size_t idx = 0; idx < count; ++idx) {
+    // The mapping gives no alignment guarantee for the values
+    std::memcpy(scalars, data + idx * stride, stride);
+    for (size_t jdx = 0; jdx < N; ++jdx) numbers[jdx] = scalars[jdx];
+    NumericLayout<T>::assign(numbers, value);
+    func(value);
+  }
+
+  return count;
+}
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -10,9 +10,12 @@
 #include <nlohmann/json_fwd.hpp>
 #endif
 
+#include <gmCore/FastParser.hh>
+
 #include <Eigen/Eigen>
 
 #include <iostream>
+#include <vector>
 
 BEGIN_NAMESPACE_GMCORE;
 
@@ -63,5 +66,50 @@ std::ostream &operator<<(std::ostream &out, const gmCore::Pose &pose);
 
 END_NAMESPACE_GRAMODS;
 
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   FastParser for gmCore::Pose, as position and optional orientation
+   separated by a semicolon.
+
+   \sa operator>>(std::istream &, gmCore::Pose &)
+*/
+template<> struct FastParser<Pose> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Pose &p);
+};
+
+/**
+   FastParser for lists of gmCore::Pose, separated by comma. The list
+   is parsed in bulk, in place, without copying the separate poses
+   into temporary strings.
+
+   \sa operator>>(std::istream &, std::vector<gmCore::Pose> &)
+*/
+template<> struct FastParser<std::vector<Pose>> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, std::vector<Pose> &p);
+};
+
+/**
+   NumericLayout for gmCore::Pose, as position followed by orientation
+   quaternion (x y z qw qx qy qz).
+*/
+template<> struct NumericLayout<Pose> {
+  static constexpr size_t components = 7;
+  static void assign(const double *n, Pose &p) {
+    p.position = Eigen::Vector3f(float(n[0]), float(n[1]), float(n[2]));
+    p.orientation =
+        Eigen::Quaternionf(float(n[3]), float(n[4]), float(n[5]), float(n[6]));
+  }
+  static void extract(const Pose &p, double *n) {
+    n[0] = p.position.x(); n[1] = p.position.y(); n[2] = p.position.z();
+    n[3] = p.orientation.w(); n[4] = p.orientation.x();
+    n[5] = p.orientation.y(); n[6] = p.orientation.z();
+  }
+};
+
+END_NAMESPACE_GMCORE;
+
 #endif
 #endif
@@ -0,0 +1,175 @@
+#ifndef GRAMODS_CORE_POSEARRAY
+#define GRAMODS_CORE_POSEARRAY
+
+#include <gmCore/config.hh>
+
+#ifdef gramods_ENABLE_Eigen3
+
+#include <gmCore/Pose.hh>
+
+#include <Eigen/Eigen>
+
+#include <vector>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Structure of arrays holding many poses, with kernels applying the
+   same operation to all of them, for example the registration of all
+   rigid bodies of a tracker or the offline processing of recorded
+   samples. Each component is stored in its own contiguous array so
+   that the kernels process several poses per SIMD instruction.
+
+   The component arrays must always have the same size; use the
+   methods of this type to change the number of poses. The kernels
+   expect unit quaternions and allow the output to be the same array
+   as an input.
+
+   ~~~~~{.cpp}
+   gmCore::PoseArray poses;
+   for (auto &sample : samples) poses.push_back(sample.pose);
+   gmCore::PoseArray::compose(poses, offset, poses);
+   ~~~~~
+*/
+struct PoseArray {
+
+  std::vector<float> px; ///< Position x components
+  std::vector<float> py; ///< Position y components
+  std::vector<float> pz; ///< Position z components
+  std::vector<float> qw; ///< Orientation w components
+  std::vector<float> qx; ///< Orientation x components
+  std::vector<float> qy; ///< Orientation y components
+  std::vector<float> qz; ///< Orientation z components
+
+  PoseArray() {}
+
+  /**
+     Creates an array of the specified number of identity poses.
+  */
+  explicit PoseArray(size_t N) { resize(N); }
+
+  /**
+     Creates an array from the specified poses.
+  */
+  explicit PoseArray(const std::vector<Pose> &poses);
+
+  /**
+     Returns the number of poses.
+  */
+  size_t size() const { return px.size(); }
+
+  /**
+     Returns true if there are no poses.
+  */
+  bool empty() const { return px.empty(); }
+
+  /**
+     Changes the number of poses. New poses are identity.
+  */
+  void resize(size_t N);
+
+  /**
+     Reserves memory for the specified number of poses.
+  */
+  void reserve(size_t N);
+
+  /**
+     Removes all poses, keeping the allocated memory.
+  */
+  void clear() { resize(0); }
+
+  /**
+     Adds a pose at the end of the array.
+  */
+  void push_back(const Pose &pose);
+
+  /**
+     Returns the pose at the specified index.
+  */
+  Pose get(size_t idx) const;
+
+  /**
+     Sets the pose at the specified index.
+  */
+  void set(size_t idx, const Pose &pose);
+
+  /**
+     Returns all poses as a vector of Pose.
+  */
+  std::vector<Pose> toPoses() const;
+
+  /**
+     Sets out[i] = a * b[i], i.e. b expressed in the space of a.
+  */
+  static void compose(const Pose &a, const PoseArray &b, PoseArray &out);
+
+  /**
+     Sets out[i] = a[i] * b, e.g. to add an offset local to each pose.
+  */
+  static void compose(const PoseArray &a, const Pose &b, PoseArray &out);
+
+  /**
+     Sets out[i] = a[i] * b[i]. The arrays must be of equal size.
+  */
+  static void compose(const PoseArray &a, const PoseArray &b, PoseArray &out);
+
+  /**
+     Sets out[i] = A * b[i] * c, with the matrix A, which may include
+     scaling, applied to the positions and its specified rotation
+     part applied to the orientations, as in a registration.
+  */
+  static void compose(const Eigen::Affine3f &A,
+                      const Eigen::Quaternionf &A_rotation,
+                      const PoseArray &b,
+                      const Pose &c,
+                      PoseArray &out);
+
+  /**
+     Sets out[i] to the inverse of a[i].
+  */
+  static void inverse(const PoseArray &a, PoseArray &out);
+
+  /**
+     Sets the columns of out to each pose applied to the same point,
+     e.g. the tip of a tracked tool.
+  */
+  static void transformPoint(const PoseArray &a,
+                             const Eigen::Vector3f &point,
+                             Eigen::Matrix3Xf &out);
+
+  /**
+     Sets column i of out to pose a[i] applied to column i of
+     points. The number of points must equal the number of poses.
+  */
+  static void transformPoints(const PoseArray &a,
+                              const Eigen::Matrix3Xf &points,
+                              Eigen::Matrix3Xf &out);
+
+  /**
+     Sets out[i] to the linear interpolation between a[i] and b[i],
+     with normalized linear interpolation of the orientations. The
+     arrays must be of equal size.
+  */
+  static void lerp(const PoseArray &a, const PoseArray &b, float t,
+                   PoseArray &out);
+
+  /**
+     Sets out[i] to the interpolation between a[i] and b[i], with
+     linear interpolation of positions and spherical linear
+     interpolation, along the shortest path, of orientations. The
+     arrays must be of equal size.
+  */
+  static void slerp(const PoseArray &a, const PoseArray &b, float t,
+                    PoseArray &out);
+
+  /**
+     Writes the poses as 4x4 matrices, as from Pose::asMatrix, to the
+     specified vector.
+  */
+  static void toMatrices(const PoseArray &a, std::vector<Eigen::Matrix4f> &out);
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
+#endif
@@ -0,0 +1,168 @@
+#ifndef GRAMODS_CORE_PROFILER
+#define GRAMODS_CORE_PROFILER
+
+#include <gmCore/config.hh>
+#include <gmCore/OFactory.hh>
+#include <gmCore/export.hh>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+#include <typeinfo>
+
+/**\def GM_PROFILE_SCOPE(NAME)
+   Macro for measuring the wall time of the current scope, if a
+   Profiler is active. The name must be a string literal, or otherwise
+   have static storage duration, or a std::type_info.
+
+   @param NAME The name of the zone to measure.
+*/
+#define GM_PROFILE_SCOPE(NAME)                                          \
+  gramods::gmCore::Profiler::Scope                                      \
+  GM_PROFILE_CONCAT(_gramods_profile_scope_, __LINE__)(NAME)
+
+#define GM_PROFILE_CONCAT_(A, B) A##B
+#define GM_PROFILE_CONCAT(A, B) GM_PROFILE_CONCAT_(A, B)
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Low overhead profiler of named zones, typically instrumented using
+   the GM_PROFILE_SCOPE macro. Each thread records its zones into its
+   own ring buffer without locking, so that instrumentation may be
+   placed also in code running concurrently, such as job system
+   workers and network callbacks. When no profiler is active the
+   instrumentation costs only one relaxed atomic load.
+
+   The recorded zones can be written in the Chrome trace event format,
+   for viewing in chrome://tracing or Perfetto, and summarized per
+   zone name over a number of frames:
+
+   ~~~~~{.xml}
+   <Profiler traceFile="trace.json" summaryInterval="300"/>
+   ~~~~~
+
+   Only one profiler should be active at a time.
+*/
+class Profiler
+  : public Object {
+
+public:
+
+  Profiler();
+  virtual ~Profiler();
+
+  /**
+     Activates the profiling.
+  */
+  void initialize() override;
+
+  /**
+     Sets a file to write the recorded zones to, in Chrome trace
+     event format, when the profiler is destroyed. Default is to not
+     write any file.
+
+     \gmXmlTag{gmCore,Profiler,traceFile}
+  */
+  void setTraceFile(std::filesystem::path file);
+
+  /**
+     Sets the number of frames, i.e. calls to Updateable::updateAll,
+     between summaries of the zones, written to the console as
+     information. Default is zero, meaning no summary.
+
+     \gmXmlTag{gmCore,Profiler,summaryInterval}
+  */
+  void setSummaryInterval(size_t frames);
+
+  /**
+     Sets the number of zones that each thread can hold before
+     overwriting the oldest. This has effect only on threads that
+     start recording after the change. The zones of threads that have
+     exited are kept up to this number in total. Default is 65536.
+
+     \gmXmlTag{gmCore,Profiler,bufferSize}
+  */
+  void setBufferSize(size_t N);
+
+  /**
+     Writes all currently held zones to the specified stream, in the
+     Chrome trace event format.
+  */
+  void writeTrace(std::ostream &out);
+
+  /**
+     Writes all currently held zones to the specified file, in the
+     Chrome trace event format.
+  */
+  void writeTrace(std::filesystem::path file);
+
+  /**
+     Writes a summary of the zones recorded since the last summary to
+     the console, with count, total and max time per zone name.
+  */
+  void writeSummary();
+
+  /**
+     Returns true if a profiler is currently active.
+  */
+  static bool isActive() {
+    return active_flag.load(std::memory_order_relaxed);
+  }
+
+  /**
+     Records a zone, if a profiler is active. Use the GM_PROFILE_SCOPE
+     macro instead of this class directly.
+  */
+  class Scope {
+
+  public:
+
+    Scope(const char *name)
+      : name(name), type(nullptr), active(isActive()) {
+      if (active) start = std::chrono::steady_clock::now();
+    }
+
+    Scope(const std::type_info &type)
+      : name(nullptr), type(&type), active(isActive()) {
+      if (active) start = std::chrono::steady_clock::now();
+    }
+
+    ~Scope() {
+      if (active) record(name, type, start, std::chrono::steady_clock::now());
+    }
+
+  private:
+
+    const char *name;
+    const std::type_info *type;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /**
+     Returns the default key, in Configuration, for the
+     Object.
+  */
+  std::string getDefaultKey() override { return "profiler"; }
+
+  GM_OFI_DECLARE;
+
+private:
+
+  static void record(const char *name,
+                     const std::type_info *type,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end);
+
+  static gmCore_API std::atomic<bool> active_flag;
+
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef GRAMODS_CORE_SPSCQUEUE
+#define GRAMODS_CORE_SPSCQUEUE
+
+#include <gmCore/config.hh>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Bounded lock-free queue for passing values from exactly one
+   producer thread to exactly one consumer thread, for example frames
+   from a capture thread to the render loop. Neither side ever blocks
+   or allocates; a push to a full queue and a pop from an empty queue
+   fail immediately, leaving it to the caller to decide whether to
+   drop, retry or wait.
+
+   The slots are default constructed when the queue is created and
+   values are move assigned into and out of them, so large values,
+   such as images, keep their allocations between uses.
+
+   ~~~~~{.cpp}
+   gmCore::SpscQueue<cv::Mat> queue(4);
+
+   // Producer thread
+   if (!queue.tryPush(std::move(frame))) ++dropped_frames;
+
+   // Consumer thread
+   while (auto frame = queue.tryPop()) process(*frame);
+   ~~~~~
+*/
+template<class TYPE>
+class SpscQueue {
+
+public:
+
+  /**
+     Creates a queue holding at least the specified number of
+     values. The capacity is rounded up to a power of two.
+  */
+  explicit SpscQueue(size_t capacity)
+    : mask(roundUp(capacity) - 1),
+      slots(new TYPE[mask + 1]) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+     Adds a value to the queue, if there is room. Call only from the
+     producer thread.
+
+     @returns True if the value was added, false if the queue is full.
+  */
+  bool tryPush(TYPE value) {
+    size_t tail = tail_idx.value.load(std::memory_order_relaxed);
+    if (tail - cached_head > mask) {
+      cached_head = head_idx.value.load(std::memory_order_acquire);
+      if (tail - cached_head > mask) return false;
+    }
+    slots[tail & mask] = std::move(value);
+    tail_idx.value.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+     Moves the oldest value in the queue into the argument, if the
+     queue is not empty. Call only from the consumer thread.
+
+     @returns True if a value was popped, false if the queue is empty.
+  */
+  bool tryPop(TYPE &value) {
+    size_t head = head_idx.value.load(std::memory_order_relaxed);
+    if (head == cached_tail) {
+      cached_tail = tail_idx.value.load(std::memory_order_acquire);
+      if (head == cached_tail) return false;
+    }
+    value = std::move(slots[head & mask]);
+    head_idx.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+     Pops the oldest value in the queue, if the queue is not
+     empty. Call only from the consumer thread.
+  */
+  std::optional<TYPE> tryPop() {
+    TYPE value;
+    if (!tryPop(value)) return std::nullopt;
+    return std::optional<TYPE>(std::move(value));
+  }
+
+  /**
+     Returns the number of values in the queue. This is exact only
+     when called from the producer or consumer thread while the other
+     is not using the queue.
+  */
+  size_t size() const {
+    size_t head = head_idx.value.load(std::memory_order_acquire);
+    size_t tail = tail_idx.value.load(std::memory_order_acquire);
+    return tail - head;
+  }
+
+  /**
+     Returns true if the queue is empty, with the same reservation as
+     for size.
+  */
+  bool empty() const { return size() == 0; }
+
+  /**
+     Returns the number of values the queue can hold.
+  */
+  size_t capacity() const { return mask + 1; }
+
+private:
+
+  static size_t roundUp(size_t N) {
+    size_t result = 1;
+    while (result < N) result <<= 1;
+    return result;
+  }
+
+  // Separate cache lines for the consumer and producer side
+  struct alignas(64) Index {
+    std::atomic<size_t> value = 0;
+  };
+
+  const size_t mask;
+  std::unique_ptr<TYPE[]> slots;
+
+  Index head_idx;
+  size_t cached_tail = 0; //< Consumer's view of the tail
+
+  Index tail_idx;
+  size_t cached_head = 0; //< Producer's view of the head
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef GRAMODS_CORE_TRIPLEBUFFER
+#define GRAMODS_CORE_TRIPLEBUFFER
+
+#include <gmCore/config.hh>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+BEGIN_NAMESPACE_GMCORE;
+
+/**
+   Wait-free handoff of the latest value from one writer thread to one
+   reader thread, for example tracker samples from a polling thread to
+   the render loop. The writer and the reader each own one of three
+   buffers and swap theirs with the shared middle buffer in one atomic
+   operation, so neither side ever waits for the other. Values that
+   the reader does not pick up in time are overwritten by newer
+   values, which is what is typically wanted for state such as poses.
+
+   ~~~~~{.cpp}
+   gmCore::TripleBuffer<PoseSample> buffer;
+
+   // Writer thread
+   buffer.getWriteBuffer() = sample;
+   buffer.publish();
+
+   // Reader thread
+   if (buffer.update()) use(buffer.getReadBuffer());
+   ~~~~~
+
+   Since buffers are recycled, a writer that fills in only parts of
+   the write buffer will find the data from two publications earlier
+   in the remaining parts.
+*/
+template<class TYPE>
+class TripleBuffer {
+
+public:
+
+  TripleBuffer() = default;
+
+  /**
+     Creates a triple buffer with all three buffers initialized to
+     the specified value.
+  */
+  explicit TripleBuffer(const TYPE &value)
+    : buffers{ { value }, { value }, { value } } {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /**
+     Returns the buffer owned by the writer, to fill in before
+     calling publish. Call only from the writer thread.
+  */
+  TYPE & getWriteBuffer() { return buffers[back].value; }
+
+  /**
+     Makes the write buffer available to the reader, replacing any
+     value that the reader has not yet picked up, and gives the
+     writer a new buffer. Call only from the writer thread.
+
+     @returns True if a value that the reader had not picked up was
+     replaced, i.e. dropped.
+  */
+  bool publish() {
+    uint8_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = previous & INDEX;
+    return previous & FRESH;
+  }
+
+  /**
+     Assigns the write buffer and publishes it. Call only from the
+     writer thread.
+
+     @returns True if a value that the reader had not picked up was
+     replaced.
+  */
+  bool write(TYPE value) {
+    getWriteBuffer() = std::move(value);
+    return publish();
+  }
+
+  /**
+     Picks up the latest published value, if there is one that has
+     not already been picked up. Call only from the reader thread.
+
+     @returns True if the read buffer was updated.
+  */
+  bool update() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+
+  /**
+     Returns the buffer owned by the reader, holding the value picked
+     up by the last call to update. Call only from the reader thread.
+  */
+  const TYPE & getReadBuffer() const { return buffers[front].value; }
+
+  /**
+     Copies the latest published value into the argument, if there is
+     one that has not already been read. Call only from the reader
+     thread.
+
+     @returns True if a new value was read.
+  */
+  bool read(TYPE &value) {
+    if (!update()) return false;
+    value = getReadBuffer();
+    return true;
+  }
+
+private:
+
+  static constexpr uint8_t INDEX = 0x3;
+  static constexpr uint8_t FRESH = 0x4;
+
+  // Separate cache lines to avoid false sharing between the threads
+  struct alignas(64) Buffer {
+    TYPE value;
+  };
+
+  Buffer buffers[3];
+
+  alignas(64) std::atomic<uint8_t> middle = 1;
+  alignas(64) uint8_t back = 0;  //< Owned by the writer
+  alignas(64) uint8_t front = 2; //< Owned by the reader
+};
+
+END_NAMESPACE_GMCORE;
+
+#endif
@@ -10,10 +10,22 @@
 
 BEGIN_NAMESPACE_GMCORE;
 
+class JobSystem;
+
 /**
    The Updateable class defines an interface for objects that may be
    updated, for example each execution frame. This may be an animator
    or a network connection.
+
+   Updateables are called in tiers of the same priority, highest
+   priority first. If a JobSystem is set (see setJobSystem) then the
+   updateables within a tier are called concurrently on the job
+   system workers, and updateAll continues with the next tier when
+   all updateables in the current tier are done. Use runsAfter to
+   declare that one updateable must be called after another within
+   the same tier. An updateable destroyed during updateAll, for
+   example by another updateable, is not called after its
+   destruction.
 */
 class Updateable {
 
@@ -38,6 +50,37 @@ public:
   static void updateAll(clock::time_point t = clock::now(),
                         std::optional<size_t> frame = std::nullopt);
 
+  /**
+     Sets the job system to use for calling updateables with the same
+     priority concurrently. Set to nullptr, which is the default, to
+     call all updateables in turn in the thread calling updateAll.
+     Only a weak reference is kept to the job system.
+
+     Updateables must be safe to update concurrently with other
+     updateables of the same priority before this is activated.
+  */
+  static void setJobSystem(std::shared_ptr<JobSystem> job_system);
+
+  /**
+     Declares that this updateable must be called after the specified
+     updateable, which must have the same priority. Dependencies on
+     updateables with higher priority are always fulfilled, while
+     dependencies on updateables with lower priority cannot be
+     fulfilled and are ignored with a warning.
+  */
+  void runsAfter(Updateable *other);
+
+  /**
+     Returns the wall time spent in the last call to update by
+     updateAll.
+  */
+  clock::duration getUpdateDuration();
+
+  /**
+     Returns the wall time spent in the last call to updateAll.
+  */
+  static clock::duration getUpdateAllDuration();
+
   /**
      Called by updateAll to make the object up-to-date.
   */
@@ -6,6 +6,8 @@
 
 #ifdef gramods_ENABLE_Eigen3
 
+#include <gmCore/FastParser.hh>
+
 #include <Eigen/Eigen>
 
 #include <iostream>
@@ -71,5 +73,104 @@ std::istream& operator>> (std::istream &in, Eigen::Matrix4f &m);
 
 END_NAMESPACE_GRAMODS;
 
+BEGIN_NAMESPACE_GMCORE;
+
+/// FastParser for Eigen::Vector2f, reading two values (x y).
+template<> struct FastParser<Eigen::Vector2f> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Eigen::Vector2f &v);
+};
+
+/// FastParser for Eigen::Vector3f, reading three values (x y z).
+template<> struct FastParser<Eigen::Vector3f> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Eigen::Vector3f &v);
+};
+
+/**
+   FastParser for Eigen::Quaternionf. This handles four values (w x y
+   z), with or without the keyword "quaternion", while other keywords
+   are left to the istream operator.
+
+   \sa operator>>(std::istream &, Eigen::Quaternionf &)
+*/
+template<> struct FastParser<Eigen::Quaternionf> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Eigen::Quaternionf &q);
+};
+
+/// FastParser for Eigen::Matrix3f, reading nine values.
+template<> struct FastParser<Eigen::Matrix3f> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Eigen::Matrix3f &m);
+};
+
+/// FastParser for Eigen::Matrix4f, reading 9, 12 or 16 values.
+template<> struct FastParser<Eigen::Matrix4f> {
+  static constexpr bool available = true;
+  static bool parse(std::string_view str, Eigen::Matrix4f &m);
+};
+
+/// NumericLayout for Eigen::Vector2f (x y).
+template<> struct NumericLayout<Eigen::Vector2f> {
+  static constexpr size_t components = 2;
+  static void assign(const double *n, Eigen::Vector2f &v) {
+    v = Eigen::Vector2f(float(n[0]), float(n[1]));
+  }
+  static void extract(const Eigen::Vector2f &v, double *n) {
+    Eigen::Map<Eigen::Vector2d> out(n);
+    out = v.cast<double>();
+  }
+};
+
+/// NumericLayout for Eigen::Vector3f (x y z).
+template<> struct NumericLayout<Eigen::Vector3f> {
+  static constexpr size_t components = 3;
+  static void assign(const double *n, Eigen::Vector3f &v) {
+    v = Eigen::Vector3f(float(n[0]), float(n[1]), float(n[2]));
+  }
+  static void extract(const Eigen::Vector3f &v, double *n) {
+    Eigen::Map<Eigen::Vector3d> out(n);
+    out = v.cast<double>();
+  }
+};
+
+/// NumericLayout for Eigen::Quaternionf (w x y z).
+template<> struct NumericLayout<Eigen::Quaternionf> {
+  static constexpr size_t components = 4;
+  static void assign(const double *n, Eigen::Quaternionf &q) {
+    q = Eigen::Quaternionf(float(n[0]), float(n[1]), float(n[2]), float(n[3]));
+  }
+  static void extract(const Eigen::Quaternionf &q, double *n) {
+    n[0] = q.w(); n[1] = q.x(); n[2] = q.y(); n[3] = q.z();
+  }
+};
+
+/// NumericLayout for Eigen::Matrix3f, in row-major order.
+template<> struct NumericLayout<Eigen::Matrix3f> {
+  static constexpr size_t components = 9;
+  static void assign(const double *n, Eigen::Matrix3f &m) {
+    m = Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>(n).cast<float>();
+  }
+  static void extract(const Eigen::Matrix3f &m, double *n) {
+    Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> out(n);
+    out = m.cast<double>();
+  }
+};
+
+/// NumericLayout for Eigen::Matrix4f, in row-major order.
+template<> struct NumericLayout<Eigen::Matrix4f> {
+  static constexpr size_t components = 16;
+  static void assign(const double *n, Eigen::Matrix4f &m) {
+    m = Eigen::Map<const Eigen::Matrix<double, 4, 4, Eigen::RowMajor>>(n).cast<float>();
+  }
+  static void extract(const Eigen::Matrix4f &m, double *n) {
+    Eigen::Map<Eigen::Matrix<double, 4, 4, Eigen::RowMajor>> out(n);
+    out = m.cast<double>();
+  }
+};
+
+END_NAMESPACE_GMCORE;
+
 #endif
 #endif
@@ -226,19 +226,25 @@ void Configuration::load(tinyxml2::XMLNode *node,
 
       GM_DBG2("Configuration", "Processing parameter " << param_name);
 
-      std::vector<std::string> values;
-      node_conf.getAllParams(param_name, values);
-
       if (node_overrides.find(param_name) == node_overrides.end()) {
 
-        for (std::string value : values) {
+        for (auto &param : node_conf.parameters) {
+
+          if (param.first != param_name) continue;
+          param.second.checked = true;
+
+          const std::string &value = param.second.value;
 
           GM_DBG2("Configuration", KEY << " -> " <<
-                  type << "::" << param_name << " = " << value);
+                  type << "::" << param_name << " = " << value
+                  << (param.second.sidecar ? " (sidecar)" : ""));
 
           try {
-            bool good = OFactory::getOFI(type)->
-              setParamValueFromString(nn.get(), param_name, value);
+            bool good = param.second.sidecar
+              ? OFactory::getOFI(type)->setParamValuesFromSidecar(
+                  nn.get(), param_name, *param.second.sidecar)
+              : OFactory::getOFI(type)->setParamValueFromString(
+                  nn.get(), param_name, value);
             if (!good) {
               GM_WRN("Configuration", "no parameter " << param_name << " available in " << type);
               if (error_list) error_list->push_back(GM_STR("no parameter " << param_name << " available in " << type));
@@ -412,14 +418,48 @@ void Configuration::parse_param(tinyxml2::XMLElement *element,
   }
   
   const char* value_attribute = element->Attribute("value");
-  if (value_attribute == NULL) {
-    GM_WRN("Configuration", "Node \"param\" is missing expected attribute \"value\"");
-    if (error_list) error_list->push_back("Node \"param\" is missing expected attribute \"value\"");
-    else throw gmCore::InvalidArgument("Node \"param\" is missing expected attribute \"value\"");
+  const char* file_attribute = element->Attribute("file");
+  if (value_attribute == NULL && file_attribute == NULL) {
+    GM_WRN("Configuration", "Node \"param\" is missing expected attribute \"value\" or \"file\"");
+    if (error_list) error_list->push_back("Node \"param\" is missing expected attribute \"value\" or \"file\"");
+    else throw gmCore::InvalidArgument("Node \"param\" is missing expected attribute \"value\" or \"file\"");
+    return;
+  }
+
+  if (value_attribute != NULL && file_attribute != NULL) {
+    GM_WRN("Configuration", "Node \"param\" has both attribute \"value\" and \"file\"");
+    if (error_list) error_list->push_back("Node \"param\" has both attribute \"value\" and \"file\"");
+    else throw gmCore::InvalidArgument("Node \"param\" has both attribute \"value\" and \"file\"");
     return;
   }
 
   std::string name = name_attribute;
+
+  if (file_attribute != NULL) {
+
+    const char* format_attribute = element->Attribute("format");
+
+    try {
+      std::filesystem::path file = FileResolver::getDefault()->resolve(
+          std::string(file_attribute), FileResolver::Check::ReadableFile);
+
+      parameter_t param(file.string());
+      param.sidecar = std::make_shared<ParamSidecar>(
+          file,
+          ParamSidecar::parseFormat(format_attribute ? format_attribute : "",
+                                    file));
+
+      GM_DBG2("Configuration", "Parsed param: " << name << " = " << file << " (sidecar)");
+
+      parameters.push_back(std::pair<std::string, parameter_t>(name, param));
+    } catch (const gmCore::InvalidArgument &e) {
+      GM_WRN("Configuration", "While reading sidecar for param " << name << ": " << e.what);
+      if (error_list) error_list->push_back(e.what);
+      else throw;
+    }
+    return;
+  }
+
   std::string value = value_attribute;
 
   GM_DBG2("Configuration", "Parsed param: " << name << " = " << value);
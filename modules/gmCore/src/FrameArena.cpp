@@ -0,0 +1,255 @@
+
+#include <gmCore/FrameArena.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+BEGIN_NAMESPACE_GMCORE;
+
+namespace {
+
+  /**
+     Header at the start of each block of memory. The reference count
+     is one for the owning arena plus one per live allocation, so that
+     the block can be freed by whichever releases it last, also after
+     the owning thread has exited.
+  */
+  struct Block {
+    std::atomic<size_t> refs = 1;
+    size_t size;
+
+    std::byte *begin() { return reinterpret_cast<std::byte*>(this + 1); }
+    std::byte *end() { return reinterpret_cast<std::byte*>(this) + size; }
+
+    void release() {
+      if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+      this->~Block();
+      ::operator delete(this);
+    }
+  };
+
+  /// Each allocation is preceded by a pointer to its block
+  constexpr size_t PREFIX_SIZE = sizeof(Block*);
+
+  constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  struct Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<FrameArena>> arenas;
+    std::vector<FrameArena*> free_arenas;
+    FrameArena::Statistics last_frame;
+  };
+
+  Registry &getRegistry() {
+    // Never destroyed, since the thread exit handlers that use it may
+    // run after the destruction of static objects on the main thread
+    static Registry *registry = new Registry;
+    return *registry;
+  }
+
+  thread_local FrameArena *thread_arena = nullptr;
+
+  /**
+     Counter written by one thread only, that is read by other
+     threads without the cost of atomic increments.
+  */
+  struct Counter {
+    std::atomic<size_t> value = 0;
+    void add(size_t n) {
+      value.store(value.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+    }
+  };
+}
+
+struct FrameArena::Impl {
+
+  /**
+     Releases the arena of the current thread when the thread exits.
+  */
+  struct Owner {
+    ~Owner();
+    FrameArena *arena = nullptr;
+  };
+
+  ~Impl() { release(); }
+
+  void * allocate(size_t bytes, size_t alignment);
+
+  /**
+     Allocates from the current block, if it has enough space left.
+  */
+  void * allocateInBlock(size_t bytes, size_t alignment);
+
+  /**
+     Makes an unused block, large enough for the specified
+     allocation, the current block, allocating a new block only if
+     there is no such block.
+  */
+  void nextBlock(size_t bytes, size_t alignment);
+
+  /**
+     Gives up all blocks, freeing those that have no live allocations.
+  */
+  void release();
+
+  std::vector<Block*> blocks;
+  Block *current = nullptr;
+  std::byte *cursor = nullptr;
+
+  Counter allocation_count;
+  Counter allocated_bytes;
+  Counter upstream_allocation_count;
+
+  /// Totals at the last frame, accessed under the registry lock
+  Statistics last_frame;
+
+  static thread_local Owner owner;
+};
+
+thread_local FrameArena::Impl::Owner FrameArena::Impl::owner;
+
+FrameArena::FrameArena()
+  : _impl(std::make_unique<Impl>()) {}
+
+FrameArena::~FrameArena() {}
+
+FrameArena::Impl::Owner::~Owner() {
+  if (!arena) return;
+  Registry &registry = getRegistry();
+  std::lock_guard<std::mutex> guard(registry.lock);
+  arena->_impl->release();
+  registry.free_arenas.push_back(arena);
+}
+
+FrameArena * FrameArena::get() {
+  if (thread_arena) [[likely]] return thread_arena;
+
+  // Arenas of exited threads are reused, since containers may still
+  // refer to them
+  Registry &registry = getRegistry();
+  std::lock_guard<std::mutex> guard(registry.lock);
+  if (registry.free_arenas.empty()) {
+    registry.arenas.emplace_back(new FrameArena());
+    thread_arena = registry.arenas.back().get();
+  } else {
+    thread_arena = registry.free_arenas.back();
+    registry.free_arenas.pop_back();
+  }
+  Impl::owner.arena = thread_arena;
+  return thread_arena;
+}
+
+void FrameArena::nextFrame() {
+  Registry &registry = getRegistry();
+  std::lock_guard<std::mutex> guard(registry.lock);
+
+  Statistics total;
+  for (auto &arena : registry.arenas) {
+    Impl &impl = *arena->_impl;
+    Statistics current;
+    current.allocation_count = impl.allocation_count.value;
+    current.allocated_bytes = impl.allocated_bytes.value;
+    current.upstream_allocation_count = impl.upstream_allocation_count.value;
+
+    total.allocation_count +=
+      current.allocation_count - impl.last_frame.allocation_count;
+    total.allocated_bytes +=
+      current.allocated_bytes - impl.last_frame.allocated_bytes;
+    total.upstream_allocation_count +=
+      current.upstream_allocation_count - impl.last_frame.upstream_allocation_count;
+    impl.last_frame = current;
+  }
+  registry.last_frame = total;
+}
+
+FrameArena::Statistics FrameArena::getFrameStatistics() {
+  Registry &registry = getRegistry();
+  std::lock_guard<std::mutex> guard(registry.lock);
+  return registry.last_frame;
+}
+
+void * FrameArena::do_allocate(size_t bytes, size_t alignment) {
+  return _impl->allocate(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void *p, size_t, size_t) {
+  Block *block;
+  std::memcpy(&block, static_cast<std::byte*>(p) - PREFIX_SIZE, PREFIX_SIZE);
+  block->release();
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource &other)
+  const noexcept {
+  return this == &other;
+}
+
+void * FrameArena::Impl::allocate(size_t bytes, size_t alignment) {
+
+  if (bytes == 0) bytes = 1;
+
+  // Rewind the current block when all its allocations are gone
+  if (current && current->refs.load(std::memory_order_acquire) == 1)
+    cursor = current->begin();
+
+  void *ptr = allocateInBlock(bytes, alignment);
+  if (!ptr) [[unlikely]] {
+    nextBlock(bytes, alignment);
+    ptr = allocateInBlock(bytes, alignment);
+  }
+
+  allocation_count.add(1);
+  allocated_bytes.add(bytes);
+  return ptr;
+}
+
+void * FrameArena::Impl::allocateInBlock(size_t bytes, size_t alignment) {
+
+  if (!current) return nullptr;
+
+  size_t space = size_t(current->end() - cursor);
+  if (space < PREFIX_SIZE) return nullptr;
+
+  void *ptr = cursor + PREFIX_SIZE;
+  space -= PREFIX_SIZE;
+  if (!std::align(alignment, bytes, ptr, space)) return nullptr;
+
+  std::memcpy(static_cast<std::byte*>(ptr) - PREFIX_SIZE, &current, PREFIX_SIZE);
+  cursor = static_cast<std::byte*>(ptr) + bytes;
+  current->refs.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void FrameArena::Impl::nextBlock(size_t bytes, size_t alignment) {
+
+  size_t required = sizeof(Block) + PREFIX_SIZE + bytes + alignment;
+
+  for (auto block : blocks)
+    if (block != current && block->size >= required &&
+        block->refs.load(std::memory_order_acquire) == 1) {
+      current = block;
+      cursor = block->begin();
+      return;
+    }
+
+  size_t size = std::max(BLOCK_SIZE, required);
+  current = new (::operator new(size)) Block();
+  current->size = size;
+  cursor = current->begin();
+  blocks.push_back(current);
+  upstream_allocation_count.add(1);
+}
+
+void FrameArena::Impl::release() {
+  for (auto block : blocks)
+    block->release();
+  blocks.clear();
+  current = nullptr;
+  cursor = nullptr;
+}
+
+END_NAMESPACE_GMCORE;
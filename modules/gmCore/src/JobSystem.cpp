@@ -0,0 +1,463 @@
+#include <gmCore/JobSystem.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/RuntimeException.hh>
+#include <gmCore/Updateable.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+BEGIN_NAMESPACE_GMCORE;
+
+GM_OFI_DEFINE(JobSystem);
+GM_OFI_PARAM2(JobSystem, workerCount, size_t, setWorkerCount);
+GM_OFI_PARAM2(JobSystem, frameBarrier, bool, setFrameBarrier);
+GM_OFI_PARAM2(JobSystem, parallelUpdate, bool, setParallelUpdate);
+
+namespace {
+  std::mutex shared_instance_lock;
+  std::weak_ptr<JobSystem> shared_instance;
+}
+
+struct JobSystem::Impl {
+
+  /**
+     Job queue of one worker, or the injection queue for jobs added
+     from other threads. The owner takes from the back and other
+     threads steal from the front.
+  */
+  struct Queue {
+    std::mutex lock;
+    std::deque<Job> jobs;
+  };
+
+  /**
+     Waits for the frame group at the end of Updateable::updateAll.
+  */
+  struct FrameBarrier : Updateable {
+    FrameBarrier(JobSystem::Impl *impl)
+      // Lowest priority possible, that can be negated
+      : Updateable(std::numeric_limits<int>::min() + 1),
+        impl(impl) {}
+    void update(clock::time_point, size_t) override { impl->waitFrame(); }
+    JobSystem::Impl *impl;
+  };
+
+  Impl(JobSystem *_this) : _this(_this) {}
+
+  void start();
+  void stop();
+
+  void push(Job job);
+  bool runOne();
+  void workerLoop(size_t idx);
+
+  void waitFrame();
+
+  /**
+     Returns the index of the queue owned by the calling thread, or
+     the index of the injection queue if the calling thread is not a
+     worker of this job system.
+  */
+  size_t getQueueIndex();
+
+  JobSystem *_this;
+
+  size_t worker_count = 0;
+  size_t thread_count = 0;
+  bool parallel_update = false;
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> threads;
+
+  std::atomic<size_t> pending_count = 0;
+  std::atomic<bool> alive = false;
+  std::mutex sleep_lock;
+  std::condition_variable sleep_condition;
+
+  std::unique_ptr<TaskGroup> frame_group;
+  std::mutex frame_lock;
+  std::unique_ptr<FrameBarrier> frame_barrier;
+
+  static thread_local Impl *current_system;
+  static thread_local size_t current_index;
+
+  /// Job system released by a job on this worker, freed when the
+  /// worker exits
+  static thread_local std::unique_ptr<Impl> orphan;
+};
+
+thread_local JobSystem::Impl *JobSystem::Impl::current_system = nullptr;
+thread_local size_t JobSystem::Impl::current_index = 0;
+thread_local std::unique_ptr<JobSystem::Impl> JobSystem::Impl::orphan;
+
+/**
+   Jobs of a group are kept by the group, with a ticket per job in
+   the job system queues, so that a thread waiting for the group can
+   run the group's own jobs without picking up unrelated ones. A
+   ticket finding the jobs already taken does nothing.
+*/
+struct JobSystem::TaskGroup::State {
+  std::atomic<size_t> count = 0;
+  std::mutex lock;
+  std::condition_variable condition;
+  std::deque<Job> jobs;
+  std::exception_ptr exception;
+
+  /**
+     Runs one pending job of the group, if any, and returns true if
+     a job was run.
+  */
+  bool runOne();
+};
+
+JobSystem::JobSystem()
+  : _impl(std::make_unique<Impl>(this)) {}
+
+JobSystem::~JobSystem() {
+  _impl->stop();
+
+  // The worker releasing the last reference is still running a job
+  // of this system, so keep the state until the worker exits
+  if (Impl::current_system == _impl.get())
+    Impl::orphan = std::move(_impl);
+}
+
+std::shared_ptr<JobSystem> JobSystem::get() {
+  std::lock_guard<std::mutex> guard(shared_instance_lock);
+  std::shared_ptr<JobSystem> locked = shared_instance.lock();
+  if (!locked) {
+    locked = std::make_shared<JobSystem>();
+    shared_instance = locked;
+    locked->_impl->start();
+    locked->Object::initialize();
+  }
+  return locked;
+}
+
+void JobSystem::initialize() {
+  _impl->start();
+
+  std::shared_ptr<JobSystem> self =
+    std::static_pointer_cast<JobSystem>(weak_from_this().lock());
+  if (self) {
+    std::lock_guard<std::mutex> guard(shared_instance_lock);
+    if (!shared_instance.expired())
+      GM_WRN("JobSystem", "Replacing the shared job system instance, that is still in use.");
+    shared_instance = self;
+  }
+
+  if (_impl->parallel_update) {
+    if (self)
+      Updateable::setJobSystem(self);
+    else
+      GM_WRN("JobSystem", "Cannot use job system for parallel update unless it is held by a shared pointer.");
+  }
+
+  Object::initialize();
+}
+
+void JobSystem::setWorkerCount(size_t N) {
+  if (_impl->alive)
+    throw RuntimeException("Cannot change worker count after initialization");
+  _impl->worker_count = N;
+}
+
+size_t JobSystem::getWorkerCount() {
+  return _impl->thread_count;
+}
+
+void JobSystem::setParallelUpdate(bool on) {
+  _impl->parallel_update = on;
+}
+
+void JobSystem::setFrameBarrier(bool on) {
+  std::lock_guard<std::mutex> guard(_impl->frame_lock);
+  if (on && !_impl->frame_barrier)
+    _impl->frame_barrier = std::make_unique<Impl::FrameBarrier>(_impl.get());
+  else if (!on)
+    _impl->frame_barrier.reset();
+}
+
+void JobSystem::Impl::start() {
+  if (alive) return;
+
+  size_t N = worker_count;
+  if (N == 0) {
+    size_t hardware_count = std::thread::hardware_concurrency();
+    N = hardware_count > 1 ? hardware_count - 1 : 1;
+  }
+
+  GM_DBG1("JobSystem", "Starting " << N << " workers");
+
+  // One queue per worker plus one for other threads
+  for (size_t idx = 0; idx <= N; ++idx)
+    queues.push_back(std::make_unique<Queue>());
+
+  thread_count = N;
+  threads.reserve(N);
+
+  alive = true;
+  for (size_t idx = 0; idx < N; ++idx)
+    threads.emplace_back([this, idx] { this->workerLoop(idx); });
+}
+
+void JobSystem::Impl::stop() {
+
+  // Finish frame jobs while the workers are still available
+  frame_barrier.reset();
+  waitFrame();
+
+  if (!alive) return;
+
+  {
+    std::lock_guard<std::mutex> guard(sleep_lock);
+    alive = false;
+  }
+  sleep_condition.notify_all();
+
+  for (size_t idx = 0; idx < threads.size(); ++idx) {
+    if (!threads[idx].joinable()) continue;
+    // A worker cannot join itself, it exits after the current job
+    if (current_system == this && current_index == idx)
+      threads[idx].detach();
+    else
+      threads[idx].join();
+  }
+  threads.clear();
+}
+
+size_t JobSystem::Impl::getQueueIndex() {
+  if (current_system == this) return current_index;
+  return thread_count;
+}
+
+void JobSystem::Impl::push(Job job) {
+  {
+    Queue &queue = *queues[getQueueIndex()];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.jobs.push_back(std::move(job));
+  }
+  ++pending_count;
+
+  // Synchronize with workers checking pending_count before sleeping
+  { std::lock_guard<std::mutex> guard(sleep_lock); }
+  sleep_condition.notify_one();
+}
+
+bool JobSystem::Impl::runOne() {
+
+  if (pending_count == 0) return false;
+
+  const size_t queue_count = queues.size();
+  const size_t own_idx = getQueueIndex();
+
+  Job job;
+
+  if (own_idx < thread_count) {
+    Queue &queue = *queues[own_idx];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (!queue.jobs.empty()) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    }
+  }
+
+  for (size_t offset = 1; !job && offset <= queue_count; ++offset) {
+    Queue &queue = *queues[(own_idx + offset) % queue_count];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (!queue.jobs.empty()) {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+  }
+
+  if (!job) return false;
+  --pending_count;
+
+  try {
+    job();
+  } catch (const RuntimeException &e) {
+    GM_ERR("JobSystem", "Job failed: " << e.what);
+  } catch (const std::exception &e) {
+    GM_ERR("JobSystem", "Job failed: " << e.what());
+  } catch (...) {
+    GM_ERR("JobSystem", "Job failed with unknown exception");
+  }
+
+  return true;
+}
+
+void JobSystem::Impl::workerLoop(size_t idx) {
+  current_system = this;
+  current_index = idx;
+
+  while (true) {
+    if (runOne()) continue;
+
+    std::unique_lock<std::mutex> guard(sleep_lock);
+    sleep_condition.wait_for(guard, std::chrono::milliseconds(100), [this] {
+      return !alive || pending_count > 0;
+    });
+    if (!alive && pending_count == 0) break;
+  }
+
+  current_system = nullptr;
+
+  // Must be last, since this frees this job system
+  if (orphan.get() == this) orphan.reset();
+}
+
+void JobSystem::submit(Job job) {
+  if (!_impl->alive) {
+    job();
+    return;
+  }
+  _impl->push(std::move(job));
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end,
+                            const std::function<void(size_t, size_t)> &body,
+                            size_t grain) {
+  if (end <= begin) return;
+  const size_t count = end - begin;
+
+  // Aim for a few chunks per participating thread, for load balancing
+  const size_t chunk_count = 4 * (_impl->thread_count + 1);
+  size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+  chunk_size = std::max(chunk_size, std::max(grain, size_t(1)));
+
+  if (chunk_size >= count || !_impl->alive) {
+    body(begin, end);
+    return;
+  }
+
+  TaskGroup group(*this);
+  size_t chunk_begin = begin;
+  // The last chunk takes the remainder, so it is never smaller
+  while (end - chunk_begin >= 2 * chunk_size) {
+    size_t chunk_end = chunk_begin + chunk_size;
+    group.run([&body, chunk_begin, chunk_end] { body(chunk_begin, chunk_end); });
+    chunk_begin = chunk_end;
+  }
+  // The calling thread helps out while waiting
+  group.run([&body, chunk_begin, end] { body(chunk_begin, end); });
+  group.wait();
+}
+
+void JobSystem::submitFrameJob(Job job) {
+  std::lock_guard<std::mutex> guard(_impl->frame_lock);
+  if (!_impl->frame_group)
+    _impl->frame_group = std::make_unique<TaskGroup>(*this);
+  _impl->frame_group->run(std::move(job));
+}
+
+void JobSystem::waitFrame() {
+  _impl->waitFrame();
+}
+
+void JobSystem::Impl::waitFrame() {
+  std::unique_ptr<TaskGroup> group;
+  {
+    std::lock_guard<std::mutex> guard(frame_lock);
+    group.swap(frame_group);
+  }
+  if (!group) return;
+
+  try {
+    group->wait();
+  } catch (const RuntimeException &e) {
+    GM_ERR("JobSystem", "Frame job failed: " << e.what);
+  } catch (const std::exception &e) {
+    GM_ERR("JobSystem", "Frame job failed: " << e.what());
+  } catch (...) {
+    GM_ERR("JobSystem", "Frame job failed with unknown exception");
+  }
+}
+
+JobSystem::TaskGroup::TaskGroup(JobSystem &system)
+  : system(system),
+    state(std::make_shared<State>()) {}
+
+JobSystem::TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {}
+}
+
+void JobSystem::TaskGroup::run(Job job) {
+
+  if (!system._impl->alive) {
+    try {
+      job();
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(state->lock);
+      if (!state->exception) state->exception = std::current_exception();
+    }
+    return;
+  }
+
+  ++state->count;
+  {
+    std::lock_guard<std::mutex> guard(state->lock);
+    state->jobs.push_back(std::move(job));
+  }
+  // Wake the waiting thread, to run the new job
+  state->condition.notify_all();
+
+  system._impl->push([state = state] { state->runOne(); });
+}
+
+bool JobSystem::TaskGroup::State::runOne() {
+
+  Job job;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (jobs.empty()) return false;
+    job = std::move(jobs.front());
+    jobs.pop_front();
+  }
+
+  try {
+    job();
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!exception) exception = std::current_exception();
+  }
+
+  if (--count == 0) {
+    std::lock_guard<std::mutex> guard(lock);
+    condition.notify_all();
+  }
+
+  return true;
+}
+
+void JobSystem::TaskGroup::wait() {
+
+  while (state->count > 0) {
+    if (state->runOne()) continue;
+
+    // Nothing left to help out with; wait for the running jobs or
+    // for jobs added by them
+    std::unique_lock<std::mutex> guard(state->lock);
+    state->condition.wait(guard, [this] {
+      return state->count == 0 || !state->jobs.empty();
+    });
+  }
+
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> guard(state->lock);
+    exception.swap(state->exception);
+  }
+  if (exception) std::rethrow_exception(exception);
+}
+
+END_NAMESPACE_GMCORE;
@@ -0,0 +1,140 @@
+#include <gmCore/MappedFile.hh>
+
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/Stringify.hh>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+BEGIN_NAMESPACE_GMCORE;
+
+struct MappedFile::Impl {
+
+  Impl(std::filesystem::path file);
+  ~Impl();
+
+  std::filesystem::path path;
+  const char *data = nullptr;
+  size_t size = 0;
+
+#ifdef _WIN32
+  HANDLE file_handle = INVALID_HANDLE_VALUE;
+  HANDLE mapping_handle = NULL;
+#else
+  int fd = -1;
+#endif
+};
+
+MappedFile::MappedFile(std::filesystem::path file)
+  : _impl(std::make_unique<Impl>(file)) {}
+
+MappedFile::~MappedFile() {}
+
+#ifdef _WIN32
+
+MappedFile::Impl::Impl(std::filesystem::path file)
+  : path(file) {
+
+  file_handle = CreateFileW(file.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            NULL,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            NULL);
+  if (file_handle == INVALID_HANDLE_VALUE)
+    throw InvalidArgument(GM_STR("Cannot open file " << file
+                                 << " (error " << GetLastError() << ")"));
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size)) {
+    CloseHandle(file_handle);
+    throw InvalidArgument(GM_STR("Cannot read size of file " << file));
+  }
+
+  size = size_t(file_size.QuadPart);
+  if (size == 0) return;
+
+  mapping_handle = CreateFileMappingW(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_handle != NULL)
+    data = static_cast<const char *>(
+        MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+
+  if (data == nullptr) {
+    if (mapping_handle != NULL) CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+    throw InvalidArgument(GM_STR("Cannot map file " << file
+                                 << " (error " << GetLastError() << ")"));
+  }
+}
+
+MappedFile::Impl::~Impl() {
+  if (data) UnmapViewOfFile(data);
+  if (mapping_handle != NULL) CloseHandle(mapping_handle);
+  if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+}
+
+#else
+
+MappedFile::Impl::Impl(std::filesystem::path file)
+  : path(file) {
+
+  fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw InvalidArgument(GM_STR("Cannot open file " << file
+                                 << " (" << strerror(errno) << ")"));
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    close(fd);
+    throw InvalidArgument(GM_STR("Cannot map " << file
+                                 << ", which is not a regular file"));
+  }
+
+  size = size_t(file_stat.st_size);
+  if (size == 0) return;
+
+  void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (ptr == MAP_FAILED) {
+    int error = errno;
+    close(fd);
+    throw InvalidArgument(GM_STR("Cannot map file " << file
+                                 << " (" << strerror(error) << ")"));
+  }
+
+  // Data is typically read once from start to end
+  madvise(ptr, size, MADV_SEQUENTIAL);
+
+  data = static_cast<const char *>(ptr);
+}
+
+MappedFile::Impl::~Impl() {
+  if (data) munmap(const_cast<char *>(data), size);
+  if (fd >= 0) close(fd);
+}
+
+#endif
+
+const char * MappedFile::data() const {
+  return _impl->data;
+}
+
+size_t MappedFile::size() const {
+  return _impl->size;
+}
+
+const std::filesystem::path & MappedFile::getPath() const {
+  return _impl->path;
+}
+
+END_NAMESPACE_GMCORE;
@@ -85,6 +85,28 @@ bool OFactory::OFactoryInformation::setParamValueFromString
   return true;
 }
 
+bool OFactory::OFactoryInformation::setParamValuesFromSidecar
+(Object *node, std::string name, const ParamSidecar &sidecar) const {
+
+  if (param_setters.count(name) == 0) {
+    if (base == nullptr)
+      return false;
+    else
+      return base->setParamValuesFromSidecar(node, name, sidecar);
+  }
+
+  param_setters.find(name)->second->setValuesFromSidecar(node, sidecar);
+
+  return true;
+}
+
+void OFactory::ParamSetterBase::setValuesFromSidecar
+(Object *node, const ParamSidecar &sidecar) const {
+  sidecar.forEachLine([&](std::string_view line) {
+    setValueFromString(node, std::string(line));
+  });
+}
+
 bool OFactory::OFactoryInformation::setPointerValue
 (Object *node, std::string name, std::shared_ptr<Object> ptr) const {
 
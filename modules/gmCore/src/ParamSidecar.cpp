@@ -0,0 +1,36 @@
+#include <gmCore/ParamSidecar.hh>
+
+#include <algorithm>
+#include <cctype>
+
+BEGIN_NAMESPACE_GMCORE;
+
+ParamSidecar::ParamSidecar(std::filesystem::path path, Format format)
+  : file(std::make_shared<MappedFile>(path)),
+    format(format) {}
+
+ParamSidecar::Format ParamSidecar::parseFormat(std::string name,
+                                               const std::filesystem::path &file) {
+
+  std::transform(name.begin(), name.end(), name.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+
+  if (name.empty()) {
+    std::string extension = file.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    if (extension == ".csv" || extension == ".txt") return Format::Text;
+    if (extension == ".f64") return Format::Float64;
+    return Format::Float32;
+  }
+
+  if (name == "text" || name == "csv") return Format::Text;
+  if (name == "float32" || name == "float") return Format::Float32;
+  if (name == "float64" || name == "double") return Format::Float64;
+
+  throw InvalidArgument(GM_STR("Unknown sidecar format '" << name
+                               << "' (expected text, float32 or float64)"));
+}
+
+END_NAMESPACE_GMCORE;
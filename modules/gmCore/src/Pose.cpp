@@ -11,6 +11,7 @@
 #include <nlohmann/json.hpp>
 #endif
 
+#include <algorithm>
 #include <cctype>
 
 #ifdef gramods_ENABLE_nlohmann_json
@@ -94,4 +95,57 @@ std::ostream &operator<<(std::ostream &out, const gmCore::Pose &pose) {
 
 END_NAMESPACE_GRAMODS;
 
+BEGIN_NAMESPACE_GMCORE;
+
+bool FastParser<Pose>::parse(std::string_view str, Pose &p) {
+
+  float position[3];
+  const char *ptr = str.data();
+  const char *last = str.data() + str.size();
+
+  if (!detail::parse_numbers<float, 3>(ptr, last, position))
+    return false;
+
+  // Same as the stream operator; only spaces before the separator
+  while (ptr != last && *ptr == ' ') ++ptr;
+
+  Eigen::Quaternionf orientation = Eigen::Quaternionf::Identity();
+  if (ptr != last && *ptr == ';') {
+    ++ptr;
+    if (!FastParser<Eigen::Quaternionf>::parse(
+            std::string_view(ptr, last - ptr), orientation))
+      return false;
+    p.orientation = orientation;
+  }
+
+  p.position = Eigen::Vector3f(position[0], position[1], position[2]);
+  return true;
+}
+
+bool FastParser<std::vector<Pose>>::parse(std::string_view str,
+                                          std::vector<Pose> &p) {
+
+  std::vector<Pose> poses;
+  poses.reserve(std::count(str.begin(), str.end(), ',') + 1);
+
+  size_t pos = 0;
+  while (pos < str.size()) {
+
+    size_t end = str.find(',', pos);
+    if (end == std::string_view::npos) end = str.size();
+
+    Pose val;
+    if (!FastParser<Pose>::parse(str.substr(pos, end - pos), val))
+      return false;
+    poses.push_back(val);
+
+    pos = end + 1;
+  }
+
+  p.insert(p.end(), poses.begin(), poses.end());
+  return true;
+}
+
+END_NAMESPACE_GMCORE;
+
 #endif
@@ -0,0 +1,395 @@
+
+#include <gmCore/PoseArray.hh>
+
+#ifdef gramods_ENABLE_Eigen3
+
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/Stringify.hh>
+
+#include <algorithm>
+
+BEGIN_NAMESPACE_GMCORE;
+
+namespace {
+
+  // Poses are processed in chunks whose results fit on the stack,
+  // so that kernels can write to the same array as they read from
+  constexpr Eigen::Index CHUNK = 256;
+
+  typedef Eigen::Array<float, Eigen::Dynamic, 1, 0, CHUNK, 1> Lane;
+  typedef Eigen::Map<const Eigen::ArrayXf> ConstColumn;
+  typedef Eigen::Map<Eigen::ArrayXf> Column;
+  typedef decltype(Lane::Constant(1, 0.f)) ConstantLane;
+
+  /**
+     Chunk of a pose array, read in place.
+  */
+  struct Segment {
+
+    Segment(const PoseArray &a, size_t begin, Eigen::Index n)
+      : px(a.px.data() + begin, n),
+        py(a.py.data() + begin, n),
+        pz(a.pz.data() + begin, n),
+        qw(a.qw.data() + begin, n),
+        qx(a.qx.data() + begin, n),
+        qy(a.qy.data() + begin, n),
+        qz(a.qz.data() + begin, n) {}
+
+    ConstColumn px, py, pz, qw, qx, qy, qz;
+  };
+
+  /**
+     One pose repeated over a chunk, without storing it.
+  */
+  struct Broadcast {
+
+    Broadcast(const Pose &p, Eigen::Index n)
+      : px(Lane::Constant(n, p.position.x())),
+        py(Lane::Constant(n, p.position.y())),
+        pz(Lane::Constant(n, p.position.z())),
+        qw(Lane::Constant(n, p.orientation.w())),
+        qx(Lane::Constant(n, p.orientation.x())),
+        qy(Lane::Constant(n, p.orientation.y())),
+        qz(Lane::Constant(n, p.orientation.z())) {}
+
+    ConstantLane px, py, pz, qw, qx, qy, qz;
+  };
+
+  /**
+     Chunk of computed poses, to store into a pose array.
+  */
+  struct Lanes {
+
+    Lane px, py, pz, qw, qx, qy, qz;
+
+    void store(PoseArray &a, size_t begin) const {
+      Eigen::Index n = px.size();
+      Column(a.px.data() + begin, n) = px;
+      Column(a.py.data() + begin, n) = py;
+      Column(a.pz.data() + begin, n) = pz;
+      Column(a.qw.data() + begin, n) = qw;
+      Column(a.qx.data() + begin, n) = qx;
+      Column(a.qy.data() + begin, n) = qy;
+      Column(a.qz.data() + begin, n) = qz;
+    }
+  };
+
+  template<class FUNC>
+  void forChunks(size_t N, FUNC func) {
+    for (size_t begin = 0; begin < N; begin += CHUNK)
+      func(begin, Eigen::Index(std::min<size_t>(CHUNK, N - begin)));
+  }
+
+  /**
+     Sets r = q * v, for unit quaternions q.
+  */
+  template<class Q, class VX, class VY, class VZ>
+  void rotate(const Q &q, const VX &vx, const VY &vy, const VZ &vz,
+              Lane &rx, Lane &ry, Lane &rz) {
+    Lane tx = 2.f * (q.qy * vz - q.qz * vy);
+    Lane ty = 2.f * (q.qz * vx - q.qx * vz);
+    Lane tz = 2.f * (q.qx * vy - q.qy * vx);
+    rx = vx + q.qw * tx + (q.qy * tz - q.qz * ty);
+    ry = vy + q.qw * ty + (q.qz * tx - q.qx * tz);
+    rz = vz + q.qw * tz + (q.qx * ty - q.qy * tx);
+  }
+
+  /**
+     Sets the orientation of out to a * b.
+  */
+  template<class A, class B>
+  void multiplyOrientation(const A &a, const B &b, Lanes &out) {
+    out.qw = a.qw * b.qw - a.qx * b.qx - a.qy * b.qy - a.qz * b.qz;
+    out.qx = a.qw * b.qx + a.qx * b.qw + a.qy * b.qz - a.qz * b.qy;
+    out.qy = a.qw * b.qy - a.qx * b.qz + a.qy * b.qw + a.qz * b.qx;
+    out.qz = a.qw * b.qz + a.qx * b.qy - a.qy * b.qx + a.qz * b.qw;
+  }
+
+  /**
+     Sets out = a * b.
+  */
+  template<class A, class B>
+  void multiply(const A &a, const B &b, Lanes &out) {
+    rotate(a, b.px, b.py, b.pz, out.px, out.py, out.pz);
+    out.px += a.px;
+    out.py += a.py;
+    out.pz += a.pz;
+    multiplyOrientation(a, b, out);
+  }
+
+  void normalizeOrientation(Lanes &a) {
+    Lane inv_norm = (a.qw.square() + a.qx.square() +
+                     a.qy.square() + a.qz.square()).rsqrt();
+    a.qw *= inv_norm;
+    a.qx *= inv_norm;
+    a.qy *= inv_norm;
+    a.qz *= inv_norm;
+  }
+
+  void checkSize(const PoseArray &a, const PoseArray &b) {
+    if (a.size() != b.size())
+      throw InvalidArgument(GM_STR("Pose arrays of different sizes ("
+                                   << a.size() << " != " << b.size() << ")"));
+  }
+
+  /**
+     Interpolates between a and b, using spherical interpolation of
+     the orientations if specified, otherwise normalized linear
+     interpolation.
+  */
+  void interpolate(const PoseArray &a, const PoseArray &b, float t,
+                   bool spherical, PoseArray &out) {
+    checkSize(a, b);
+    out.resize(a.size());
+
+    forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+      Segment la(a, begin, n);
+      Segment lb(b, begin, n);
+      Lanes lo;
+
+      lo.px = la.px + t * (lb.px - la.px);
+      lo.py = la.py + t * (lb.py - la.py);
+      lo.pz = la.pz + t * (lb.pz - la.pz);
+
+      Lane dot = la.qw * lb.qw + la.qx * lb.qx + la.qy * lb.qy + la.qz * lb.qz;
+      // Take the shortest path
+      Lane sign = (dot < 0.f).select(Lane::Constant(n, -1.f), Lane::Constant(n, 1.f));
+      dot = dot.abs().min(1.f);
+
+      Lane wa, wb;
+      if (spherical) {
+        Lane theta = dot.acos();
+        Lane inv_sin = 1.f / theta.sin();
+        // Nearly parallel orientations are interpolated linearly
+        auto linear = dot > 0.9995f;
+        wa = linear.select(Lane::Constant(n, 1.f - t), ((1.f - t) * theta).sin() * inv_sin);
+        wb = linear.select(Lane::Constant(n, t), (t * theta).sin() * inv_sin);
+      } else {
+        wa.setConstant(n, 1.f - t);
+        wb.setConstant(n, t);
+      }
+      wb *= sign;
+
+      lo.qw = wa * la.qw + wb * lb.qw;
+      lo.qx = wa * la.qx + wb * lb.qx;
+      lo.qy = wa * la.qy + wb * lb.qy;
+      lo.qz = wa * la.qz + wb * lb.qz;
+      normalizeOrientation(lo);
+
+      lo.store(out, begin);
+    });
+  }
+}
+
+PoseArray::PoseArray(const std::vector<Pose> &poses) {
+  reserve(poses.size());
+  for (const auto &pose : poses) push_back(pose);
+}
+
+void PoseArray::resize(size_t N) {
+  px.resize(N, 0.f);
+  py.resize(N, 0.f);
+  pz.resize(N, 0.f);
+  qw.resize(N, 1.f);
+  qx.resize(N, 0.f);
+  qy.resize(N, 0.f);
+  qz.resize(N, 0.f);
+}
+
+void PoseArray::reserve(size_t N) {
+  for (auto *v : { &px, &py, &pz, &qw, &qx, &qy, &qz }) v->reserve(N);
+}
+
+void PoseArray::push_back(const Pose &pose) {
+  px.push_back(pose.position.x());
+  py.push_back(pose.position.y());
+  pz.push_back(pose.position.z());
+  qw.push_back(pose.orientation.w());
+  qx.push_back(pose.orientation.x());
+  qy.push_back(pose.orientation.y());
+  qz.push_back(pose.orientation.z());
+}
+
+Pose PoseArray::get(size_t idx) const {
+  return { Eigen::Vector3f(px[idx], py[idx], pz[idx]),
+           Eigen::Quaternionf(qw[idx], qx[idx], qy[idx], qz[idx]) };
+}
+
+void PoseArray::set(size_t idx, const Pose &pose) {
+  px[idx] = pose.position.x();
+  py[idx] = pose.position.y();
+  pz[idx] = pose.position.z();
+  qw[idx] = pose.orientation.w();
+  qx[idx] = pose.orientation.x();
+  qy[idx] = pose.orientation.y();
+  qz[idx] = pose.orientation.z();
+}
+
+std::vector<Pose> PoseArray::toPoses() const {
+  std::vector<Pose> poses;
+  poses.reserve(size());
+  for (size_t idx = 0; idx < size(); ++idx) poses.push_back(get(idx));
+  return poses;
+}
+
+void PoseArray::compose(const Pose &a, const PoseArray &b, PoseArray &out) {
+  out.resize(b.size());
+  forChunks(b.size(), [&](size_t begin, Eigen::Index n) {
+    Lanes lo;
+    multiply(Broadcast(a, n), Segment(b, begin, n), lo);
+    lo.store(out, begin);
+  });
+}
+
+void PoseArray::compose(const PoseArray &a, const Pose &b, PoseArray &out) {
+  out.resize(a.size());
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Lanes lo;
+    multiply(Segment(a, begin, n), Broadcast(b, n), lo);
+    lo.store(out, begin);
+  });
+}
+
+void PoseArray::compose(const PoseArray &a, const PoseArray &b, PoseArray &out) {
+  checkSize(a, b);
+  out.resize(a.size());
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Lanes lo;
+    multiply(Segment(a, begin, n), Segment(b, begin, n), lo);
+    lo.store(out, begin);
+  });
+}
+
+void PoseArray::compose(const Eigen::Affine3f &A,
+                        const Eigen::Quaternionf &A_rotation,
+                        const PoseArray &b,
+                        const Pose &c,
+                        PoseArray &out) {
+  out.resize(b.size());
+  const Eigen::Matrix3f L = A.linear();
+  const Eigen::Vector3f T = A.translation();
+
+  forChunks(b.size(), [&](size_t begin, Eigen::Index n) {
+    Lanes bc, lo;
+    multiply(Segment(b, begin, n), Broadcast(c, n), bc);
+
+    lo.px = L(0, 0) * bc.px + L(0, 1) * bc.py + L(0, 2) * bc.pz + T.x();
+    lo.py = L(1, 0) * bc.px + L(1, 1) * bc.py + L(1, 2) * bc.pz + T.y();
+    lo.pz = L(2, 0) * bc.px + L(2, 1) * bc.py + L(2, 2) * bc.pz + T.z();
+
+    multiplyOrientation(Broadcast({ Eigen::Vector3f::Zero(), A_rotation }, n), bc, lo);
+
+    lo.store(out, begin);
+  });
+}
+
+void PoseArray::inverse(const PoseArray &a, PoseArray &out) {
+  out.resize(a.size());
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Segment la(a, begin, n);
+    Lanes lo;
+    lo.qw = la.qw;
+    lo.qx = -la.qx;
+    lo.qy = -la.qy;
+    lo.qz = -la.qz;
+    rotate(lo, la.px, la.py, la.pz, lo.px, lo.py, lo.pz);
+    lo.px = -lo.px;
+    lo.py = -lo.py;
+    lo.pz = -lo.pz;
+    lo.store(out, begin);
+  });
+}
+
+void PoseArray::transformPoint(const PoseArray &a,
+                               const Eigen::Vector3f &point,
+                               Eigen::Matrix3Xf &out) {
+  out.resize(3, Eigen::Index(a.size()));
+  typedef Eigen::Map<Eigen::ArrayXf, 0, Eigen::InnerStride<3>> Row;
+
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Segment la(a, begin, n);
+    Lane rx, ry, rz;
+    rotate(la,
+           Lane::Constant(n, point.x()),
+           Lane::Constant(n, point.y()),
+           Lane::Constant(n, point.z()),
+           rx, ry, rz);
+    Row(out.data() + 3 * begin + 0, n) = rx + la.px;
+    Row(out.data() + 3 * begin + 1, n) = ry + la.py;
+    Row(out.data() + 3 * begin + 2, n) = rz + la.pz;
+  });
+}
+
+void PoseArray::transformPoints(const PoseArray &a,
+                                const Eigen::Matrix3Xf &points,
+                                Eigen::Matrix3Xf &out) {
+  if (size_t(points.cols()) != a.size())
+    throw InvalidArgument(GM_STR("Number of points (" << points.cols()
+                                 << ") differs from number of poses ("
+                                 << a.size() << ")"));
+  out.resize(3, Eigen::Index(a.size()));
+  typedef Eigen::Map<const Eigen::ArrayXf, 0, Eigen::InnerStride<3>> ConstRow;
+  typedef Eigen::Map<Eigen::ArrayXf, 0, Eigen::InnerStride<3>> Row;
+
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Segment la(a, begin, n);
+    Lane rx, ry, rz;
+    rotate(la,
+           ConstRow(points.data() + 3 * begin + 0, n),
+           ConstRow(points.data() + 3 * begin + 1, n),
+           ConstRow(points.data() + 3 * begin + 2, n),
+           rx, ry, rz);
+    Row(out.data() + 3 * begin + 0, n) = rx + la.px;
+    Row(out.data() + 3 * begin + 1, n) = ry + la.py;
+    Row(out.data() + 3 * begin + 2, n) = rz + la.pz;
+  });
+}
+
+void PoseArray::lerp(const PoseArray &a, const PoseArray &b, float t,
+                     PoseArray &out) {
+  interpolate(a, b, t, false, out);
+}
+
+void PoseArray::slerp(const PoseArray &a, const PoseArray &b, float t,
+                      PoseArray &out) {
+  interpolate(a, b, t, true, out);
+}
+
+void PoseArray::toMatrices(const PoseArray &a, std::vector<Eigen::Matrix4f> &out) {
+  out.resize(a.size());
+  static_assert(sizeof(Eigen::Matrix4f) == 16 * sizeof(float));
+
+  // Column major, so element (row, col) is at 4 * col + row
+  typedef Eigen::Map<Eigen::ArrayXf, 0, Eigen::InnerStride<16>> Element;
+  float *data = out.empty() ? nullptr : out.front().data();
+
+  forChunks(a.size(), [&](size_t begin, Eigen::Index n) {
+    Segment la(a, begin, n);
+    float *first = data + 16 * begin;
+
+    Lane xx = la.qx * la.qx, yy = la.qy * la.qy, zz = la.qz * la.qz;
+    Lane xy = la.qx * la.qy, xz = la.qx * la.qz, yz = la.qy * la.qz;
+    Lane wx = la.qw * la.qx, wy = la.qw * la.qy, wz = la.qw * la.qz;
+
+    Element(first + 0, n) = 1.f - 2.f * (yy + zz);
+    Element(first + 1, n) = 2.f * (xy + wz);
+    Element(first + 2, n) = 2.f * (xz - wy);
+    Element(first + 3, n).setZero();
+    Element(first + 4, n) = 2.f * (xy - wz);
+    Element(first + 5, n) = 1.f - 2.f * (xx + zz);
+    Element(first + 6, n) = 2.f * (yz + wx);
+    Element(first + 7, n).setZero();
+    Element(first + 8, n) = 2.f * (xz + wy);
+    Element(first + 9, n) = 2.f * (yz - wx);
+    Element(first + 10, n) = 1.f - 2.f * (xx + yy);
+    Element(first + 11, n).setZero();
+    Element(first + 12, n) = la.px;
+    Element(first + 13, n) = la.py;
+    Element(first + 14, n) = la.pz;
+    Element(first + 15, n).setOnes();
+  });
+}
+
+END_NAMESPACE_GMCORE;
+
+#endif
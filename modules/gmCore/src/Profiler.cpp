@@ -0,0 +1,397 @@
+#include <gmCore/Profiler.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/FileResolver.hh>
+#include <gmCore/Updateable.hh>
+#include <gmCore/io_typeid.hh>
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <mutex>
+#include <vector>
+
+BEGIN_NAMESPACE_GMCORE;
+
+GM_OFI_DEFINE(Profiler);
+GM_OFI_PARAM2(Profiler, traceFile, std::filesystem::path, setTraceFile);
+GM_OFI_PARAM2(Profiler, summaryInterval, size_t, setSummaryInterval);
+GM_OFI_PARAM2(Profiler, bufferSize, size_t, setBufferSize);
+
+std::atomic<bool> Profiler::active_flag = false;
+
+namespace {
+
+  /**
+     One recorded zone. The fields are atomic since a reader may read
+     an event while the owning thread overwrites it; such reads are
+     detected and discarded.
+  */
+  struct Event {
+    std::atomic<const char *> name = nullptr;
+    std::atomic<const std::type_info *> type = nullptr;
+    std::atomic<int64_t> start = 0;
+    std::atomic<int64_t> end = 0;
+  };
+
+  /**
+     Ring buffer of zones written by one single thread.
+  */
+  struct ThreadBuffer {
+
+    ThreadBuffer(size_t capacity, size_t thread_idx)
+      : events(new Event[capacity]),
+        capacity(capacity),
+        thread_idx(thread_idx) {}
+
+    std::unique_ptr<Event[]> events;
+    const size_t capacity;
+    const size_t thread_idx;
+
+    std::atomic<uint64_t> written = 0;
+  };
+
+  /**
+     Zone recorded by a thread that has exited.
+  */
+  struct RetiredEvent {
+    const char *name;
+    const std::type_info *type;
+    int64_t start;
+    int64_t end;
+    size_t thread_idx;
+  };
+
+  struct Registry {
+    std::mutex lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<size_t> buffer_size = 65536;
+    size_t thread_count = 0;
+    size_t profiler_count = 0;
+
+    /// Zones of exited threads, oldest first, limited to the buffer
+    /// size in total so that threads coming and going do not add up
+    std::deque<RetiredEvent> retired;
+  };
+
+  Registry &getRegistry() {
+    // Never destroyed, since the thread exit handlers that use it may
+    // run after the destruction of static objects on the main thread
+    static Registry *registry = new Registry;
+    return *registry;
+  }
+
+  /**
+     Owns the buffer of the current thread and moves its zones to the
+     registry when the thread exits, freeing the buffer.
+  */
+  struct ThreadRecorder {
+
+    ~ThreadRecorder() {
+      if (!buffer) return;
+
+      Registry &registry = getRegistry();
+      std::lock_guard<std::mutex> guard(registry.lock);
+
+      registry.buffers.erase(std::find(registry.buffers.begin(),
+                                       registry.buffers.end(),
+                                       buffer));
+
+      // Keep the same zones as a read while the thread was running
+      uint64_t written = buffer->written.load(std::memory_order_relaxed);
+      uint64_t first_idx =
+        written + 1 > buffer->capacity ? written + 1 - buffer->capacity : 0;
+      for (uint64_t idx = first_idx; idx < written; ++idx) {
+        Event &event = buffer->events[idx % buffer->capacity];
+        registry.retired.push_back({ event.name.load(std::memory_order_relaxed),
+                                     event.type.load(std::memory_order_relaxed),
+                                     event.start.load(std::memory_order_relaxed),
+                                     event.end.load(std::memory_order_relaxed),
+                                     buffer->thread_idx });
+      }
+
+      size_t max_size = registry.buffer_size;
+      if (registry.retired.size() > max_size)
+        registry.retired.erase(registry.retired.begin(),
+                               registry.retired.end() - max_size);
+    }
+
+    std::shared_ptr<ThreadBuffer> buffer;
+  };
+
+  thread_local ThreadRecorder thread_recorder;
+
+  int64_t toNanoseconds(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (t.time_since_epoch()).count();
+  }
+
+  struct EventData {
+    std::string name;
+    int64_t start;
+    int64_t end;
+    size_t thread_idx;
+  };
+
+  /**
+     Copies the events recorded by all threads that ended after the
+     specified time.
+  */
+  std::vector<EventData> collectEvents(int64_t since) {
+
+    std::vector<EventData> result;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      Registry &registry = getRegistry();
+      std::lock_guard<std::mutex> guard(registry.lock);
+      buffers = registry.buffers;
+
+      for (auto &event : registry.retired) {
+        if (event.end <= since) continue;
+        result.push_back({ event.type ? demangle(*event.type)
+                           : std::string(event.name ? event.name : ""),
+                           event.start, event.end, event.thread_idx });
+      }
+    }
+
+    for (auto &buffer : buffers) {
+
+      uint64_t written = buffer->written.load(std::memory_order_acquire);
+      uint64_t first_idx =
+        written > buffer->capacity ? written - buffer->capacity : 0;
+
+      struct Copy {
+        uint64_t idx;
+        const char *name;
+        const std::type_info *type;
+        int64_t start;
+        int64_t end;
+      };
+      std::vector<Copy> copies;
+      copies.reserve(written - first_idx);
+
+      for (uint64_t idx = first_idx; idx < written; ++idx) {
+        Event &event = buffer->events[idx % buffer->capacity];
+        copies.push_back({ idx,
+                           event.name.load(std::memory_order_relaxed),
+                           event.type.load(std::memory_order_relaxed),
+                           event.start.load(std::memory_order_relaxed),
+                           event.end.load(std::memory_order_relaxed) });
+      }
+
+      // Events overwritten by the thread while copying are discarded,
+      // including the one that may currently be written
+      std::atomic_thread_fence(std::memory_order_acquire);
+      written = buffer->written.load(std::memory_order_relaxed) + 1;
+      uint64_t valid_idx =
+        written > buffer->capacity ? written - buffer->capacity : 0;
+
+      for (auto &copy : copies) {
+        if (copy.idx < valid_idx || copy.end <= since) continue;
+        result.push_back({ copy.type ? demangle(*copy.type)
+                           : std::string(copy.name ? copy.name : ""),
+                           copy.start, copy.end, buffer->thread_idx });
+      }
+    }
+
+    return result;
+  }
+
+  std::string escapeJson(const std::string &str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str)
+      switch (c) {
+      case '"': result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      default:
+        if ((unsigned char)c < 0x20) result += ' ';
+        else result += c;
+      }
+    return result;
+  }
+}
+
+struct Profiler::Impl : Updateable {
+
+  // Highest priority, to be called first in each frame
+  Impl(Profiler *_this)
+    : Updateable(std::numeric_limits<int>::max()),
+      _this(_this) {}
+
+  void update(clock::time_point, size_t) override;
+
+  Profiler *_this;
+
+  std::filesystem::path trace_file;
+  size_t summary_interval = 0;
+  size_t frame_count = 0;
+  int64_t last_summary = 0;
+};
+
+Profiler::Profiler()
+  : _impl(std::make_unique<Impl>(this)) {}
+
+Profiler::~Profiler() {
+  if (!isInitialized()) return;
+  {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    if (--registry.profiler_count == 0)
+      active_flag = false;
+  }
+  if (!_impl->trace_file.empty())
+    writeTrace(_impl->trace_file);
+}
+
+void Profiler::initialize() {
+  if (isInitialized()) return;
+  {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    if (registry.profiler_count++ > 0)
+      GM_WRN("Profiler", "Multiple active profilers; recorded zones will be shared.");
+    active_flag = true;
+  }
+  _impl->last_summary = toNanoseconds(std::chrono::steady_clock::now());
+  Object::initialize();
+}
+
+void Profiler::setTraceFile(std::filesystem::path file) {
+  _impl->trace_file = FileResolver::getDefault()->resolve(
+      file, FileResolver::Check::WritableFile);
+}
+
+void Profiler::setSummaryInterval(size_t frames) {
+  _impl->summary_interval = frames;
+}
+
+void Profiler::setBufferSize(size_t N) {
+  if (N == 0) throw InvalidArgument("buffer size must be positive");
+  getRegistry().buffer_size = N;
+}
+
+void Profiler::record(const char *name,
+                      const std::type_info *type,
+                      std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end) {
+
+  std::shared_ptr<ThreadBuffer> &thread_buffer = thread_recorder.buffer;
+  if (!thread_buffer) [[unlikely]] {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    thread_buffer = std::make_shared<ThreadBuffer>(registry.buffer_size,
+                                                   registry.thread_count++);
+    registry.buffers.push_back(thread_buffer);
+  }
+
+  ThreadBuffer &buffer = *thread_buffer;
+  uint64_t idx = buffer.written.load(std::memory_order_relaxed);
+  Event &event = buffer.events[idx % buffer.capacity];
+
+  // Orders the field stores after the previous update of written, so
+  // that a reader seeing any of them also sees that this event is
+  // being overwritten
+  std::atomic_thread_fence(std::memory_order_release);
+  event.name.store(name, std::memory_order_relaxed);
+  event.type.store(type, std::memory_order_relaxed);
+  event.start.store(toNanoseconds(start), std::memory_order_relaxed);
+  event.end.store(toNanoseconds(end), std::memory_order_relaxed);
+  buffer.written.store(idx + 1, std::memory_order_release);
+}
+
+void Profiler::writeTrace(std::filesystem::path file) {
+  std::ofstream out(file);
+  if (!out) {
+    GM_ERR("Profiler", "Could not open " << file << " for writing trace");
+    return;
+  }
+  writeTrace(out);
+  GM_INF("Profiler", "Wrote trace to " << file);
+}
+
+void Profiler::writeTrace(std::ostream &out) {
+
+  auto events = collectEvents(std::numeric_limits<int64_t>::min());
+
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  size_t thread_count = 0;
+  for (auto &event : events) {
+    origin = std::min(origin, event.start);
+    thread_count = std::max(thread_count, event.thread_idx + 1);
+  }
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+  for (size_t idx = 0; idx < thread_count; ++idx) {
+    out << (first ? "\n" : ",\n")
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << idx
+        << ",\"args\":{\"name\":\"thread " << idx << "\"}}";
+    first = false;
+  }
+
+  out << std::fixed << std::setprecision(3);
+  for (auto &event : events) {
+    out << (first ? "\n" : ",\n")
+        << "{\"name\":\"" << escapeJson(event.name)
+        << "\",\"cat\":\"gramods\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_idx
+        << ",\"ts\":" << 1e-3 * double(event.start - origin)
+        << ",\"dur\":" << 1e-3 * double(event.end - event.start) << "}";
+    first = false;
+  }
+
+  out << "\n]}\n";
+}
+
+void Profiler::writeSummary() {
+
+  int64_t now = toNanoseconds(std::chrono::steady_clock::now());
+  auto events = collectEvents(_impl->last_summary);
+
+  struct Stats {
+    size_t count = 0;
+    int64_t total = 0;
+    int64_t max = 0;
+  };
+  std::map<std::string, Stats> zones;
+  for (auto &event : events) {
+    Stats &stats = zones[event.name];
+    int64_t duration = event.end - event.start;
+    ++stats.count;
+    stats.total += duration;
+    stats.max = std::max(stats.max, duration);
+  }
+
+  std::vector<std::pair<std::string, Stats>> sorted(zones.begin(), zones.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second.total > b.second.total;
+  });
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3)
+     << "Zones over the last " << 1e-9 * double(now - _impl->last_summary)
+     << " s (name: count, total ms, mean ms, max ms):";
+  for (auto &[name, stats] : sorted)
+    ss << std::endl << "  " << name << ": " << stats.count
+       << ", " << 1e-6 * double(stats.total)
+       << ", " << 1e-6 * double(stats.total) / double(stats.count)
+       << ", " << 1e-6 * double(stats.max);
+  GM_INF("Profiler", ss.str());
+
+  _impl->last_summary = now;
+}
+
+void Profiler::Impl::update(clock::time_point, size_t) {
+  if (summary_interval == 0 || !_this->isInitialized()) return;
+  if (++frame_count < summary_interval) return;
+  frame_count = 0;
+  _this->writeSummary();
+}
+
+END_NAMESPACE_GMCORE;
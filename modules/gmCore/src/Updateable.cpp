@@ -1,8 +1,15 @@
-
 #include <gmCore/Updateable.hh>
 
+#include <gmCore/Console.hh>
+#include <gmCore/FrameArena.hh>
+#include <gmCore/JobSystem.hh>
+#include <gmCore/Profiler.hh>
+
 #include <map>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 BEGIN_NAMESPACE_GMCORE;
 
@@ -12,11 +19,46 @@ struct Updateable::Impl {
   ~Impl();
 
   Updateable * _this;
+  int priority;
+
+  std::vector<Updateable*> dependencies;
+
+  std::atomic<clock::duration> update_duration = clock::duration::zero();
+
+  void update(clock::time_point time, size_t frame);
 
   static void updateAll(clock::time_point time, size_t frame);
 
   static std::multimap<int, Updateable*>& getList();
 
+  /**
+     Updateables sorted into waves that may be called concurrently,
+     each wave after the previous. The waves are rebuilt when
+     updateables are added or removed, or dependencies change.
+
+     Updateables destroyed while updateAll is running, for example by
+     another updateable, are kept in the removed list until it
+     returns, so that these are skipped instead of being called.
+  */
+  struct Schedule {
+    std::mutex lock;
+    bool dirty = true;
+    std::vector<std::vector<Updateable*>> waves;
+    bool updating = false;
+    std::vector<Updateable*> removed;
+    std::weak_ptr<JobSystem> job_system;
+    std::atomic<clock::duration> duration = clock::duration::zero();
+  };
+
+  static Schedule& getSchedule();
+
+  static void buildSchedule(Schedule &schedule);
+
+  /**
+     Returns true if the specified scheduled updateable has not been
+     destroyed during the current updateAll.
+  */
+  static bool isAlive(Schedule &schedule, Updateable *item);
 };
 
 Updateable::Updateable(int priority)
@@ -28,17 +70,25 @@ Updateable::~Updateable() {
 }
 
 Updateable::Impl::Impl(Updateable * _this, int priority)
-  : _this(_this) {
+  : _this(_this), priority(priority) {
+  std::lock_guard<std::mutex> guard(getSchedule().lock);
   // Negate to sort highest priority first
   getList().insert(std::make_pair(-priority, _this));
+  getSchedule().dirty = true;
 }
 
 Updateable::Impl::~Impl() {
+  std::lock_guard<std::mutex> guard(getSchedule().lock);
   for(auto it = getList().begin(); it != getList().end(); )
-    if (_this == it->second)
+    if (_this == it->second) {
       it = getList().erase(it++);
-    else
+    } else {
+      auto &deps = it->second->_impl->dependencies;
+      deps.erase(std::remove(deps.begin(), deps.end(), _this), deps.end());
       ++it;
+    }
+  getSchedule().dirty = true;
+  if (getSchedule().updating) getSchedule().removed.push_back(_this);
 }
 
 void Updateable::updateAll(clock::time_point time,
@@ -50,14 +100,151 @@ void Updateable::updateAll(clock::time_point time,
   Impl::updateAll(time, *frame);
 }
 
+void Updateable::setJobSystem(std::shared_ptr<JobSystem> job_system) {
+  std::lock_guard<std::mutex> guard(Impl::getSchedule().lock);
+  Impl::getSchedule().job_system = job_system;
+}
+
+void Updateable::runsAfter(Updateable *other) {
+  if (other == nullptr || other == this) return;
+
+  if (other->_impl->priority < _impl->priority) {
+    GM_WRN("Updateable", "Cannot run after updateable with lower priority ("
+           << other->_impl->priority << " < " << _impl->priority
+           << "); ignoring dependency.");
+    return;
+  }
+  if (other->_impl->priority > _impl->priority)
+    // Fulfilled by the priority order
+    return;
+
+  std::lock_guard<std::mutex> guard(Impl::getSchedule().lock);
+  auto &deps = _impl->dependencies;
+  if (std::find(deps.begin(), deps.end(), other) != deps.end()) return;
+  deps.push_back(other);
+  Impl::getSchedule().dirty = true;
+}
+
+Updateable::clock::duration Updateable::getUpdateDuration() {
+  return _impl->update_duration;
+}
+
+Updateable::clock::duration Updateable::getUpdateAllDuration() {
+  return Impl::getSchedule().duration;
+}
+
 std::multimap<int, Updateable*>& Updateable::Impl::getList() {
   static std::multimap<int, Updateable*> list;
   return list;
 }
 
+Updateable::Impl::Schedule& Updateable::Impl::getSchedule() {
+  static Schedule schedule;
+  return schedule;
+}
+
+bool Updateable::Impl::isAlive(Schedule &schedule, Updateable *item) {
+  std::lock_guard<std::mutex> guard(schedule.lock);
+  return std::find(schedule.removed.begin(), schedule.removed.end(), item) ==
+    schedule.removed.end();
+}
+
+void Updateable::Impl::buildSchedule(Schedule &schedule) {
+
+  schedule.waves.clear();
+
+  auto &list = getList();
+  for (auto tier_begin = list.begin(); tier_begin != list.end(); ) {
+    auto tier_end = list.upper_bound(tier_begin->first);
+
+    // Kahn's algorithm over the tier, keeping instantiation order
+    std::vector<Updateable*> remaining;
+    for (auto it = tier_begin; it != tier_end; ++it)
+      remaining.push_back(it->second);
+
+    std::vector<Updateable*> done;
+    while (!remaining.empty()) {
+
+      std::vector<Updateable*> wave;
+      for (auto item : remaining) {
+        auto &deps = item->_impl->dependencies;
+        if (std::all_of(deps.begin(), deps.end(), [&](Updateable *dep) {
+              return std::find(done.begin(), done.end(), dep) != done.end();
+            }))
+          wave.push_back(item);
+      }
+
+      if (wave.empty()) {
+        GM_WRN("Updateable", "Cyclic dependencies among " << remaining.size()
+               << " updateables with priority " << -tier_begin->first
+               << "; calling these in instantiation order.");
+        for (auto item : remaining)
+          schedule.waves.push_back({ item });
+        break;
+      }
+
+      for (auto item : wave)
+        remaining.erase(std::find(remaining.begin(), remaining.end(), item));
+      done.insert(done.end(), wave.begin(), wave.end());
+      schedule.waves.push_back(std::move(wave));
+    }
+
+    tier_begin = tier_end;
+  }
+
+  GM_DBG2("Updateable", "Scheduled " << list.size() << " updateables in "
+          << schedule.waves.size() << " waves");
+  schedule.dirty = false;
+}
+
+void Updateable::Impl::update(clock::time_point time, size_t frame) {
+  GM_PROFILE_SCOPE(typeid(*_this));
+  auto start = clock::now();
+  _this->update(time, frame);
+  update_duration = clock::now() - start;
+}
+
 void Updateable::Impl::updateAll(clock::time_point time, size_t frame) {
-  for (auto it : getList())
-    it.second->update(time, frame);
+  GM_PROFILE_SCOPE("Updateable::updateAll");
+  auto start = clock::now();
+
+  Schedule &schedule = getSchedule();
+  std::shared_ptr<JobSystem> job_system;
+  {
+    std::lock_guard<std::mutex> guard(schedule.lock);
+    if (schedule.dirty) buildSchedule(schedule);
+    job_system = schedule.job_system.lock();
+    schedule.updating = true;
+    schedule.removed.clear();
+  }
+
+  for (auto &wave : schedule.waves) {
+
+    if (!job_system || wave.size() == 1) {
+      for (auto item : wave)
+        if (isAlive(schedule, item))
+          item->_impl->update(time, frame);
+      continue;
+    }
+
+    JobSystem::TaskGroup group(*job_system);
+    for (auto item : wave)
+      group.run([&schedule, item, time, frame] {
+        if (isAlive(schedule, item))
+          item->_impl->update(time, frame);
+      });
+    group.wait();
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(schedule.lock);
+    schedule.updating = false;
+    schedule.removed.clear();
+  }
+
+  schedule.duration = clock::now() - start;
+
+  FrameArena::nextFrame();
 }
 
 END_NAMESPACE_GMCORE;
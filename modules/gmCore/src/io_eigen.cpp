@@ -193,4 +193,131 @@ std::istream& operator>> (std::istream &in, Eigen::Matrix4f &m) {
 
 END_NAMESPACE_GRAMODS;
 
+BEGIN_NAMESPACE_GMCORE;
+
+bool FastParser<Eigen::Vector2f>::parse(std::string_view str,
+                                        Eigen::Vector2f &v) {
+  float values[2];
+  const char *ptr = str.data();
+  if (!detail::parse_numbers<float, 2>(ptr, str.data() + str.size(), values))
+    return false;
+  v = Eigen::Vector2f(values[0], values[1]);
+  return true;
+}
+
+bool FastParser<Eigen::Vector3f>::parse(std::string_view str,
+                                        Eigen::Vector3f &v) {
+  float values[3];
+  const char *ptr = str.data();
+  if (!detail::parse_numbers<float, 3>(ptr, str.data() + str.size(), values))
+    return false;
+  v = Eigen::Vector3f(values[0], values[1], values[2]);
+  return true;
+}
+
+bool FastParser<Eigen::Quaternionf>::parse(std::string_view str,
+                                           Eigen::Quaternionf &q) {
+
+  const char *ptr = str.data();
+  const char *last = str.data() + str.size();
+
+  detail::skip_space(ptr, last);
+  const char *key_end = ptr;
+  while (key_end != last && !detail::is_space(*key_end)) ++key_end;
+
+  constexpr std::string_view keyword = "quaternion";
+  std::string_view key(ptr, key_end - ptr);
+
+  float values[4];
+
+  if (std::equal(key.begin(), key.end(), keyword.begin(), keyword.end(),
+                 [](unsigned char a, char b) { return std::tolower(a) == b; })) {
+
+    ptr = key_end;
+    if (!detail::parse_numbers<float, 4>(ptr, last, values))
+      return false;
+
+  } else {
+
+    // The stream operator reads w from the key, ignoring trailing
+    // characters, and only the remaining values from the stream
+    const char *key_ptr = ptr;
+    if (!detail::parse_number(key_ptr, key_end, values[0]))
+      return false;
+
+    ptr = key_end;
+    if (!detail::parse_numbers<float, 3>(ptr, last, values + 1))
+      return false;
+  }
+
+  q = Eigen::Quaternionf(values[0], values[1], values[2], values[3]);
+
+  if (fabsf(1 - q.norm()) > 1e-5)
+    GM_WRN("operator>>(std::istream, Eigen::Quaternionf)",
+           "Parsed quaternion is not unit (pure rotation).");
+
+  return true;
+}
+
+bool FastParser<Eigen::Matrix3f>::parse(std::string_view str,
+                                        Eigen::Matrix3f &m) {
+  float a[9];
+  const char *ptr = str.data();
+  if (!detail::parse_numbers<float, 9>(ptr, str.data() + str.size(), a))
+    return false;
+  m << a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8];
+  return true;
+}
+
+bool FastParser<Eigen::Matrix4f>::parse(std::string_view str,
+                                        Eigen::Matrix4f &m) {
+
+  float a[16];
+  size_t count = 0;
+
+  const char *ptr = str.data();
+  const char *last = str.data() + str.size();
+  while (count < 16 && detail::parse_number(ptr, last, a[count])) ++count;
+
+  if (count < 9) return false;
+
+  // Leave partial matrices followed by other data to the istream
+  // operator, to get its exact behavior
+  detail::skip_space(ptr, last);
+  if (count < 16 && ptr != last) return false;
+
+  if (count < 12) {
+    GM_DBG3("eigen",
+            "Read 9 values, but not 12, from stream into Eigen::Matrix4f");
+    m <<
+      a[0], a[1], a[2], 0.f,
+      a[3], a[4], a[5], 0.f,
+      a[6], a[7], a[8], 0.f,
+      0.f, 0.f, 0.f, 1.f;
+    return true;
+  }
+
+  if (count < 16) {
+    GM_DBG3("eigen",
+            "Read 12 values, but not 16, from stream into Eigen::Matrix4f");
+    m <<
+      a[0], a[1], a[2], a[3],
+      a[4], a[5], a[6], a[7],
+      a[8], a[9], a[10], a[11],
+      0.f, 0.f, 0.f, 1.f;
+    return true;
+  }
+
+  GM_DBG3("eigen", "Read 16 values from stream into Eigen::Matrix4f");
+  m <<
+    a[0], a[1], a[2], a[3],
+    a[4], a[5], a[6], a[7],
+    a[8], a[9], a[10], a[11],
+    a[12], a[13], a[14], a[15];
+
+  return true;
+}
+
+END_NAMESPACE_GMCORE;
+
 #endif
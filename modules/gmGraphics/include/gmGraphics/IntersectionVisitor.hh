@@ -8,6 +8,7 @@
 #include <gmGraphics/Node.hh>
 
 #include <Eigen/Eigen>
+#include <memory_resource>
 #include <vector>
 
 BEGIN_NAMESPACE_GMGRAPHICS;
@@ -54,15 +55,31 @@ struct IntersectionVisitor : Node::TransformStackVisitor {
 
   /**
      Create a visitor for checking for intersection against the
-     specified line.
+     specified line. The traversal stacks are allocated from the
+     specified memory resource, by default the calling thread's frame
+     arena, while the intersections may be kept beyond the current
+     frame.
   */
-  IntersectionVisitor(IntersectionLine line) : line(line) {}
+  IntersectionVisitor(IntersectionLine line,
+                      std::pmr::memory_resource *resource =
+                      gmCore::FrameArena::get())
+    : TransformStackVisitor(resource),
+      line(line),
+      node_path(resource) {}
 
   /**
      This method is called for each visited objects.
   */
   void apply(gmCore::Object *node) override;
 
+  /**
+     This method is called for each node in a flat traversal.
+
+     @see Node::acceptFlat
+  */
+  void applyFlat(const Node::FlatGraph &graph, size_t idx,
+                 const Eigen::Affine3f &transform) override;
+
   /**
      This is the list of intersections found by the visitors during
      traversal.
@@ -70,8 +87,8 @@ struct IntersectionVisitor : Node::TransformStackVisitor {
   std::vector<Intersection> intersections;
 
 protected:
-  const IntersectionLine line;               //< Line checked against
-  std::vector<gmGraphics::Node *> node_path; //< Current path
+  const IntersectionLine line;                    //< Line checked against
+  std::pmr::vector<gmGraphics::Node *> node_path; //< Current path
 };
 
 END_NAMESPACE_GMGRAPHICS;
@@ -8,12 +8,18 @@
 #include <gmGraphics/IntersectionLine.hh>
 
 #include <gmCore/Object.hh>
+#include <gmCore/FrameArena.hh>
 
 #include <Eigen/Eigen>
+#include <memory_resource>
 #include <vector>
 
 BEGIN_NAMESPACE_GMGRAPHICS;
 
+class Renderer;
+class Transform;
+class TrackedTransform;
+
 /**
    The scenegraph node base.
 */
@@ -23,6 +29,42 @@ public:
 
   typedef std::vector<std::shared_ptr<Node>> list;
 
+  /**
+     Depth first flattening of the scenegraph below a node, following
+     the children of Group nodes, with the type of each node resolved
+     once. The root of a scenegraph keeps its flattening and rebuilds
+     it only after the structure of a scenegraph has changed, so that
+     visitors applied several times per frame, such as for near-far
+     estimation and rendering of each eye, iterate over an array
+     instead of recursing and type checking every node.
+
+     @see Node::acceptFlat
+  */
+  struct FlatGraph {
+
+    /**
+       One node of the flattened scenegraph.
+    */
+    struct Entry {
+      Node *node;
+      Renderer *renderer;        //< The node, if it is a Renderer
+      Transform *transform;      //< The node, if it is a Transform
+      TrackedTransform *tracked; //< The node, if it is a TrackedTransform
+      size_t end;                //< Index after the last descendant
+      size_t parent;             //< Index of the parent, or npos for the root
+    };
+
+    /**
+       The nodes in depth first order, starting with the root.
+    */
+    std::vector<Entry> entries;
+
+    /**
+       The structure version that the flattening was made from.
+    */
+    size_t version = 0;
+  };
+
   /**
      Base for Visitor:s that need to track the space transform through
      traversal.
@@ -32,13 +74,29 @@ public:
      stack member before calling the standard apply method. Sub
      classes can then access the stack member, e.g. stack.back() to
      find the transform of the current 3D space.
+
+     The stack is by default allocated from the calling thread's
+     frame arena, since visitors are typically short lived.
   */
   struct TransformStackVisitor : Visitor {
 
+    TransformStackVisitor(std::pmr::memory_resource *resource =
+                          gmCore::FrameArena::get())
+      : stack(1, Eigen::Affine3f::Identity(), resource) {}
+
     void apply(gmCore::Object *node) override { Visitor::apply(node); }
     void apply(Object *node, const Eigen::Affine3f &transform);
 
-    std::vector<Eigen::Affine3f> stack {Eigen::Affine3f::Identity()};
+    /**
+       Called by Node::acceptFlat for each node of a flattened
+       scenegraph, with the transform of the node's space, instead of
+       apply. Visitors that should support flat traversal must
+       override this method; the default implementation does nothing.
+    */
+    virtual void applyFlat(const FlatGraph &graph, size_t idx,
+                           const Eigen::Affine3f &transform) {}
+
+    std::pmr::vector<Eigen::Affine3f> stack;
   };
 
   /**
@@ -59,6 +117,9 @@ public:
 
     void apply(gmCore::Object *node) override;
 
+    void applyFlat(const FlatGraph &graph, size_t idx,
+                   const Eigen::Affine3f &transform) override;
+
     /**
        Makes positive, expands with epsilon and returns near and far
        values, iff the near and far values are reasonable.
@@ -68,6 +129,9 @@ public:
     const Camera camera;
     float near = std::numeric_limits<float>::max();
     float far = std::numeric_limits<float>::min();
+
+  private:
+    void expand(Renderer *renderer, const Eigen::Affine3f &transform);
   };
 
   /**
@@ -88,6 +152,9 @@ public:
 
     void apply(gmCore::Object *node) override;
 
+    void applyFlat(const FlatGraph &graph, size_t idx,
+                   const Eigen::Affine3f &transform) override;
+
     const Camera camera;
   };
 
@@ -99,11 +166,35 @@ public:
     return {};
   }
 
+  /**
+     Applies the visitor to the flattened scenegraph below, and
+     including, this node, starting in the space at the top of the
+     visitor's stack. The visitor's applyFlat is called instead of
+     apply, and objects that are not Node children of a Group, such
+     as textures, are not visited.
+
+     Only the structure of the scenegraph is cached. Transforms are
+     read during each traversal.
+  */
+  void acceptFlat(TransformStackVisitor *visitor);
+
+  /**
+     Marks all flattened scenegraphs as outdated. This must be called
+     by nodes that change their set of children.
+  */
+  static void invalidateFlatGraphs();
+
   /**
      Returns the default key, in Configuration, for the
      Object.
   */
   virtual std::string getDefaultKey() override { return "node"; }
+
+private:
+
+  const FlatGraph & getFlatGraph();
+
+  std::unique_ptr<FlatGraph> flat_graph;
 };
 
 END_NAMESPACE_GMGRAPHICS;
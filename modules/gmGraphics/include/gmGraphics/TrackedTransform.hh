@@ -6,6 +6,8 @@
 
 #include <gmTrack/TrackerBase.hh>
 
+#include <functional>
+
 BEGIN_NAMESPACE_GMGRAPHICS;
 
 /**
@@ -38,6 +40,13 @@ public:
 
   void accept(Visitor *visitor) override;
 
+  /**
+     Calls the specified function with the transform of each
+     currently tracked pose, i.e. for each instance of the children.
+  */
+  void forEachTransform(
+      const std::function<void(const Eigen::Affine3f &)> &func);
+
   GM_OFI_DECLARE;
 
 private:
@@ -17,12 +17,14 @@ Group::~Group() {}
 
 void Group::addNode(std::shared_ptr<Node> node) {
   _impl->nodes.push_back(node);
+  invalidateFlatGraphs();
 }
 
 void Group::removeNode(std::shared_ptr<Node> node) {
   _impl->nodes.erase(
       std::remove(_impl->nodes.begin(), _impl->nodes.end(), node),
       _impl->nodes.end());
+  invalidateFlatGraphs();
 }
 
 void Group::removeNode(size_t idx) {
@@ -31,6 +33,7 @@ void Group::removeNode(size_t idx) {
         "Specified index " << idx << " is out of bounds ("
                            << _impl->nodes.size() << " items available)"));
   _impl->nodes.erase(_impl->nodes.begin() + idx);
+  invalidateFlatGraphs();
 }
 
 std::vector<std::shared_ptr<Node>> Group::getNodes() {
@@ -1,6 +1,8 @@
 
 #include <gmGraphics/IntersectionVisitor.hh>
 
+#include <algorithm>
+
 BEGIN_NAMESPACE_GMGRAPHICS;
 
 void IntersectionVisitor::apply(gmCore::Object *obj) {
@@ -15,7 +17,7 @@ void IntersectionVisitor::apply(gmCore::Object *obj) {
       auto pos = line.getPosition(r);
       intersections.push_back({/*.local_position = */ pos,
                                /*.position = */ stack.back() * pos,
-                               /*.node_path = */ node_path});
+                               /*.node_path = */ { node_path.begin(), node_path.end() }});
     }
 
     node_path.pop_back();
@@ -24,4 +26,27 @@ void IntersectionVisitor::apply(gmCore::Object *obj) {
   }
 }
 
+void IntersectionVisitor::applyFlat(const Node::FlatGraph &graph, size_t idx,
+                                    const Eigen::Affine3f &transform) {
+
+  auto line = this->line.getInSpace(transform);
+  auto ratio_list = graph.entries[idx].node->getIntersections(line);
+  if (ratio_list.empty()) return;
+
+  // The path is rebuilt from the parent indices only upon a hit
+  std::pmr::vector<gmGraphics::Node *> path(node_path, node_path.get_allocator());
+  size_t path_begin = path.size();
+  for (size_t pidx = idx; pidx < graph.entries.size(); pidx = graph.entries[pidx].parent)
+    path.push_back(graph.entries[pidx].node);
+  std::reverse(path.begin() + path_begin, path.end());
+
+  intersections.reserve(intersections.size() + ratio_list.size());
+  for (auto r : ratio_list) {
+    auto pos = line.getPosition(r);
+    intersections.push_back({/*.local_position = */ pos,
+                             /*.position = */ transform * pos,
+                             /*.node_path = */ { path.begin(), path.end() }});
+  }
+}
+
 END_NAMESPACE_GMGRAPHICS;
@@ -1,11 +1,76 @@
 
 #include <gmGraphics/Node.hh>
 
+#include <gmGraphics/Group.hh>
 #include <gmGraphics/Renderer.hh>
+#include <gmGraphics/TrackedTransform.hh>
 #include <gmGraphics/Transform.hh>
 
+#include <atomic>
+
 BEGIN_NAMESPACE_GMGRAPHICS;
 
+namespace {
+
+  std::atomic<size_t> &getGraphVersion() {
+    static std::atomic<size_t> version = 1;
+    return version;
+  }
+
+  void flatten(Node *node, size_t parent, std::vector<Node::FlatGraph::Entry> &entries) {
+    size_t idx = entries.size();
+    entries.push_back({ node,
+                        dynamic_cast<Renderer *>(node),
+                        dynamic_cast<Transform *>(node),
+                        dynamic_cast<TrackedTransform *>(node),
+                        0,
+                        parent });
+    if (auto *group = dynamic_cast<Group *>(node))
+      for (auto &child : group->getNodes())
+        if (child) flatten(child.get(), idx, entries);
+    entries[idx].end = entries.size();
+  }
+
+  void traverseFlat(const Node::FlatGraph &graph,
+                    size_t begin,
+                    size_t end,
+                    const Eigen::Affine3f &base,
+                    Node::TransformStackVisitor *visitor) {
+
+    // Spaces of the enclosing transforms, with the index after their
+    // last descendant
+    std::pmr::vector<std::pair<size_t, Eigen::Affine3f>> spaces(
+        gmCore::FrameArena::get());
+    spaces.emplace_back(end, base);
+
+    for (size_t idx = begin; idx < end;) {
+      while (spaces.back().first <= idx) spaces.pop_back();
+      const Node::FlatGraph::Entry &entry = graph.entries[idx];
+
+      if (entry.tracked) {
+        // Visited once for every currently tracked pose
+        Eigen::Affine3f parent = spaces.back().second;
+        entry.tracked->forEachTransform([&](const Eigen::Affine3f &transform) {
+          Eigen::Affine3f space = parent * transform;
+          visitor->applyFlat(graph, idx, space);
+          traverseFlat(graph, idx + 1, entry.end, space, visitor);
+        });
+        idx = entry.end;
+        continue;
+      }
+
+      if (entry.transform) {
+        Eigen::Affine3f space = spaces.back().second * entry.transform->getTransform();
+        visitor->applyFlat(graph, idx, space);
+        if (entry.end > idx + 1) spaces.emplace_back(entry.end, space);
+      } else {
+        visitor->applyFlat(graph, idx, spaces.back().second);
+      }
+      ++idx;
+    }
+  }
+}
+
 void Node::TransformStackVisitor::apply(Object *node,
                                         const Eigen::Affine3f &transform) {
   stack.push_back(stack.back() * transform);
@@ -16,16 +81,26 @@ void Node::TransformStackVisitor::apply(Object *node,
 void Node::NearFarVisitor::apply(gmCore::Object *node) {
   TransformStackVisitor::apply(node);
 
-  if (auto *renderer = dynamic_cast<Renderer *>(node)) {
+  if (auto *renderer = dynamic_cast<Renderer *>(node))
+    expand(renderer, stack.back());
+}
 
-    float n = std::numeric_limits<float>::max();
-    float f = std::numeric_limits<float>::min();
+void Node::NearFarVisitor::applyFlat(const FlatGraph &graph, size_t idx,
+                                     const Eigen::Affine3f &transform) {
+  if (auto *renderer = graph.entries[idx].renderer)
+    expand(renderer, transform);
+}
 
-    renderer->getNearFar(camera, stack.back(), n, f);
+void Node::NearFarVisitor::expand(Renderer *renderer,
+                                  const Eigen::Affine3f &transform) {
 
-    near = std::min(near, n);
-    far = std::max(far, f);
-  }
+  float n = std::numeric_limits<float>::max();
+  float f = std::numeric_limits<float>::min();
+
+  renderer->getNearFar(camera, transform, n, f);
+
+  near = std::min(near, n);
+  far = std::max(far, f);
 }
 
 std::optional<std::pair<float, float>>
@@ -50,4 +125,31 @@ void Node::RenderVisitor::apply(gmCore::Object *node) {
     renderer->render(camera, stack.back());
 }
 
+void Node::RenderVisitor::applyFlat(const FlatGraph &graph, size_t idx,
+                                    const Eigen::Affine3f &transform) {
+  if (auto *renderer = graph.entries[idx].renderer)
+    renderer->render(camera, transform);
+}
+
+void Node::acceptFlat(TransformStackVisitor *visitor) {
+  const FlatGraph &graph = getFlatGraph();
+  traverseFlat(graph, 0, graph.entries.size(), visitor->stack.back(), visitor);
+}
+
+void Node::invalidateFlatGraphs() {
+  ++getGraphVersion();
+}
+
+const Node::FlatGraph &Node::getFlatGraph() {
+  size_t version = getGraphVersion();
+  if (flat_graph && flat_graph->version == version) return *flat_graph;
+
+  if (!flat_graph) flat_graph = std::make_unique<FlatGraph>();
+  flat_graph->entries.clear();
+  flatten(this, std::numeric_limits<size_t>::max(), flat_graph->entries);
+  flat_graph->version = version;
+
+  return *flat_graph;
+}
+
 END_NAMESPACE_GMGRAPHICS;
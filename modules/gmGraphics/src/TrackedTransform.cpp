@@ -16,7 +16,8 @@ GM_OFI_POINTER2(TrackedTransform, poseTracker, gmTrack::PoseTracker, addPoseTrac
 struct TrackedTransform::Impl : gmCore::Updateable {
 
   void update(clock::time_point t, size_t frame) override;
-  void accept(Node *node, Visitor *visitor);
+  void forEachTransform(
+      const std::function<void(const Eigen::Affine3f &)> &func);
 
   clock::time_point now_time;
   clock::duration hysteresis =
@@ -48,30 +49,40 @@ void TrackedTransform::addPoseTracker(
 }
 
 void TrackedTransform::accept(Visitor *visitor) {
-  _impl->accept(this, visitor);
-}
-
-void TrackedTransform::Impl::accept(Node *node, Visitor *visitor) {
   auto *ts_visitor = dynamic_cast<Node::TransformStackVisitor *>(visitor);
   if (!ts_visitor) {
-    visitor->apply(node);
+    visitor->apply(this);
     return;
   }
 
+  _impl->forEachTransform([this, ts_visitor](const Eigen::Affine3f &transform) {
+    ts_visitor->apply(this, transform);
+  });
+}
+
+void TrackedTransform::forEachTransform(
+    const std::function<void(const Eigen::Affine3f &)> &func) {
+  _impl->forEachTransform(func);
+}
+
+void TrackedTransform::Impl::forEachTransform(
+    const std::function<void(const Eigen::Affine3f &)> &func) {
+
   for (auto &tracker : pose_trackers) {
     auto state = tracker->get();
     if (!state) continue;
 
     if (keys.empty()) {
-      for (const auto as : state.value()) {
+      for (const auto &as : state.value()) {
         if (now_time - as.second.time > hysteresis) continue;
-        ts_visitor->apply(node, as.second.value.asMatrix());
+        func(as.second.value.asMatrix());
       }
     } else {
-      for (const auto key : keys)
-        if (state->contains(key) &&
-            now_time - state->at(key).time <= hysteresis)
-          ts_visitor->apply(node, state->at(key).value.asMatrix());
+      for (const auto &key : keys) {
+        auto it = state->find(key);
+        if (it != state->end() && now_time - it->second.time <= hysteresis)
+          func(it->second.value.asMatrix());
+      }
     }
   }
 }
@@ -21,7 +21,7 @@ void ViewBase::renderFullPipeline(ViewSettings settings) {
 
 void ViewBase::ViewSettings::renderNodes(Camera camera) {
   Node::NearFarVisitor nf_visitor(camera);
-  for (auto &node : nodes) node->accept(&nf_visitor);
+  for (auto &node : nodes) node->acceptFlat(&nf_visitor);
 
   auto near_far = nf_visitor.getNearFar();
   if (!near_far) {
@@ -35,7 +35,7 @@ void ViewBase::ViewSettings::renderNodes(Camera camera) {
 
   camera.setNearFar(near_far->first, near_far->second);
   Node::RenderVisitor r_visitor(camera);
-  for (auto &node : nodes) node->accept(&r_visitor);
+  for (auto &node : nodes) node->acceptFlat(&r_visitor);
 }
 
 void ViewBase::populateViewSettings(ViewSettings &settings) {
@@ -2,6 +2,8 @@
 #include <gmGraphics/Window.hh>
 #include <gmGraphics/View.hh>
 
+#include <gmCore/Profiler.hh>
+
 #include <GL/glew.h>
 #include <GL/gl.h>
 
@@ -19,6 +21,8 @@ GM_OFI_POINTER2(Window, view, gmGraphics::View, addView);
 Window::Window() {}
 
 void Window::renderFullPipeline(ViewSettings settings) {
+  GM_PROFILE_SCOPE("Window::renderFullPipeline");
+
   populateViewSettings(settings);
 
   makeGLContextCurrent();
@@ -83,6 +83,24 @@ public:
   */
   std::vector<double> getValue(const std::vector<double> &inval) const;
 
+  /**
+     Estimates the polynomial results for a batch of inputs, without
+     allocating memory per input.
+
+     This method calls estimateCoefficients (if necessary). Once the
+     coefficients have been estimated it may be called concurrently
+     from multiple threads.
+
+     @param[in] in_values Contiguous inputs, count times the input
+     dimensionality.
+
+     @param[out] out_values Contiguous outputs, count times the output
+     dimensionality.
+
+     @param[in] count Number of inputs to evaluate.
+  */
+  void getValues(const double *in_values, double *out_values, size_t count) const;
+
   /**
      Estimates the polynomial Jacobian from the specified input.
 
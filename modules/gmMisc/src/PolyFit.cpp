@@ -25,6 +25,7 @@ struct PolyFit::Impl {
   polco estimateCoefficients();
 
   std::vector<double> getValue(const std::vector<double> &inval) const;
+  void getValues(const double *in_values, double *out_values, size_t count) const;
   Eigen::MatrixXd getJacobian(const std::vector<double> &in_values) const;
   double getDerivative(double inval) const;
 
@@ -210,6 +211,57 @@ PolyFit::Impl::getValue(const std::vector<double> &in_values) const {
   return res;
 }
 
+void PolyFit::getValues(const double *in_values,
+                        double *out_values,
+                        size_t count) const {
+  _impl->getValues(in_values, out_values, count);
+}
+
+void PolyFit::Impl::getValues(const double *in_values,
+                              double *out_values,
+                              size_t count) const {
+
+  if (!coeffs) const_cast<Impl *>(this)->estimateCoefficients();
+  const polco &C = *coeffs;
+
+  // Powers of each input, [ 1, x, x², ... ] for each dimension, and
+  // their expansion, reused for all inputs
+  std::vector<double> comp(IDIM * (ORD + 1));
+  std::vector<double> comp_val(COE);
+
+  for (size_t in_idx = 0; in_idx < count; ++in_idx) {
+
+    const double *in = in_values + in_idx * IDIM;
+    double *out = out_values + in_idx * ODIM;
+
+    for (size_t idim = 0; idim < IDIM; ++idim) {
+      double *vals = comp.data() + idim * (ORD + 1);
+      vals[0] = 1.0;
+      for (size_t ord_idx = 0; ord_idx < ORD; ++ord_idx)
+        vals[ord_idx + 1] = vals[ord_idx] * in[idim];
+    }
+
+    // Same order as getValue, expanding backwards in place since
+    // each expansion only reads elements before the ones it writes
+    size_t size = 1;
+    comp_val[0] = 1.0;
+    for (size_t idim = 0; idim < IDIM; ++idim) {
+      const double *vals = comp.data() + idim * (ORD + 1);
+      for (size_t c_idx = ORD + 1; c_idx-- > 0;)
+        for (size_t p_idx = size; p_idx-- > 0;)
+          comp_val[c_idx * size + p_idx] = vals[c_idx] * comp_val[p_idx];
+      size *= ORD + 1;
+    }
+
+    for (size_t odim = 0; odim < ODIM; ++odim) {
+      double value = 0.0;
+      for (size_t idx = 0; idx < COE; ++idx)
+        value += comp_val[idx] * C(odim, idx);
+      out[odim] = value;
+    }
+  }
+}
+
 Eigen::MatrixXd
 PolyFit::getJacobian(const std::vector<double> &in_values) const {
   return _impl->getJacobian(in_values);
@@ -3,6 +3,7 @@
 
 #include <gmNetwork/SyncNode.hh>
 #include <gmCore/Console.hh>
+#include <gmCore/Profiler.hh>
 
 BEGIN_NAMESPACE_GMNETWORK;
 
@@ -52,6 +53,8 @@ void RunSync::wait() {
 
 void RunSync::Impl::wait(RunSync * run_sync) {
 
+  GM_PROFILE_SCOPE("RunSync::wait");
+
   size_t local_peer_idx = run_sync->getLocalPeerIdx();
 
   std::unique_lock<std::mutex> guard(impl_lock);
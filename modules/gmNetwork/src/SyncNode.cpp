@@ -6,6 +6,7 @@
 #include <gmCore/InvalidArgument.hh>
 #include <gmCore/Console.hh>
 #include <gmCore/Stringify.hh>
+#include <gmCore/Profiler.hh>
 
 #include <unordered_map>
 #include <limits>
@@ -347,6 +348,8 @@ void SyncNode::Impl::Peer::connect() {
 void SyncNode::Impl::Peer::on_connect(std::error_code ec,
                                       asio::ip::tcp::endpoint) {
 
+  GM_PROFILE_SCOPE("SyncNode::on_connect");
+
   std::unique_lock<std::mutex> guard(peer_lock);
 
   if (ec) {
@@ -406,6 +409,8 @@ void SyncNode::Impl::Peer::on_data
  std::shared_ptr<std::vector<char>> read_buffer,
  std::size_t length) {
 
+  GM_PROFILE_SCOPE("SyncNode::on_data");
+
   if (ec) {
 
     std::unique_lock<std::mutex> guard(peer_lock);
@@ -623,6 +628,8 @@ void SyncNode::Impl::Peer::sendMessage(Protocol::Message mess) {
 void SyncNode::Impl::Peer::on_write(std::error_code ec,
                                     std::size_t length) {
 
+  GM_PROFILE_SCOPE("SyncNode::on_write");
+
   std::unique_lock<std::mutex> guard(peer_lock);
 
   if (ec) {
@@ -685,6 +692,8 @@ void SyncNode::Impl::Peer::reset_timers() {
 
 void SyncNode::Impl::Peer::on_pingpong_timeout() {
 
+  GM_PROFILE_SCOPE("SyncNode::on_pingpong_timeout");
+
   if (!socket.is_open()) return;
 
   setup_pingpong_timer();
@@ -715,6 +724,8 @@ void SyncNode::Impl::Peer::on_pingpong_timeout() {
 
 void SyncNode::Impl::Peer::on_timeout_timeout() {
 
+  GM_PROFILE_SCOPE("SyncNode::on_timeout_timeout");
+
   if (!socket.is_open()) return;
 
   if (timeout_timer.expiry() > asio::steady_timer::clock_type::now()) {
@@ -826,6 +837,8 @@ void SyncNode::Impl::accept() {
 
 void SyncNode::Impl::on_accept(std::error_code ec, asio::ip::tcp::socket socket) {
 
+  GM_PROFILE_SCOPE("SyncNode::on_accept");
+
   if (ec) {
     GM_WRN("SyncNode", local_peer_idx << " Incoming connection problem (" << ec.message() << ")");
     accept();
@@ -29,6 +29,7 @@ class ArucoGridBoard : public ArucoBoard {
 public:
 
   ArucoGridBoard();
+  ~ArucoGridBoard();
 
   /**
      Set the number of columns of markers to track. Default is 1.
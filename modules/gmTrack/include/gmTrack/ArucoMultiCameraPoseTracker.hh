@@ -0,0 +1,99 @@
+#ifndef GRAMODS_TRACK_ARUCOMULTICAMERAPOSETRACKER
+#define GRAMODS_TRACK_ARUCOMULTICAMERAPOSETRACKER
+
+#include <gmTrack/config.hh>
+
+#ifdef gramods_ENABLE_OpenCV_objdetect
+
+#include <gmTrack/ArucoPoseTracker.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   Pose tracker that fuses the poses of boards seen by several
+   cameras, each tracked by its own ArucoPoseTracker.
+
+   The markers in the image of each camera are detected in the
+   detection thread of its ArucoPoseTracker, and its board poses are
+   estimated in parallel.
+   The cameras should be given their poses (see
+   ArucoPoseTracker::setCameraPosition) and the same key, so that a
+   board seen by several cameras is reported with the same key by
+   each of them. The poses of each key are then merged, weighted by
+   the inverse square of their reprojection error, so that a camera
+   with a closer or clearer view of a board dominates its pose.
+
+   ~~~~~{.xml}
+   <ArucoMultiCameraPoseTracker>
+     <ArucoPoseTracker key="/room" cameraPosition="2 2.5 0"
+                       cameraOrientation="ypr 1.57 -0.5 0"
+                       cameraConfigurationFile="camera0.yaml">
+       <OpenCvVideoCapture cameraId="0"/>
+       <ArucoGridBoard DEF="BOARD" dictionary="4X4_100" columns="3" rows="5"
+                       markerSize="0.011" markerSeparation="0.004"/>
+     </ArucoPoseTracker>
+     <ArucoPoseTracker key="/room" cameraPosition="-2 2.5 0"
+                       cameraOrientation="ypr -1.57 -0.5 0"
+                       cameraConfigurationFile="camera1.yaml">
+       <OpenCvVideoCapture cameraId="1"/>
+       <ArucoGridBoard USE="BOARD"/>
+     </ArucoPoseTracker>
+   </ArucoMultiCameraPoseTracker>
+   ~~~~~
+*/
+class ArucoMultiCameraPoseTracker : public PoseTracker {
+
+public:
+
+  ArucoMultiCameraPoseTracker();
+  virtual ~ArucoMultiCameraPoseTracker();
+
+  /**
+     Adds the tracker of one camera.
+
+     \gmXmlTag{gmTrack,ArucoMultiCameraPoseTracker,poseTracker}
+  */
+  void addPoseTracker(std::shared_ptr<ArucoPoseTracker> tracker);
+
+  /**
+     Sets the smallest reprojection error, in pixels, to weight a
+     pose by, so that a near perfect fit does not completely override
+     other cameras. Default is 0.1.
+
+     \gmXmlTag{gmTrack,ArucoMultiCameraPoseTracker,minReprojectionError}
+  */
+  void setMinReprojectionError(double e);
+
+  /**
+     Returns the combined reprojection error, in pixels, of each pose
+     in the state last returned by get. This is lower for poses seen
+     by more cameras.
+  */
+  std::map<std::string, double> getReprojectionErrors();
+
+  /**
+     @see TrackerBase::get
+  */
+  std::optional<State> get() override;
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
+#endif
@@ -6,6 +6,9 @@
 
 #ifdef gramods_ENABLE_OpenCV_objdetect
 
+// Required before gmCore/OFactory.hh for some compilers
+#include <gmCore/io_eigen.hh>
+
 #include <gmCore/OFactory.hh>
 
 #include <gmTrack/TrackerBase.hh>
@@ -13,6 +16,8 @@
 #include <gmTrack/ArucoBoard.hh>
 #include <gmTrack/OpenCvVideoCapture.hh>
 
+#include <map>
+
 BEGIN_NAMESPACE_GMTRACK;
 
 /**
@@ -21,12 +26,35 @@ BEGIN_NAMESPACE_GMTRACK;
    This class configures as an Updateable with a priority of
    10. Either Updateable::updateAll or update must be called at even
    intervals. This is done automatically by gm-load.
+
+   Markers are by default detected in a detection thread, that takes
+   over each new frame from the video source and hands the estimated
+   poses back to the update without locking, so that the detection
+   does not stall the frame. The poses are stamped with the time the
+   frame was captured, not the time they were picked up.
+
+   The markers of a board that was found in the previous frame are
+   searched for only in the part of the image where the board is
+   expected, i.e. around the board's previous projection. The full
+   image is searched when a board is lost, and when the expected
+   boards cover most of the image.
+
+   The pose of a board found in the previous frame is refined from
+   its previous pose, and may optionally be estimated from corners
+   tracked from the previous frame, without detecting the markers at
+   all. Poses that deviate from the board's motion can be rejected as
+   outliers.
+
+   The markers of different dictionaries are detected, and the poses
+   of the boards estimated, in parallel using the shared
+   gmCore::JobSystem.
 */
 class ArucoPoseTracker : public PoseTracker {
 
 public:
 
   ArucoPoseTracker();
+  ~ArucoPoseTracker();
 
   //void setCornerRefineMethod(std::string m);
   //void setCornerRefineMethod(cv::aruco::CornerRefineMethod m);
@@ -85,6 +113,95 @@ public:
   */
   void setRefindMarkers(bool on);
 
+  /**
+     Sets whether to detect markers in a detection thread. This
+     cannot be changed after the detection has started. Default is
+     true.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,threaded}
+  */
+  void setThreaded(bool on);
+
+  /**
+     Set to true to search for the markers of boards that were found
+     in the previous frame only in the part of the image where they
+     are expected. Default is true.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,useRoi}
+  */
+  void setUseRoi(bool on);
+
+  /**
+     Sets the margin to add around the expected region of a board, as
+     a fraction of the size of the region. A larger margin allows
+     faster motion between frames. Default is 0.5.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,roiMargin}
+  */
+  void setRoiMargin(float margin);
+
+  /**
+     Sets the position of the camera, in the coordinates that the
+     poses of the boards are reported in. This is not used when
+     tracking the camera. Default is origin.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,cameraPosition}
+  */
+  void setCameraPosition(Eigen::Vector3f p);
+
+  /**
+     Sets the orientation of the camera, in the coordinates that the
+     poses of the boards are reported in. This is not used when
+     tracking the camera. Default is identity.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,cameraOrientation}
+  */
+  void setCameraOrientation(Eigen::Quaternionf q);
+
+  /**
+     Sets the maximum number of consecutive frames to track the
+     corners of a found board, instead of detecting its markers. The
+     corners are tracked with sub-pixel precision from where the
+     board is expected, and the markers are detected again when the
+     tracked corners do not fit the board. Default is 0, i.e. markers
+     are detected in every frame.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,cornerTrackingFrames}
+  */
+  void setCornerTrackingFrames(size_t n);
+
+  /**
+     Sets the maximum mean reprojection error, in pixels, of a pose
+     refined from the previous frame or estimated from tracked
+     corners. Poses with larger error are estimated again from
+     scratch. Default is 2.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,maxReprojectionError}
+  */
+  void setMaxReprojectionError(double e);
+
+  /**
+     Sets the maximum distance, in board units, between the estimated
+     position of a board and the position expected from its motion.
+     Poses that deviate more are rejected as outliers, unless this
+     happens for several frames in a row. Default is 0, i.e. no
+     rejection.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,maxPositionDeviation}
+  */
+  void setMaxPositionDeviation(double d);
+
+  /**
+     Sets the maximum angle, in radians, between the estimated
+     orientation of a board and the orientation expected from its
+     motion. Poses that deviate more are rejected as outliers, unless
+     this happens for several frames in a row. Default is 0, i.e. no
+     rejection.
+
+     \gmXmlTag{gmTrack,ArucoPoseTracker,maxOrientationDeviation}
+  */
+  void setMaxOrientationDeviation(double d);
+
   /**
      Sets the (cv::FileStorage) file to read camera parameters from.
 
@@ -92,6 +209,29 @@ public:
   */
   void setCameraConfigurationFile(std::filesystem::path file);
 
+  /**
+     Returns the mean reprojection error, in pixels, of each pose in
+     the state last returned by get.
+  */
+  std::map<std::string, double> getReprojectionErrors();
+
+  /**
+     Returns the time, in seconds, from the capture of a frame to the
+     estimation of its poses, averaged over the latest frames.
+  */
+  double getLatency();
+
+  /**
+     Returns the fraction of frames in which any board was found,
+     averaged over the latest frames.
+  */
+  double getDetectionRate();
+
+  /**
+     Returns the number of frames that markers were detected in.
+  */
+  size_t getFrameCount();
+
   /**
      @see TrackerBase::get
   */
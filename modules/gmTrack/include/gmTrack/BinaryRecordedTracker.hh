@@ -0,0 +1,25 @@
+#ifndef GRAMODS_TRACK_BINARYRECORDEDTRACKER
+#define GRAMODS_TRACK_BINARYRECORDEDTRACKER
+
+#include <gmTrack/RecordedTracker.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This tracker of binary (bool) data plays back states recorded by a
+   TrackerRecorder.
+
+   @see RecordedTracker
+*/
+class BinaryRecordedTracker : public RecordedTracker<bool> {
+
+public:
+
+  GM_OFI_DECLARE;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef GRAMODS_TRACK_FILTEREDPOSETRACKER
+#define GRAMODS_TRACK_FILTEREDPOSETRACKER
+
+#include <gmTrack/TrackerBase.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This decorator filters the poses of a specified tracker, to reduce
+   jitter, using either a One-Euro filter or a constant-velocity
+   Kalman filter per key.
+
+   The One-Euro filter is a low-pass filter with a cut-off frequency
+   that increases with the speed, so that slow motion is smoothed
+   while fast motion is followed with little lag. The Kalman filter
+   estimates the position and velocity from the expected measurement
+   error and acceleration, and follows steady motion without lag.
+
+   Orientations are filtered the same way as positions, in the
+   tangent space of the rotation, with speeds and errors in radians.
+
+   All keys are filtered in one batch, with the filter states stored
+   per component, so that several keys are processed per SIMD
+   instruction. Filtering adds latency, which is reported by
+   getLatency so that jitter can be traded against responsiveness.
+*/
+class FilteredPoseTracker : public PoseTracker {
+
+public:
+
+  FilteredPoseTracker();
+  virtual ~FilteredPoseTracker();
+
+  /**
+     Sets the tracker to filter the poses of.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,poseTracker}
+  */
+  void setPoseTracker(std::shared_ptr<PoseTracker> tracker);
+
+  /**
+     Sets the filter to use, either oneEuro or kalman. Default is
+     oneEuro.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,filter}
+  */
+  void setFilter(std::string name);
+
+  /**
+     Sets the cut-off frequency, in Hz, of the One-Euro filter when
+     not moving. Lower values give less jitter but more lag at low
+     speeds. Default is 1.0.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,minCutoff}
+  */
+  void setMinCutoff(double frequency);
+
+  /**
+     Sets how much the cut-off frequency of the One-Euro filter
+     increases with the speed, in Hz per tracker unit per second for
+     positions and Hz per radian per second for orientations. Higher
+     values give less lag at high speeds. Default is 1.0.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,beta}
+  */
+  void setBeta(double beta);
+
+  /**
+     Sets the cut-off frequency, in Hz, of the speed estimation of the
+     One-Euro filter. Default is 1.0.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,derivativeCutoff}
+  */
+  void setDerivativeCutoff(double frequency);
+
+  /**
+     Sets the expected position error, in tracker units, of the
+     Kalman filter. Default is 0.001.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,positionError}
+  */
+  void setPositionError(double e);
+
+  /**
+     Sets the expected orientation error, in radians, of the Kalman
+     filter. Default is 0.005.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,orientationError}
+  */
+  void setOrientationError(double e);
+
+  /**
+     Sets the expected acceleration, in tracker units per second
+     squared, of the Kalman filter. Lower values give less jitter but
+     slower response to changes in the motion. Default is 1.0.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,acceleration}
+  */
+  void setAcceleration(double a);
+
+  /**
+     Sets the expected angular acceleration, in radians per second
+     squared, of the Kalman filter. Default is 5.0.
+
+     \gmXmlTag{gmTrack,FilteredPoseTracker,angularAcceleration}
+  */
+  void setAngularAcceleration(double a);
+
+  /**
+     Returns the latency, in seconds, currently added by the filter,
+     as the largest over the keys of the latest state. This is the
+     time constant of the response to a sudden change, i.e. the sample
+     interval times (1 - g) / g where g is the gain of the latest
+     sample, which for the One-Euro filter is also the lag behind
+     steady motion. Returns zero before any sample has been filtered.
+  */
+  double getLatency();
+
+  /**
+     @see TrackerBase::get
+  */
+  std::optional<State> get() override;
+
+  /**
+     @see TrackerBase::getFlat
+  */
+  bool getFlat(FlatState &state) override;
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
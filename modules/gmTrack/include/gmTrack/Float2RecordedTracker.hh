@@ -0,0 +1,26 @@
+#ifndef GRAMODS_TRACK_FLOAT2RECORDEDTRACKER
+#define GRAMODS_TRACK_FLOAT2RECORDEDTRACKER
+
+#include <gmTrack/RecordedTracker.hh>
+
+#include <gmCore/io_float.hh>
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This tracker of gmCore::float2 (std::array<float, 2>) data plays
+   back states recorded by a TrackerRecorder.
+
+   @see RecordedTracker
+*/
+class Float2RecordedTracker : public RecordedTracker<gmCore::float2> {
+
+public:
+
+  GM_OFI_DECLARE;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef GRAMODS_TRACK_FLOATRECORDEDTRACKER
+#define GRAMODS_TRACK_FLOATRECORDEDTRACKER
+
+#include <gmTrack/RecordedTracker.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This tracker of float data plays back states recorded by a
+   TrackerRecorder.
+
+   @see RecordedTracker
+*/
+class FloatRecordedTracker : public RecordedTracker<float> {
+
+public:
+
+  GM_OFI_DECLARE;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef GRAMODS_TRACK_FUSEDPOSETRACKER
+#define GRAMODS_TRACK_FUSEDPOSETRACKER
+
+#include <gmTrack/TrackerBase.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This tracker fuses the poses of several pose trackers that track
+   the same keys, for example an optical tracker together with OpenVR
+   or VRPN trackers, into one pose per key.
+
+   The sources must report their poses in the same space and with the
+   same keys, which can be arranged with RegisteredPoseTracker and
+   PoseKeyChangeTracker, respectively.
+
+   Each pose is fused at the time of the latest sample of its key
+   from any source. The samples of the other sources are aligned to
+   that time by extrapolating from their velocity, and weighted by
+   the confidence of their source and by how stale they are, so that
+   a source that stops reporting a key smoothly loses its
+   influence. Positions are fused as the weighted mean and
+   orientations as the normalized weighted sum, which is close to the
+   weighted mean for the similar orientations of tracking the same
+   object.
+
+   The fusion state is kept per source and key in tables indexed by
+   key id, so that fusing costs constant time per source and key,
+   without allocation once all keys have been seen.
+*/
+class FusedPoseTracker : public PoseTracker {
+
+public:
+
+  FusedPoseTracker();
+  virtual ~FusedPoseTracker();
+
+  /**
+     Adds a tracker to fuse the poses of.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,poseTracker}
+  */
+  void addPoseTracker(std::shared_ptr<PoseTracker> tracker);
+
+  /**
+     Adds the confidence of the next source, in the order that the
+     sources are added, as a relative weight. Sources without a
+     specified confidence have confidence 1.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,confidence}
+  */
+  void addConfidence(float confidence);
+
+  /**
+     Adds the latency, in seconds, of the next source, in the order
+     that the sources are added. The latency is subtracted from the
+     time of each sample of the source, to align it with the other
+     sources when the sample time is that of reception rather than of
+     capture, e.g. for camera based tracking. Default is 0.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,latency}
+  */
+  void addLatency(double seconds);
+
+  /**
+     Sets the time, in seconds, over which the weight of a sample
+     decreases by a factor e as it gets older than the latest sample
+     of the same key. Default is 0.02.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,staleness}
+  */
+  void setStaleness(double seconds);
+
+  /**
+     Sets the maximum age, in seconds, of a sample compared to the
+     latest sample of the same key, for it to be included in the
+     fusion. Default is 0.1.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,maxAge}
+  */
+  void setMaxAge(double seconds);
+
+  /**
+     Sets the maximum time, in seconds, to extrapolate a sample to
+     align it with the latest sample of the same key. Default is
+     0.02.
+
+     \gmXmlTag{gmTrack,FusedPoseTracker,maxExtrapolation}
+  */
+  void setMaxExtrapolation(double seconds);
+
+  /**
+     @see TrackerBase::get
+  */
+  std::optional<State> get() override;
+
+  /**
+     @see TrackerBase::getFlat
+  */
+  bool getFlat(FlatState &state) override;
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
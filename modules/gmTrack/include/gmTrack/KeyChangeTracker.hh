@@ -12,6 +12,12 @@ BEGIN_NAMESPACE_GMTRACK;
 /**
    This tracker reports states from one or more other trackers of the
    same type, optionally also changing the key of one or more states.
+
+   If more than one tracker provides the same key, after the change,
+   then the sample of the tracker added first is reported. The
+   mappings are compiled into a key id translation per tracker, as
+   keys first appear, so that reading the state costs no key lookups
+   or allocations beyond those of the output.
 */
 template<class TYPE> class KeyChangeTracker : public TrackerBase<TYPE> {
 
@@ -49,6 +55,11 @@ public:
      @see TrackerBase::get
   */
   std::optional<typename TrackerBase<TYPE>::State> get() override;
+
+  /**
+     @see TrackerBase::getFlat
+  */
+  bool getFlat(typename TrackerBase<TYPE>::FlatState &state) override;
 };
 
 END_NAMESPACE_GMTRACK;
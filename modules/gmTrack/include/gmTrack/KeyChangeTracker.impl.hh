@@ -7,21 +7,75 @@
 #include <gmCore/RunOnce.hh>
 #include <gmCore/Updateable.hh>
 
+#include <limits>
+#include <mutex>
 #include <optional>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 BEGIN_NAMESPACE_GMTRACK;
 
 template<class TYPE> struct KeyChangeTracker<TYPE>::Impl {
 
-  Impl() {}
-
-  std::optional<typename TrackerBase<TYPE>::State> get();
+  typedef typename TrackerBase<TYPE>::State State;
+  typedef typename TrackerBase<TYPE>::FlatState FlatState;
 
-  typedef std::unordered_map<std::string, std::string> mappings_t;
-  mappings_t mappings;
+  Impl() {}
 
-  std::vector<std::shared_ptr<TrackerBase<TYPE>>> trackers;
+  std::optional<State> get();
+  bool getFlat(FlatState &state);
+
+  /**
+     Reads the states of all trackers, renamed and merged, into the
+     specified state.
+  */
+  bool merge(FlatState &state);
+
+  /// Marks keys that have not yet been seen from a tracker
+  static constexpr TrackerKey::Id NO_KEY = std::numeric_limits<TrackerKey::Id>::max();
+
+  /**
+     A tracker to read from, with a buffer for its state and the
+     translation from its key ids to the ids reported, indexed by
+     the former. Entries are filled in as keys first appear.
+  */
+  struct Source {
+    std::shared_ptr<TrackerBase<TYPE>> tracker;
+    FlatState state;
+    std::vector<TrackerKey::Id> translation;
+  };
+
+  /**
+     Returns the reported id of the specified key of the specified
+     tracker, compiling the translation if the key is new.
+  */
+  TrackerKey::Id translate(Source &source, TrackerKey::Id key);
+
+  /**
+     Where a reported key was last written in the merged state, so
+     that duplicates are found in constant time. The slot is valid
+     only if its generation is that of the current merge.
+  */
+  struct Slot {
+    uint64_t generation = 0;
+    size_t position = 0;
+  };
+
+  std::unordered_map<TrackerKey::Id, TrackerKey::Id> mappings;
+
+  std::vector<Source> sources;
+
+  /// Slots and key names, indexed by reported key id
+  std::vector<Slot> slots;
+  std::vector<const std::string *> names;
+  uint64_t generation = 0;
+
+  /// Merged state reused by get
+  FlatState merged;
+
+  /// Guards the buffers above, since trackers may be read from
+  /// several threads, e.g. by Updateables updated in parallel
+  std::mutex lock;
 };
 
 template<class TYPE>
@@ -32,13 +86,19 @@ template<class TYPE> KeyChangeTracker<TYPE>::~KeyChangeTracker() {}
 
 template<class TYPE>
 void KeyChangeTracker<TYPE>::addMapping(gmCore::string2 m) {
-  _impl->mappings[m[0]] = m[1];
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->mappings[TrackerKey::getId(m[0])] = TrackerKey::getId(m[1]);
+
+  // Recompile the translations as keys appear
+  for (auto &source : _impl->sources)
+    source.translation.clear();
 }
 
 template<class TYPE>
 void KeyChangeTracker<TYPE>::addTracker(
     std::shared_ptr<TrackerBase<TYPE>> ptr) {
-  _impl->trackers.push_back(ptr);
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->sources.push_back({ptr, {}, {}});
 }
 
 template<class TYPE>
@@ -48,34 +108,86 @@ KeyChangeTracker<TYPE>::get() {
 }
 
 template<class TYPE>
-std::optional<typename TrackerBase<TYPE>::State>
-KeyChangeTracker<TYPE>::Impl::get() {
+bool KeyChangeTracker<TYPE>::getFlat(typename TrackerBase<TYPE>::FlatState &state) {
+  return _impl->getFlat(state);
+}
 
-  std::optional<typename TrackerBase<TYPE>::State> acc;
+template<class TYPE>
+TrackerKey::Id KeyChangeTracker<TYPE>::Impl::translate(Source &source,
+                                                       TrackerKey::Id key) {
 
-  for (auto ptr : trackers) {
+  if (key < source.translation.size() && source.translation[key] != NO_KEY)
+    return source.translation[key];
 
-    auto state = ptr->get();
-    if (!state) continue;
+  auto it = mappings.find(key);
+  TrackerKey::Id reported = it == mappings.end() ? key : it->second;
 
-    typename TrackerBase<TYPE>::State rstate;
+  if (key >= source.translation.size())
+    source.translation.resize(key + 1, NO_KEY);
+  source.translation[key] = reported;
 
-    for (const auto &s : state.value()) {
-      if (mappings.contains(s.first)) {
-        rstate[mappings.at(s.first)] = s.second;
-      } else {
-        rstate[s.first] = s.second;
-      }
-    }
+  if (reported >= slots.size()) {
+    slots.resize(reported + 1);
+    names.resize(reported + 1, nullptr);
+  }
+  if (!names[reported])
+    names[reported] = &TrackerKey::getName(reported);
+
+  return reported;
+}
+
+template<class TYPE>
+bool KeyChangeTracker<TYPE>::Impl::merge(FlatState &state) {
+
+  state.clear();
+  ++generation;
+
+  bool has_state = false;
 
-    if (!acc) [[unlikely]] {
-      acc = rstate;
-    } else {
-      acc->merge(rstate);
+  for (auto &source : sources) {
+
+    if (!source.tracker->getFlat(source.state)) continue;
+    has_state = true;
+
+    // Keys already provided by an earlier tracker are kept, while
+    // the last sample of this tracker wins
+    const size_t earlier_count = state.size();
+
+    for (const auto &ks : source.state) {
+      TrackerKey::Id key = translate(source, ks.key);
+      Slot &slot = slots[key];
+
+      if (slot.generation != generation) {
+        slot = {generation, state.size()};
+        state.push_back({key, ks.sample});
+      } else if (slot.position >= earlier_count) {
+        state[slot.position].sample = ks.sample;
+      }
     }
   }
 
-  return acc;
+  return has_state;
+}
+
+template<class TYPE>
+std::optional<typename TrackerBase<TYPE>::State>
+KeyChangeTracker<TYPE>::Impl::get() {
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (!merge(merged)) return std::nullopt;
+
+  State state;
+  state.reserve(merged.size());
+  for (const auto &ks : merged)
+    state.emplace(*names[ks.key], ks.sample);
+
+  return state;
+}
+
+template<class TYPE>
+bool KeyChangeTracker<TYPE>::Impl::getFlat(FlatState &state) {
+  std::lock_guard<std::mutex> guard(lock);
+  return merge(state);
 }
 
 END_NAMESPACE_GMTRACK;
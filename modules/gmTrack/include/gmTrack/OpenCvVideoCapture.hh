@@ -20,6 +20,14 @@ BEGIN_NAMESPACE_GMTRACK;
    This class configures as an Updateable with a priority of
    20. Either Updateable::updateAll or update must be called at even
    intervals. This is done automatically by gm-load.
+
+   Cameras are by default read by a capture thread, that continuously
+   grabs and decodes frames and hands the latest over to the update
+   without locking, so that a blocking camera read does not stall the
+   frame. Each update then picks up the newest captured frame, which
+   is what retrieve provides until the next update. Video files are
+   read one frame per update, to keep their playback in step with the
+   updates.
 */
 class OpenCvVideoCapture
   : public gmCore::Object,
@@ -29,6 +37,7 @@ class OpenCvVideoCapture
 public:
 
   OpenCvVideoCapture();
+  ~OpenCvVideoCapture();
 
   /**
      Sets the video file to read from.
@@ -125,11 +134,42 @@ public:
   */
   void setBackend(std::string b);
 
+  /**
+     Sets whether to read the camera in a capture thread. This has no
+     effect on video files. Default is true.
+
+     \gmXmlTag{gmTrack,OpenCvVideoCapture,threaded}
+  */
+  void setThreaded(bool on);
+
   /**
      Updates the video capture to read off the next frame.
   */
   void update(gmCore::Updateable::clock::time_point, size_t);
 
+  /**
+     Returns the time when the frame provided by retrieve was
+     captured.
+  */
+  gmCore::Updateable::clock::time_point getFrameTime();
+
+  /**
+     Returns the number of frames captured.
+  */
+  size_t getCaptureCount();
+
+  /**
+     Returns the number of captured frames that were replaced by a
+     newer frame before being picked up by an update.
+  */
+  size_t getDropCount();
+
+  /**
+     Returns the age, in seconds, of the frame provided by retrieve
+     at the update that picked it up.
+  */
+  double getLatency();
+
   /**
      Retrieve the latest read image captured.
 
@@ -0,0 +1,111 @@
+#ifndef GRAMODS_TRACK_POSEHISTORYTRACKER
+#define GRAMODS_TRACK_POSEHISTORYTRACKER
+
+#include <gmTrack/TrackerBase.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This decorator keeps a history of the poses of a specified
+   tracker, so that the pose of each key can be looked up at any time
+   within the history, for example to align poses with camera frames
+   or to late-latch the pose at the expected display time.
+
+   The history of each key is a ring of fixed capacity, written when
+   the tracker reports a new sample. Poses between samples are
+   interpolated, linearly in position and by slerp in orientation,
+   and poses after the latest sample are extrapolated up to a
+   maximum time.
+
+   The history is written by the update and can be read by any
+   number of other threads at the same time, without locking. A
+   reader that is overtaken by the writer in the part of the ring it
+   reads treats those samples as missing.
+
+   This class configures as an Updateable with a priority of 0, so
+   that trackers with positive priority, such as VRPN trackers, are
+   sampled after their update. Either Updateable::updateAll or update
+   must be called at even intervals. This is done automatically by
+   gm-load.
+*/
+class PoseHistoryTracker : public PoseTracker {
+
+public:
+
+  PoseHistoryTracker();
+  virtual ~PoseHistoryTracker();
+
+  /**
+     Sets the tracker to keep a history of.
+
+     \gmXmlTag{gmTrack,PoseHistoryTracker,poseTracker}
+  */
+  void setPoseTracker(std::shared_ptr<PoseTracker> tracker);
+
+  /**
+     Sets the number of samples to keep per key. This cannot be
+     changed after the first update. Default is 256.
+
+     \gmXmlTag{gmTrack,PoseHistoryTracker,capacity}
+  */
+  void setCapacity(size_t n);
+
+  /**
+     Sets the maximum number of keys to keep a history of. Keys seen
+     after this number has been reached are ignored. This cannot be
+     changed after the first update. Default is 32.
+
+     \gmXmlTag{gmTrack,PoseHistoryTracker,keyCapacity}
+  */
+  void setKeyCapacity(size_t n);
+
+  /**
+     Sets the maximum time, in seconds, to extrapolate poses past the
+     latest sample. Poses requested later than this are extrapolated
+     only up to this time. Default is 0.05.
+
+     \gmXmlTag{gmTrack,PoseHistoryTracker,maxExtrapolation}
+  */
+  void setMaxExtrapolation(double seconds);
+
+  /**
+     Reads off the pose of the specified key at the specified time,
+     interpolated or extrapolated from the history. This may be
+     called from any thread.
+
+     @returns False if the key has no history at the time.
+  */
+  bool getAt(const std::string &key, clock::time_point time,
+             gmCore::Pose &pose);
+
+  /**
+     Reads off the poses of all keys at the specified time. Keys
+     without history at the time are left out. This may be called
+     from any thread.
+  */
+  std::optional<State> getAt(clock::time_point time);
+
+  /**
+     @see TrackerBase::get
+  */
+  std::optional<State> get() override;
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
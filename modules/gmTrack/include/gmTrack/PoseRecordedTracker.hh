@@ -0,0 +1,26 @@
+#ifndef GRAMODS_TRACK_POSERECORDEDTRACKER
+#define GRAMODS_TRACK_POSERECORDEDTRACKER
+
+#include <gmTrack/RecordedTracker.hh>
+
+#include <gmCore/io_eigen.hh>
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This tracker of gmCore::Pose data plays back states recorded by a
+   TrackerRecorder.
+
+   @see RecordedTracker
+*/
+class PoseRecordedTracker : public RecordedTracker<gmCore::Pose> {
+
+public:
+
+  GM_OFI_DECLARE;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
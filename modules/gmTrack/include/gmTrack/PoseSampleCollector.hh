@@ -72,8 +72,10 @@ public:
 
   /**
      Set the maximum positional distance from the average allowed for
-     a sample to be included in the average. Default is -1 meaning
-     that all samples are included.
+     a sample to be included in the average. The first few samples
+     are checked against their median and later samples against the
+     running average as they are taken. Default is -1 meaning that
+     all samples are included.
   */
   void setInlierThreshold(float r);
 
@@ -87,11 +89,45 @@ public:
 
   /**
      Set the maximum orientational distance (in radians) from the
-     average allowed for a sample to be included in the
-     average. Default is -1 meaning that all samples are included.
+     average allowed for a sample to be included in the average,
+     checked the same way as the positional distance. Default is -1
+     meaning that all samples are included.
   */
   void setOrientationInlierThreshold(float r);
 
+  /**
+     Returns true while the button is held and samples are being
+     collected.
+  */
+  bool isCollecting() const;
+
+  /**
+     Returns the number of samples included in the current, or
+     latest, tracker position. The first few samples are counted as
+     included until there are enough of them to be checked for
+     outliers.
+  */
+  size_t getSampleCount() const;
+
+  /**
+     Returns the number of samples rejected as outliers from the
+     current, or latest, tracker position.
+  */
+  size_t getRejectedSampleCount() const;
+
+  /**
+     Returns the root mean square distance of the included samples
+     from their mean, for the current, or latest, tracker position.
+  */
+  float getPositionDeviation() const;
+
+  /**
+     Returns the root mean square angle, in radians, of the included
+     samples from their average orientation, for the current, or
+     latest, tracker position.
+  */
+  float getOrientationDeviation() const;
+
   /**
      Returns the current list of tracker positions.
   */
@@ -10,8 +10,51 @@ struct PoseSampleCollector::Impl {
   std::vector<Eigen::Vector3f> tracker_positions;
   std::vector<Eigen::Quaternionf> tracker_orientations;
 
-  std::vector<Eigen::Vector3f> sample_positions;
-  std::vector<Eigen::Quaternionf> sample_orientations;
+  /**
+     Streaming statistics of the samples taken for one tracker
+     position, so that memory use does not depend on the number of
+     samples. The position uses Welford's algorithm and the
+     orientation the accumulated outer product of the quaternions,
+     whose dominant eigenvector is their average.
+
+     The first few samples are buffered until there are enough to
+     seed the outlier rejection with their median, so that an early
+     outlier cannot bias the running averages that later samples are
+     checked against.
+  */
+  struct Accumulator {
+    size_t count = 0;
+    size_t rejected_count = 0;
+
+    /// Samples waiting for the seed, at most SEED_SAMPLES
+    std::vector<gmCore::Pose> seed_samples;
+    bool seeded = false;
+    Eigen::Vector3d seed_position = Eigen::Vector3d::Zero();
+    Eigen::Quaterniond seed_orientation = Eigen::Quaterniond::Identity();
+
+    Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+    Eigen::Matrix3d scatter = Eigen::Matrix3d::Zero();
+    Eigen::Matrix4d orientation_scatter = Eigen::Matrix4d::Zero();
+    Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+    double orientation_eigenvalue = 0;
+    double max_position_deviation = 0;
+    double max_orientation_deviation = 0;
+
+    /// Root mean square distance from the mean position
+    double getPositionDeviation() const;
+
+    /// Root mean square angle from the average orientation
+    double getOrientationDeviation() const;
+  };
+
+  /// Samples to buffer for the robust seed of the outlier rejection
+  static constexpr size_t SEED_SAMPLES = 5;
+
+  /// Accepted samples before checking against the running averages
+  /// instead of the seed
+  static constexpr size_t MIN_GATE_SAMPLES = 3;
+
+  Accumulator accumulator;
 
   clock::time_point last_sample_time = clock::time_point::min();
   float samples_per_second = 1;
@@ -22,8 +65,36 @@ struct PoseSampleCollector::Impl {
   float inlier_threshold = -1.f;
   float orientation_inlier_threshold = -1.f;
 
+  virtual ~Impl() = default;
+
   virtual void update(clock::time_point time);
 
+  /**
+     Takes a sample while the button is pressed, buffering it for the
+     seed or checking it against the averages so far.
+  */
+  void collectSample(const gmCore::Pose &pose);
+
+  /**
+     Seeds the outlier rejection with the median of the buffered
+     samples and checks these against it.
+  */
+  void seed();
+
+  /**
+     Checks the specified sample against the seed, or the running
+     averages once these include enough samples, and adds it if it
+     is not an outlier.
+  */
+  void checkSample(const gmCore::Pose &pose);
+
+  /**
+     Adds a sample that has passed the outlier rejection, to be
+     averaged into one tracker position and orientation when the
+     button is released.
+  */
+  virtual void addSample(const gmCore::Pose &pose);
+
   std::shared_ptr<gramods::gmTrack::TrackerSet> tracker_set;
 };
 
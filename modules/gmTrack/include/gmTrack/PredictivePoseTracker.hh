@@ -0,0 +1,112 @@
+#ifndef GRAMODS_TRACK_PREDICTIVEPOSETRACKER
+#define GRAMODS_TRACK_PREDICTIVEPOSETRACKER
+
+#include <gmTrack/TrackerBase.hh>
+
+#include <gmCore/OFactory.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   This decorator predicts the poses of a specified tracker a
+   specified time ahead, to compensate for latency in the rendering
+   and display pipeline, such as the render and scanout time.
+
+   Positions are predicted using the end-fitting adaptive window
+   estimators in gmMisc: a first order estimate (EFFOAW) by default,
+   and higher order polynomials (EFHOAW) if so specified. Orientations
+   are predicted the same way, from the accumulated angular
+   displacement, i.e. by integrating the angular velocity.
+
+   The estimators use the most recent samples that fit the motion
+   within the specified error, so that steady motion is predicted
+   from a longer window and sudden changes are picked up quickly.
+
+   \sa gmMisc::EFFOAW
+   \sa gmMisc::EFHOAW
+*/
+class PredictivePoseTracker : public PoseTracker {
+
+public:
+
+  PredictivePoseTracker();
+  virtual ~PredictivePoseTracker();
+
+  /**
+     Sets the tracker to predict the poses of.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,poseTracker}
+  */
+  void setPoseTracker(std::shared_ptr<PoseTracker> tracker);
+
+  /**
+     Sets the time, in seconds, to predict the poses ahead of the
+     time of their samples. Default is 0.03.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,latency}
+  */
+  void setLatency(double seconds);
+
+  /**
+     Sets the order of the estimation, 1 for linear extrapolation
+     using EFFOAW and higher for polynomial extrapolation using
+     EFHOAW. Default is 1.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,order}
+  */
+  void setOrder(size_t order);
+
+  /**
+     Sets the expected position error, in tracker units, used to
+     choose the number of samples to estimate from. Default is 0.001.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,positionError}
+  */
+  void setPositionError(double e);
+
+  /**
+     Sets the expected orientation error, in radians, used to choose
+     the number of samples to estimate from. Default is 0.005.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,orientationError}
+  */
+  void setOrientationError(double e);
+
+  /**
+     Sets the maximum number of samples to estimate from. Default is
+     10.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,historyLength}
+  */
+  void setHistoryLength(size_t n);
+
+  /**
+     Sets the maximum age, in seconds, of samples to estimate
+     from. Default is 0.2.
+
+     \gmXmlTag{gmTrack,PredictivePoseTracker,historyDuration}
+  */
+  void setHistoryDuration(double seconds);
+
+  /**
+     @see TrackerBase::get
+  */
+  std::optional<State> get() override;
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
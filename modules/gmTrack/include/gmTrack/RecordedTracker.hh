@@ -0,0 +1,38 @@
+#ifndef GRAMODS_TRACK_RECORDEDTRACKER
+#define GRAMODS_TRACK_RECORDEDTRACKER
+
+#include <gmTrack/TimeSampleTracker.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   Plays back the states recorded by a TrackerRecorder, at the
+   original timing or at a different speed. The recording is memory
+   mapped and read only as it is played back, so that recordings of
+   any length can be used to run and benchmark a tracking pipeline
+   without the tracking hardware.
+
+   This is a TimeSampleTracker configured from a TimeSampleFile.
+
+   ~~~~~{.xml}
+   <PoseRecordedTracker file="session.gmts" speed="4" loop="false"/>
+   ~~~~~
+*/
+template<class TYPE> class RecordedTracker : public TimeSampleTracker<TYPE> {
+
+public:
+
+  /**
+     Sets the recording to play back.
+
+     \gmXmlNodeAttr{gmTrack,BinaryRecordedTracker,file}
+     \gmXmlNodeAttr{gmTrack,FloatRecordedTracker,file}
+     \gmXmlNodeAttr{gmTrack,Float2RecordedTracker,file}
+     \gmXmlNodeAttr{gmTrack,PoseRecordedTracker,file}
+  */
+  void setFile(std::filesystem::path file) { this->setSampleFile(file); }
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
@@ -79,6 +79,11 @@ public:
   */
   std::optional<State> get() override;
 
+  /**
+     @see PoseTracker::getFlat
+  */
+  bool getFlat(FlatState &state) override;
+
   /**
      Propagates the specified visitor.
 
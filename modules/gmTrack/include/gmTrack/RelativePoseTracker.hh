@@ -24,6 +24,11 @@ public:
   */
   std::optional<State> get() override;
 
+  /**
+     @see TrackerBase::getFlat
+  */
+  bool getFlat(FlatState &state) override;
+
   /**
      Sets the key in the origin tracker associated with the pose to
      use as origin for the relative pose states. If this is not set,
@@ -0,0 +1,175 @@
+#ifndef GRAMODS_TRACK_TIMESAMPLEFILE
+#define GRAMODS_TRACK_TIMESAMPLEFILE
+
+#include <gmTrack/config.hh>
+
+#include <gmCore/FastParser.hh>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   Memory mapped binary file of timed tracker samples, for playback
+   of long recordings without loading them into memory.
+
+   The file starts with a header holding the magic "GMTS", the format
+   version and the number of numeric components per value (see
+   gmCore::NumericLayout). The header is followed by chunks, each
+   with a dictionary of the keys that have values in the chunk and a
+   number of fixed size records. A record holds a 64 bit float time,
+   in seconds, followed by the components of the value of each key
+   of the chunk, in order, each followed by the age of the value, as
+   32 bit floats. The age is the time, in seconds, from the sample of
+   the value to the record, which is non-zero for keys that were not
+   updated when the record was made. A NaN first component marks a
+   key that has no value in that record. All numbers are in the
+   native byte order and record times must be increasing.
+
+   Since each chunk is complete in itself, a recording that is
+   interrupted loses at most its last chunk.
+*/
+class TimeSampleFile {
+
+public:
+
+  /**
+     Maps the specified file and reads its header, or throws
+     gmCore::InvalidArgument if the file cannot be read as a time
+     sample file.
+  */
+  explicit TimeSampleFile(std::filesystem::path file);
+
+  ~TimeSampleFile();
+
+  /**
+     Returns the keys of all samples in the file. Key indices used
+     with getComponents and getValue refer to this list.
+  */
+  const std::vector<std::string> & getKeys() const;
+
+  /**
+     Returns the number of numeric components of each value.
+  */
+  size_t getComponentCount() const;
+
+  /**
+     Returns the number of records in the file.
+  */
+  size_t size() const;
+
+  /**
+     Returns the time of the specified record.
+  */
+  double getTime(size_t record) const;
+
+  /**
+     Reads the components of the value of the specified key index in
+     the specified record into the specified array.
+
+     @returns False if the key has no value in the record.
+  */
+  bool getComponents(size_t record, size_t key_idx, double *components) const;
+
+  /**
+     Returns the age, in seconds, of the value of the specified key
+     index in the specified record, i.e. the time from its sample to
+     the record, or zero if the key has no value in the record.
+  */
+  double getAge(size_t record, size_t key_idx) const;
+
+  /**
+     Reads the value of the specified key index in the specified
+     record, which must have getComponentCount() components.
+
+     @returns False if the key has no value in the record.
+  */
+  template<class TYPE>
+  bool getValue(size_t record, size_t key_idx, TYPE &value) const {
+    double components[gmCore::NumericLayout<TYPE>::components];
+    if (!getComponents(record, key_idx, components)) return false;
+    gmCore::NumericLayout<TYPE>::assign(components, value);
+    return true;
+  }
+
+  /**
+     Writer of time sample files, record by record. Records are
+     buffered and written one chunk at a time.
+
+     ~~~~~{.cpp}
+     gmTrack::TimeSampleFile::Writer writer("recording.gmts", 7);
+     writer.addValue("head", head_pose);
+     writer.commit(time);
+     ~~~~~
+  */
+  class Writer {
+
+  public:
+
+    /**
+       Creates the specified file and writes the header, or throws
+       gmCore::InvalidArgument if the file cannot be written.
+
+       @param file The file to write.
+       @param components The number of numeric components per value.
+       @param chunk_size The number of records per chunk.
+    */
+    Writer(std::filesystem::path file,
+           size_t components,
+           size_t chunk_size = 256);
+
+    /**
+       Writes remaining records and closes the file.
+    */
+    ~Writer();
+
+    /**
+       Sets the components of the value of the specified key in the
+       record being built, with the age, in seconds, of its sample at
+       the time of the record.
+    */
+    void add(const std::string &key, const float *components, double age = 0.0);
+
+    /**
+       Sets the value of the specified key in the record being built,
+       with the age, in seconds, of its sample at the time of the
+       record.
+    */
+    template<class TYPE>
+    void addValue(const std::string &key, const TYPE &value, double age = 0.0) {
+      constexpr size_t N = gmCore::NumericLayout<TYPE>::components;
+      double numbers[N];
+      float components[N];
+      gmCore::NumericLayout<TYPE>::extract(value, numbers);
+      for (size_t idx = 0; idx < N; ++idx) components[idx] = float(numbers[idx]);
+      add(key, components, age);
+    }
+
+    /**
+       Completes the record being built, with the specified time,
+       which must be later than that of the previous record. Throws
+       gmCore::InvalidArgument otherwise.
+    */
+    void commit(double time);
+
+    /**
+       Writes the completed records as a chunk and flushes the file.
+    */
+    void flush();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+  };
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
@@ -6,6 +6,8 @@
 
 #include <gmCore/OFactory.hh>
 
+#include <filesystem>
+
 BEGIN_NAMESPACE_GMTRACK;
 
 /**
@@ -24,6 +26,10 @@ BEGIN_NAMESPACE_GMTRACK;
    Interpolatable samples (e.g. float) are interpolated between a
    sample and the next, while boolean states are left constant until
    the next sample.
+
+   Long recordings can instead be played back directly from a
+   memory mapped TimeSampleFile, specified with setSampleFile
+   ("sampleFile" in XML).
 */
 template<class TYPE> class TimeSampleTracker : public TrackerBase<TYPE> {
 
@@ -70,6 +76,50 @@ public:
   */
   void addValue(TYPE state);
 
+  /**
+     Sets a TimeSampleFile to play back timed samples from, instead of
+     samples added with addKey, addValue and addTime. The file is
+     memory mapped and its samples are read only when played back.
+     Samples are reported with the age they had when recorded, so
+     that keys that were not updated keep their relative times.
+
+     \gmXmlNodeAttr{gmTrack,BinaryTimeSampleTracker,sampleFile}
+     \gmXmlNodeAttr{gmTrack,FloatTimeSampleTracker,sampleFile}
+     \gmXmlNodeAttr{gmTrack,Float2TimeSampleTracker,sampleFile}
+     \gmXmlNodeAttr{gmTrack,PoseTimeSampleTracker,sampleFile}
+  */
+  void setSampleFile(std::filesystem::path file);
+
+  /**
+     Sets the playback speed of timed samples, as a factor of the
+     sample times. Default is 1.
+
+     \gmXmlNodeAttr{gmTrack,BinaryTimeSampleTracker,speed}
+     \gmXmlNodeAttr{gmTrack,FloatTimeSampleTracker,speed}
+     \gmXmlNodeAttr{gmTrack,Float2TimeSampleTracker,speed}
+     \gmXmlNodeAttr{gmTrack,PoseTimeSampleTracker,speed}
+     \gmXmlNodeAttr{gmTrack,BinaryRecordedTracker,speed}
+     \gmXmlNodeAttr{gmTrack,FloatRecordedTracker,speed}
+     \gmXmlNodeAttr{gmTrack,Float2RecordedTracker,speed}
+     \gmXmlNodeAttr{gmTrack,PoseRecordedTracker,speed}
+  */
+  void setSpeed(double speed);
+
+  /**
+     Sets whether to restart playback of timed samples after the last
+     sample, or to keep reporting the last sample. Default is true.
+
+     \gmXmlNodeAttr{gmTrack,BinaryTimeSampleTracker,loop}
+     \gmXmlNodeAttr{gmTrack,FloatTimeSampleTracker,loop}
+     \gmXmlNodeAttr{gmTrack,Float2TimeSampleTracker,loop}
+     \gmXmlNodeAttr{gmTrack,PoseTimeSampleTracker,loop}
+     \gmXmlNodeAttr{gmTrack,BinaryRecordedTracker,loop}
+     \gmXmlNodeAttr{gmTrack,FloatRecordedTracker,loop}
+     \gmXmlNodeAttr{gmTrack,Float2RecordedTracker,loop}
+     \gmXmlNodeAttr{gmTrack,PoseRecordedTracker,loop}
+  */
+  void setLoop(bool on);
+
   void addKeyValue(std::string key, TYPE value) {
     addKey(key);
     addValue(value);
@@ -1,7 +1,10 @@
 
 #include <gmTrack/TimeSampleTracker.hh>
+#include <gmTrack/TimeSampleFile.hh>
 
 #include <gmCore/Console.hh>
+#include <gmCore/FileResolver.hh>
+#include <gmCore/InvalidArgument.hh>
 #include <gmCore/io_typeid.hh>
 #include <gmCore/PreConditionViolation.hh>
 #include <gmCore/RunOnce.hh>
@@ -30,13 +33,51 @@ template<class TYPE> struct TimeSampleTracker<TYPE>::Impl : gmCore::Updateable {
   size_t timeless_idx = 0;
   std::vector<State> timeless_states;
 
-  struct TimeState {
-    double time;
-    State state;
+  /**
+     Timed values of one key. Values are stored for every sample time,
+     with present set for the times at which the key has a value.
+  */
+  struct Column {
+    std::string key;
+    std::vector<TYPE> values;
+    std::vector<uint8_t> present;
   };
 
   std::optional<std::chrono::steady_clock::time_point> start_time;
-  std::vector<TimeState> timed_states;
+
+  /// Sample times shared by all columns
+  std::vector<double> times;
+  std::vector<Column> columns;
+
+  /// Timed samples played back from file instead of from columns
+  std::unique_ptr<TimeSampleFile> file;
+
+  /// Last played sample index, where the next search starts
+  size_t cursor = 0;
+
+  double speed = 1.0;
+  bool loop = true;
+
+  size_t getSampleCount() const {
+    return file ? file->size() : times.size();
+  }
+  double getSampleTime(size_t idx) const {
+    return file ? file->getTime(idx) : times[idx];
+  }
+  size_t getKeyCount() const {
+    return file ? file->getKeys().size() : columns.size();
+  }
+  const std::string & getKey(size_t key_idx) const {
+    return file ? file->getKeys()[key_idx] : columns[key_idx].key;
+  }
+  bool getValue(size_t idx, size_t key_idx, TYPE &value) const;
+  double getAge(size_t idx, size_t key_idx) const {
+    return file ? file->getAge(idx, key_idx) : 0.0;
+  }
+
+  size_t findSample(double time);
+  void addSampleTime(double time);
+  Column & getColumn(const std::string &key);
 
   std::optional<State> state;
 };
@@ -56,7 +97,7 @@ template<class TYPE> void TimeSampleTracker<TYPE>::Impl::processIncoming() {
     GM_DBG2(GM_STR("TimeSampleTracker<" << demangle(typeid(TYPE)) << ">"),
             "processing 1:N:0 where N = " << incoming_values.size());
 
-    if (!timed_states.empty())
+    if (!times.empty() || file)
       throw gmCore::PreConditionViolation(
           "Cannot add time to timeless states");
 
@@ -70,7 +111,7 @@ template<class TYPE> void TimeSampleTracker<TYPE>::Impl::processIncoming() {
     GM_DBG2(GM_STR("TimeSampleTracker<" << demangle(typeid(TYPE)) << ">"),
             "processing N:N:0 where N = " << incoming_keys.size());
 
-    if (!timed_states.empty())
+    if (!times.empty() || file)
       throw gmCore::PreConditionViolation(
           "Cannot add time to timeless states");
 
@@ -87,17 +128,15 @@ template<class TYPE> void TimeSampleTracker<TYPE>::Impl::processIncoming() {
     if (!timeless_states.empty())
       throw gmCore::PreConditionViolation(
           "Cannot add time to timeless states");
+    if (file)
+      throw gmCore::PreConditionViolation(
+          "Cannot add samples to samples from file");
 
-    for (size_t idx = 0; idx < incoming_keys.size(); ++idx) {
-      if (!timed_states.empty() &&
-          incoming_times.at(idx) <= timed_states.back().time)
-        throw gmCore::PreConditionViolation(GM_STR(
-            "Sample time must be increasing; "
-            << incoming_times.at(idx) << " <= " << timed_states.back().time));
-      timed_states.push_back(
-          {.time = incoming_times.at(idx),
-           .state = State {{incoming_keys.at(0), //
-                            {.value = incoming_values.at(idx)}}}});
+    Column &column = getColumn(incoming_keys.at(0));
+    for (size_t idx = 0; idx < incoming_values.size(); ++idx) {
+      addSampleTime(incoming_times.at(idx));
+      column.values.back() = incoming_values.at(idx);
+      column.present.back() = 1;
     }
 
   } else if (incoming_times.size() > 1 &&
@@ -115,26 +154,22 @@ template<class TYPE> void TimeSampleTracker<TYPE>::Impl::processIncoming() {
     if (!timeless_states.empty())
       throw gmCore::PreConditionViolation(
           "Cannot add time to timeless states");
+    if (file)
+      throw gmCore::PreConditionViolation(
+          "Cannot add samples to samples from file");
 
     for (size_t idx_N = 0; idx_N < N; ++idx_N) {
-      State state;
+      addSampleTime(incoming_times.at(idx_N));
       for (size_t idx_M = 0; idx_M < M; ++idx_M) {
         const auto idx = idx_M + M * idx_N;
-        if (state.contains(incoming_keys.at(idx)))
+        Column &column = getColumn(incoming_keys.at(idx));
+        if (column.present.back())
           throw gmCore::RuntimeException(
               GM_STR("Adding key twice (" << demangle(typeid(TYPE))
                                           << "): " << incoming_keys.at(idx)));
-        state.insert(
-            {incoming_keys.at(idx), {.value = incoming_values.at(idx)}});
+        column.values.back() = incoming_values.at(idx);
+        column.present.back() = 1;
       }
-      if (!timed_states.empty() &&
-          incoming_times.at(idx_N) <= timed_states.back().time)
-        throw gmCore::PreConditionViolation(
-            GM_STR("Sample time must be increasing; "
-                   << incoming_times.at(idx_N)
-                   << " <= " << timed_states.back().time));
-      timed_states.push_back(
-          {.time = incoming_times.at(idx_N), .state = state});
     }
 
   } else {
@@ -150,6 +185,68 @@ template<class TYPE> void TimeSampleTracker<TYPE>::Impl::processIncoming() {
   incoming_times.clear();
 }
 
+template<class TYPE>
+void TimeSampleTracker<TYPE>::Impl::addSampleTime(double time) {
+
+  if (!times.empty() && time <= times.back())
+    throw gmCore::PreConditionViolation(GM_STR(
+        "Sample time must be increasing; " << time << " <= " << times.back()));
+
+  times.push_back(time);
+  for (auto &column : columns) {
+    column.values.emplace_back();
+    column.present.push_back(0);
+  }
+}
+
+template<class TYPE>
+typename TimeSampleTracker<TYPE>::Impl::Column &
+TimeSampleTracker<TYPE>::Impl::getColumn(const std::string &key) {
+
+  for (auto &column : columns)
+    if (column.key == key) return column;
+
+  Column &column = columns.emplace_back();
+  column.key = key;
+  column.values.resize(times.size());
+  column.present.resize(times.size(), 0);
+  return column;
+}
+
+template<class TYPE>
+bool TimeSampleTracker<TYPE>::Impl::getValue(size_t idx,
+                                             size_t key_idx,
+                                             TYPE &value) const {
+  if (file) return file->getValue(idx, key_idx, value);
+
+  const Column &column = columns[key_idx];
+  if (!column.present[idx]) return false;
+  value = column.values[idx];
+  return true;
+}
+
+template<class TYPE>
+size_t TimeSampleTracker<TYPE>::Impl::findSample(double time) {
+
+  const size_t count = getSampleCount();
+
+  // Monotonic playback stays at the cursor or moves one step ahead
+  for (size_t idx = cursor; idx < std::min(cursor + 2, count); ++idx)
+    if (getSampleTime(idx) <= time &&
+        (idx + 1 == count || time < getSampleTime(idx + 1)))
+      return cursor = idx;
+
+  // Otherwise find the last sample not after the time
+  size_t first = 0, last = count;
+  while (first < last) {
+    size_t middle = first + (last - first) / 2;
+    if (getSampleTime(middle) <= time) first = middle + 1;
+    else last = middle;
+  }
+
+  return cursor = first > 0 ? first - 1 : 0;
+}
+
 template<class TYPE>
 void TimeSampleTracker<TYPE>::Impl::update(clock::time_point now,
                                            size_t frame) {
@@ -158,7 +255,9 @@ void TimeSampleTracker<TYPE>::Impl::update(clock::time_point now,
       !incoming_times.empty()) [[unlikely]]
     processIncoming();
 
-  if (timeless_states.empty() && timed_states.empty()) {
+  const size_t count = getSampleCount();
+
+  if (timeless_states.empty() && count == 0) {
     GM_RUNONCE(
         GM_ERR(GM_STR("TimeStateTracker<" << demangle(typeid(TYPE)) << ">"),
                "No states available."));
@@ -175,36 +274,54 @@ void TimeSampleTracker<TYPE>::Impl::update(clock::time_point now,
   if (!start_time) start_time = now;
 
   typedef std::chrono::duration<double, std::ratio<1>> d_seconds;
-  double duration = std::chrono::duration_cast<d_seconds>(
-                        std::chrono::steady_clock::now() - *start_time)
-                        .count();
+  double duration =
+      speed * std::chrono::duration_cast<d_seconds>(now - *start_time).count();
 
-  if (duration > timed_states.back().time) {
-    auto back_time = timed_states.back().time;
+  const double back_time = getSampleTime(count - 1);
+  if (!loop)
+    duration = std::min(duration, back_time);
+  else if (duration > back_time && back_time > 0)
     duration -= int(duration / back_time) * back_time;
-  }
 
-  if (duration < timed_states.front().time) return;
+  if (duration < getSampleTime(0)) return;
 
-  size_t last_idx = 0;
-  for (size_t idx = 0; idx < timed_states.size(); ++idx) {
-    if (timed_states[idx].time > duration) break;
-    last_idx = idx;
-  }
+  const size_t idx = findSample(duration);
+  const size_t next_idx = idx + 1 < count ? idx + 1 : idx;
+
+  const float r = next_idx == idx
+    ? 0.f
+    : float((duration - getSampleTime(idx)) /
+            (getSampleTime(next_idx) - getSampleTime(idx)));
 
-  float r =
-      float((duration - timed_states[last_idx].time) /
-            (timed_states[last_idx + 1].time - timed_states[last_idx].time));
-
-  state = timed_states[last_idx].state;
-  for (auto &s : state.value()) {
-    s.second.time = now;
-    if (timed_states[last_idx + 1].state.contains(s.first)) {
-      s.second.value =
-          interpolate(s.second.value,
-                      timed_states[last_idx + 1].state.at(s.first).value,
-                      r);
+  // Update the state in place, to avoid reallocating it every frame
+  if (!state) state.emplace();
+
+  TYPE value, next_value;
+  for (size_t key_idx = 0; key_idx < getKeyCount(); ++key_idx) {
+
+    const std::string &key = getKey(key_idx);
+
+    if (!getValue(idx, key_idx, value)) {
+      state->erase(key);
+      continue;
     }
+
+    // Recorded keys that were not updated keep their age
+    double age = getAge(idx, key_idx);
+    if (getValue(next_idx, key_idx, next_value)) {
+      value = interpolate(value, next_value, r);
+      age += r * (getAge(next_idx, key_idx) - age);
+    }
+
+    clock::time_point time = now;
+    if (age > 0)
+      time -= std::chrono::duration_cast<clock::duration>(d_seconds(age / speed));
+
+    auto it = state->find(key);
+    if (it == state->end())
+      state->emplace(key, typename TrackerBase<TYPE>::Sample{ time, value });
+    else
+      it->second = { time, value };
   }
 }
 
@@ -221,6 +338,41 @@ template<class TYPE> void TimeSampleTracker<TYPE>::addTime(double seconds) {
   _impl->incoming_times.push_back(seconds);
 }
 
+template<class TYPE>
+void TimeSampleTracker<TYPE>::setSampleFile(std::filesystem::path path) {
+
+  path = gmCore::FileResolver::getDefault()->resolve(
+      path, gmCore::FileResolver::Check::ReadableFile);
+
+  auto file = std::make_unique<TimeSampleFile>(path);
+
+  constexpr size_t components = gmCore::NumericLayout<TYPE>::components;
+  if (file->getComponentCount() != components)
+    throw gmCore::InvalidArgument(
+        GM_STR("Time sample file " << path << " has "
+               << file->getComponentCount() << " components per value; "
+               << demangle(typeid(TYPE)) << " has " << components));
+
+  if (!_impl->times.empty() || !_impl->timeless_states.empty())
+    throw gmCore::PreConditionViolation(
+        "Cannot play back samples from file in addition to other samples");
+
+  _impl->file = std::move(file);
+  _impl->cursor = 0;
+}
+
+template<class TYPE>
+void TimeSampleTracker<TYPE>::setSpeed(double speed) {
+  if (!(speed > 0))
+    throw gmCore::InvalidArgument(GM_STR("Playback speed must be positive, not " << speed));
+  _impl->speed = speed;
+}
+
+template<class TYPE>
+void TimeSampleTracker<TYPE>::setLoop(bool on) {
+  _impl->loop = on;
+}
+
 template<class TYPE> std::optional<typename TrackerBase<TYPE>::State> TimeSampleTracker<TYPE>::get() {
   return _impl->state;
 }
@@ -3,6 +3,7 @@
 #define GRAMODS_TRACK_TRACKERBASE
 
 #include <gmTrack/config.hh>
+#include <gmTrack/TrackerKey.hh>
 
 #include <gmCore/io_float.hh>
 #include <gmCore/Object.hh>
@@ -10,6 +11,8 @@
 
 #include <chrono>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 BEGIN_NAMESPACE_GMTRACK;
 
@@ -26,6 +29,12 @@ BEGIN_NAMESPACE_GMTRACK;
    If a sample is calculated as a combination of two or more other
    samples, then the time stamp should be the latest of that of the
    included samples.
+
+   The state can also be read in a flat representation, with keys
+   interned as TrackerKey ids and the samples in a vector provided by
+   the caller, using getFlat. Trackers that implement getFlat
+   natively can be chained without hashing key strings or allocating
+   memory, once the caller's vector has grown to fit the state.
 */
 template<class TYPE> class TrackerBase : public gmCore::Object {
 
@@ -54,6 +63,37 @@ public:
   */
   virtual std::optional<State> get() = 0;
 
+  /**
+     Type of a sample in the flat state representation, with its key
+     as a TrackerKey id.
+  */
+  struct KeySample {
+    TrackerKey::Id key; //< Interned key
+    Sample sample;      //< Key sample
+  };
+
+  /**
+     Type of the flat tracker state, with at most one sample per key.
+  */
+  typedef std::vector<KeySample> FlatState;
+
+  /**
+     Reads state data into the specified flat state, replacing its
+     contents. Returns false if data could not be read, but not if
+     the data are old.
+
+     The default implementation converts the result of get, so
+     trackers in performance critical chains should override this.
+  */
+  virtual bool getFlat(FlatState &state) {
+    state.clear();
+    auto full_state = get();
+    if (!full_state) return false;
+    for (const auto &sample : *full_state)
+      state.push_back({TrackerKey::getId(sample.first), sample.second});
+    return true;
+  }
+
   /**
      Returns the default key, in Configuration, for the Object,
      i.e. poseTracker, binaryTracker, floatTracker and float2Tracker,
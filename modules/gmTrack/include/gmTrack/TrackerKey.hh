@@ -0,0 +1,48 @@
+#ifndef GRAMODS_TRACK_TRACKERKEY
+#define GRAMODS_TRACK_TRACKERKEY
+
+#include <gmTrack/config.hh>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   Global registry of tracker keys, interning each key string to a
+   small integer id that stays the same for the lifetime of the
+   program. Ids are handed out in the order keys are first seen,
+   starting at zero.
+
+   Trackers that use the flat state representation (see
+   TrackerBase::getFlat) identify samples by these ids, so that keys
+   are compared as integers instead of hashed as strings. Look up the
+   ids of configured keys once, when configured, rather than per
+   call.
+
+   The registry may be used from any thread.
+*/
+struct TrackerKey {
+
+  /**
+     Type of interned key ids.
+  */
+  typedef uint32_t Id;
+
+  /**
+     Returns the id of the specified key, interning the key if it has
+     not been seen before.
+  */
+  static Id getId(std::string_view key);
+
+  /**
+     Returns the key of the specified id. The returned reference
+     stays valid for the lifetime of the program.
+  */
+  static const std::string &getName(Id id);
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
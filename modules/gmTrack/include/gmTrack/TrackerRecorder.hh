@@ -0,0 +1,122 @@
+#ifndef GRAMODS_TRACK_TRACKERRECORDER
+#define GRAMODS_TRACK_TRACKERRECORDER
+
+#include <gmTrack/TrackerBase.hh>
+
+#include <gmCore/OFactory.hh>
+
+#include <filesystem>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+/**
+   Records the states of a tracker into a TimeSampleFile, for
+   playback with a RecordedTracker or any TimeSampleTracker.
+
+   Exactly one tracker, of any of the types pose, binary, float or
+   float2, must be specified. The tracker is read every update and a
+   record is made whenever it reports a sample newer than in the
+   previous record. Record times are taken from the latest sample of
+   each state, relative to the first record, and each key is stored
+   with the age of its sample at that time, so that keys that were
+   not updated are not played back as new samples. The records are
+   handed over to a background thread that writes them to file, so
+   that the update thread never waits for the disk, and handed back
+   to be reused, so that recording adds little work to the update
+   thread. If the writing falls behind by more than the queue size,
+   records are dropped and counted.
+
+   This class configures as an Updateable with a priority of -100, so
+   that trackers updated in the same frame are recorded after their
+   update. Either Updateable::updateAll or update must be called at
+   even intervals. This is done automatically by gm-load.
+
+   ~~~~~{.xml}
+   <TrackerRecorder file="session.gmts">
+     <PoseVrpnTracker connectionString="DTrack@localhost"/>
+   </TrackerRecorder>
+   ~~~~~
+*/
+class TrackerRecorder : public gmCore::Object {
+
+public:
+
+  TrackerRecorder();
+  ~TrackerRecorder();
+
+  /**
+     Opens the file and starts the writer thread.
+  */
+  void initialize() override;
+
+  /**
+     Sets the file to write the records to. Any existing file is
+     overwritten.
+
+     \gmXmlTag{gmTrack,TrackerRecorder,file}
+  */
+  void setFile(std::filesystem::path file);
+
+  /**
+     Sets the number of records that can wait for the writer thread
+     before new records are dropped. Default is 1024.
+
+     \gmXmlTag{gmTrack,TrackerRecorder,queueSize}
+  */
+  void setQueueSize(size_t n);
+
+  /**
+     Sets the PoseTracker to record.
+  */
+  void setPoseTracker(std::shared_ptr<PoseTracker> tracker);
+
+  /**
+     Sets the BinaryTracker to record.
+  */
+  void setBinaryTracker(std::shared_ptr<BinaryTracker> tracker);
+
+  /**
+     Sets the FloatTracker to record.
+  */
+  void setFloatTracker(std::shared_ptr<FloatTracker> tracker);
+
+  /**
+     Sets the Float2Tracker to record.
+  */
+  void setFloat2Tracker(std::shared_ptr<Float2Tracker> tracker);
+
+  /**
+     Returns the number of records handed over to the writer thread.
+  */
+  size_t getRecordCount();
+
+  /**
+     Returns the number of records dropped because the writer thread
+     fell behind.
+  */
+  size_t getDropCount();
+
+  /**
+     Stops the recording, waits for the writer thread to write all
+     queued records and closes the file. This is also done when the
+     recorder is destroyed.
+  */
+  void close();
+
+  /**
+     Propagates the specified visitor.
+
+     @see Object::Visitor
+  */
+  void traverse(Visitor *visitor) override;
+
+  GM_OFI_DECLARE;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _impl;
+};
+
+END_NAMESPACE_GMTRACK;
+
+#endif
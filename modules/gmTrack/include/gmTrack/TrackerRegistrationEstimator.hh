@@ -14,6 +14,17 @@ BEGIN_NAMESPACE_GMTRACK;
    The utility is used by marking, with the tracking device, the
    position of known, pre-specified positions in the room or display
    system.
+
+   By default the registration is solved as a single least squares
+   problem over the averaged tracker positions. In robust mode it is
+   instead estimated from every individual sample, by RANSAC over
+   minimal subsets of four samples followed by Levenberg-Marquardt
+   refinement over the consensus set, so that outliers, such as
+   samples taken while the device was still moving, do not skew the
+   result. The robust estimation runs on the workers of the shared
+   gmCore::JobSystem, which the update loop never helps out with,
+   and the result is picked up by a later update, so that thousands
+   of samples can be used without stalling the frame.
 */
 class TrackerRegistrationEstimator
   : public PoseSampleCollector {
@@ -30,12 +41,44 @@ public:
   */
   void addActualPosition(Eigen::Vector3f p);
 
+  /**
+     Activates or deactivates robust estimation. Default is false.
+
+     \gmXmlTag{gmTrack,TrackerRegistrationEstimator,robust}
+  */
+  void setRobust(bool on);
+
+  /**
+     Sets the number of random subsets to evaluate in robust
+     mode. Default is 1000.
+
+     \gmXmlTag{gmTrack,TrackerRegistrationEstimator,ransacIterations}
+  */
+  void setRansacIterations(size_t n);
+
+  /**
+     Sets the largest distance, in room units, between an actual
+     position and its registered tracker sample for the sample to be
+     counted as an inlier in robust mode. Default is 0.01, i.e. one
+     cm.
+
+     \gmXmlTag{gmTrack,TrackerRegistrationEstimator,ransacThreshold}
+  */
+  void setRansacThreshold(float d);
+
   /**
      Force registration estimation. This is needed only if the
      component is used non-interactively.
   */
   void performRegistration();
 
+  /**
+     Blocks until a robust estimation started by performRegistration
+     or by an update has finished. Returns true if there is a
+     registration, false otherwise.
+  */
+  bool waitForRegistration();
+
   /**
      Extract registration matrix, either raw or without
      scaling. Returns true if there is a registration, false
@@ -43,6 +86,22 @@ public:
   */
   bool getRegistration(Eigen::Matrix4f * RAW, Eigen::Matrix4f * UNIT);
 
+  /**
+     Returns the distance between the actual position and the
+     registered tracker position, for each sample that the latest
+     registration was estimated from. In robust mode these are the
+     individual samples, in the order they were collected, otherwise
+     the averaged tracker positions.
+  */
+  std::vector<float> getResiduals();
+
+  /**
+     Returns the number of samples that the latest registration was
+     estimated from, i.e. the size of the consensus set in robust
+     mode.
+  */
+  size_t getInlierCount();
+
   GM_OFI_DECLARE;
 
 private:
@@ -25,6 +25,13 @@ BEGIN_NAMESPACE_GMTRACK;
    This class configures as an Updateable with a priority of
    10. Updateable::updateAll must be called at even intervals. This is
    done automatically by gm-load.
+
+   By default the VRPN connections are serviced in the update, until
+   no more data are available. With setThreaded ("threaded" in XML)
+   they are instead serviced continuously by a background thread,
+   that hands the latest state over to the update without locking
+   after each pass over the connections, so that bursts of network
+   data do not delay the frame.
 */
 template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
 class VrpnTracker : public TrackerBase<TYPE> {
@@ -48,6 +55,19 @@ public:
   */
   void addConnectionString(std::string id);
 
+  /**
+     Sets whether to service the VRPN connections in a background
+     thread instead of in the update. The thread is started at the
+     first update, after which no more connections can be
+     added. Default is false.
+
+     \gmXmlNodeAttr{gmTrack,PoseVrpnTracker,threaded}
+     \gmXmlNodeAttr{gmTrack,FloatVrpnTracker,threaded}
+     \gmXmlNodeAttr{gmTrack,Float2VrpnTracker,threaded}
+     \gmXmlNodeAttr{gmTrack,BinaryVrpnTracker,threaded}
+  */
+  void setThreaded(bool on);
+
   /**
      @see TrackerBase::get
   */
@@ -7,9 +7,12 @@
 #include <gmCore/io_typeid.hh>
 #include <gmCore/PreConditionViolation.hh>
 #include <gmCore/RunOnce.hh>
+#include <gmCore/TripleBuffer.hh>
 #include <gmCore/Updateable.hh>
 
+#include <atomic>
 #include <optional>
+#include <thread>
 #include <unordered_set>
 
 using namespace std::literals::string_literals;
@@ -22,9 +25,30 @@ struct VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl : gmCore::Updateable {
   typedef typename TrackerBase<TYPE>::State State;
 
   Impl() : gmCore::Updateable(10) {}
+  ~Impl();
 
   void update(clock::time_point now, size_t frame) override;
 
+  /**
+     Removes defunct connections. Returns false if there are no
+     connections left.
+  */
+  bool removeDefunct();
+
+  /**
+     Services each connection once. Returns true if any data were
+     received.
+  */
+  bool pollOnce();
+
+  /**
+     Removes defunct connections and services the rest until no more
+     data are available. Returns true if any data were received.
+  */
+  bool poll();
+
+  void pollThread();
+
   void handler(const std::string key,
                const std::string connection_str,
                const vrpn_CB info);
@@ -51,6 +75,14 @@ struct VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl : gmCore::Updateable {
   std::optional<typename TrackerBase<TYPE>::State> state;
   bool got_data;
 
+  bool threaded = false;
+  std::thread poll_thread;
+  std::atomic<bool> poll_thread_alive = false;
+
+  /// State written by the handler in the poll thread
+  std::optional<State> polled_state;
+  gmCore::TripleBuffer<State> state_buffer;
+
   const std::string type_str =
       GM_STR("VrpnTracker<" << demangle(typeid(TYPE)) << ">");
 };
@@ -61,10 +93,48 @@ VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::VrpnTracker()
 
 template<class TYPE, class vrpn_TRACKER, class vrpn_CB> VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::~VrpnTracker() {}
 
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::~Impl() {
+
+  if (!poll_thread.joinable()) return;
+
+  poll_thread_alive = false;
+
+  try {
+    poll_thread.join();
+  } catch (const std::system_error &e) {
+    GM_WRN(type_str,
+           "Caught system_error while joining poll thread. Code "
+           << e.code() << " meaning " << e.what() << ".");
+  }
+}
+
 template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
 void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::update(
     clock::time_point now, size_t frame) {
 
+  if (threaded) {
+
+    if (!poll_thread.joinable()) {
+      poll_thread_alive = true;
+      poll_thread = std::thread([this] { this->pollThread(); });
+    }
+
+    // Assigning into the existing state reuses its allocations
+    if (state_buffer.update()) {
+      if (!state) state.emplace();
+      *state = state_buffer.getReadBuffer();
+    }
+
+    return;
+  }
+
+  poll();
+}
+
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+bool VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::removeDefunct() {
+
   trackers.erase(
       std::remove_if(
           trackers.begin(),
@@ -83,17 +153,55 @@ void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::update(
 
   if (trackers.empty()) {
     GM_RUNONCE(GM_WRN(type_str, "No remotes to read data from"));
-    return;
+    return false;
   }
 
-  do {
-    got_data = false;
-    for (auto &tracker : trackers) tracker->remote->mainloop();
-  } while (got_data);
+  return true;
+}
+
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+bool VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::pollOnce() {
+  got_data = false;
+  for (auto &tracker : trackers) tracker->remote->mainloop();
+  return got_data;
+}
+
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+bool VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::poll() {
+
+  if (!removeDefunct()) return false;
+
+  bool got_any_data = false;
+  while (pollOnce()) got_any_data = true;
+
+  return got_any_data;
+}
+
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::pollThread() {
+
+  GM_DBG1(type_str, "Servicing " << trackers.size()
+          << " connections in background thread");
+
+  while (poll_thread_alive) {
+
+    // Publish after every pass, since a continuous stream would
+    // otherwise never be drained
+    if (!removeDefunct() || !pollOnce()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    state_buffer.getWriteBuffer() = *polled_state;
+    state_buffer.publish();
+  }
 }
 
 template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
 void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::addConnectionString(std::string id) {
+  if (_impl->poll_thread.joinable())
+    throw gmCore::PreConditionViolation(
+        "Cannot add connections while serviced by background thread");
   _impl->trackers.push_back(
       std::make_unique<
           typename VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::RemoteData>(
@@ -137,12 +245,21 @@ void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::Impl::handler(
       std::chrono::microseconds(info.msg_time.tv_usec));
   auto time = clock::time_point(secs + usecs);
 
-  if (!state) state = typename TrackerBase<TYPE>::State {};
+  auto &target = threaded ? polled_state : state;
+  if (!target) target = typename TrackerBase<TYPE>::State {};
 
-  setState(state.value(), time, key, info);
+  setState(target.value(), time, key, info);
   got_data = true;
 }
 
+template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
+void VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::setThreaded(bool on) {
+  if (_impl->poll_thread.joinable())
+    throw gmCore::PreConditionViolation(
+        "Cannot change threading while serviced by background thread");
+  _impl->threaded = on;
+}
+
 template<class TYPE, class vrpn_TRACKER, class vrpn_CB>
 std::optional<typename TrackerBase<TYPE>::State>
 VrpnTracker<TYPE, vrpn_TRACKER, vrpn_CB>::get() {
@@ -44,6 +44,8 @@ struct ArucoGridBoard::Impl {
 ArucoGridBoard::ArucoGridBoard()
   : _impl(std::make_unique<Impl>()) {}
 
+ArucoGridBoard::~ArucoGridBoard() {}
+
 
 void ArucoGridBoard::setColumns(size_t N) {
   _impl->cache_up_to_date = false;
@@ -0,0 +1,119 @@
+
+#include <gmTrack/ArucoMultiCameraPoseTracker.hh>
+
+#ifdef gramods_ENABLE_OpenCV_objdetect
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/RunOnce.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(ArucoMultiCameraPoseTracker);
+GM_OFI_POINTER2(ArucoMultiCameraPoseTracker, poseTracker, gmTrack::ArucoPoseTracker, addPoseTracker);
+GM_OFI_PARAM2(ArucoMultiCameraPoseTracker, minReprojectionError, double, setMinReprojectionError);
+
+struct ArucoMultiCameraPoseTracker::Impl {
+
+  std::optional<State> get();
+
+  /**
+     Weighted sum of the poses of one key.
+  */
+  struct Fusion {
+    clock::time_point time = clock::time_point::min();
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+    Eigen::Vector4d orientation = Eigen::Vector4d::Zero();
+    double weight = 0;
+  };
+
+  std::vector<std::shared_ptr<ArucoPoseTracker>> trackers;
+  double min_error = 0.1;
+
+  std::map<std::string, double> errors;
+};
+
+ArucoMultiCameraPoseTracker::ArucoMultiCameraPoseTracker()
+  : _impl(std::make_unique<Impl>()) {}
+
+ArucoMultiCameraPoseTracker::~ArucoMultiCameraPoseTracker() {}
+
+std::optional<PoseTracker::State> ArucoMultiCameraPoseTracker::get() {
+  return _impl->get();
+}
+
+std::optional<PoseTracker::State> ArucoMultiCameraPoseTracker::Impl::get() {
+
+  errors.clear();
+
+  if (trackers.empty()) {
+    GM_RUNONCE(GM_WRN("ArucoMultiCameraPoseTracker", "Pose requested but no pose tracker available."));
+    return std::nullopt;
+  }
+
+  std::unordered_map<std::string, Fusion> fusions;
+  bool any_state = false;
+
+  for (auto &tracker : trackers) {
+
+    auto state = tracker->get();
+    if (!state) continue;
+    any_state = true;
+
+    auto tracker_errors = tracker->getReprojectionErrors();
+
+    for (const auto &sample : *state) {
+
+      auto error = tracker_errors.find(sample.first);
+      double e = std::max(min_error,
+                          error == tracker_errors.end() ? min_error : error->second);
+      double weight = 1.0 / (e * e);
+
+      Fusion &fusion = fusions[sample.first];
+      fusion.time = std::max(fusion.time, sample.second.time);
+      fusion.position += weight * sample.second.value.position.cast<double>();
+
+      // Average on the same hemisphere as the poses already added
+      Eigen::Vector4d q = sample.second.value.orientation.coeffs().cast<double>();
+      if (fusion.weight > 0 && fusion.orientation.dot(q) < 0) q = -q;
+      fusion.orientation += weight * q;
+
+      fusion.weight += weight;
+    }
+  }
+
+  if (!any_state) return std::nullopt;
+
+  State state;
+  for (const auto &[key, fusion] : fusions) {
+    Eigen::Quaterniond orientation(fusion.orientation);
+    state[key] = {
+      .time = fusion.time,
+      .value = { (fusion.position / fusion.weight).cast<float>(),
+                 orientation.normalized().cast<float>() } };
+    errors[key] = 1.0 / std::sqrt(fusion.weight);
+  }
+
+  return state;
+}
+
+void ArucoMultiCameraPoseTracker::addPoseTracker(std::shared_ptr<ArucoPoseTracker> tracker) {
+  _impl->trackers.push_back(tracker);
+}
+
+void ArucoMultiCameraPoseTracker::setMinReprojectionError(double e) {
+  if (e <= 0) throw gmCore::InvalidArgument("Reprojection error must be positive");
+  _impl->min_error = e;
+}
+
+std::map<std::string, double> ArucoMultiCameraPoseTracker::getReprojectionErrors() {
+  return _impl->errors;
+}
+
+void ArucoMultiCameraPoseTracker::traverse(Visitor *visitor) {
+  for (auto &tracker : _impl->trackers) tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
+
+#endif
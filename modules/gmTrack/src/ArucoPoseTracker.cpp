@@ -5,12 +5,21 @@
 
 #include <gmCore/Console.hh>
 #include <gmCore/FileResolver.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/JobSystem.hh>
+#include <gmCore/PreConditionViolation.hh>
 #include <gmCore/RunLimited.hh>
 #include <gmCore/RunOnce.hh>
+#include <gmCore/TripleBuffer.hh>
 #include <gmCore/Updateable.hh>
 
 #include <opencv2/objdetect.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
 BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE(ArucoPoseTracker);
@@ -18,6 +27,15 @@ GM_OFI_PARAM2(ArucoPoseTracker, cameraConfigurationFile, std::filesystem::path,
 GM_OFI_PARAM2(ArucoPoseTracker, trackCamera, bool, setTrackCamera);
 GM_OFI_PARAM2(ArucoPoseTracker, key, std::string, setKey);
 GM_OFI_PARAM2(ArucoPoseTracker, refindMarkers, bool, setRefindMarkers);
+GM_OFI_PARAM2(ArucoPoseTracker, threaded, bool, setThreaded);
+GM_OFI_PARAM2(ArucoPoseTracker, useRoi, bool, setUseRoi);
+GM_OFI_PARAM2(ArucoPoseTracker, roiMargin, float, setRoiMargin);
+GM_OFI_PARAM2(ArucoPoseTracker, cameraPosition, Eigen::Vector3f, setCameraPosition);
+GM_OFI_PARAM2(ArucoPoseTracker, cameraOrientation, Eigen::Quaternionf, setCameraOrientation);
+GM_OFI_PARAM2(ArucoPoseTracker, cornerTrackingFrames, size_t, setCornerTrackingFrames);
+GM_OFI_PARAM2(ArucoPoseTracker, maxReprojectionError, double, setMaxReprojectionError);
+GM_OFI_PARAM2(ArucoPoseTracker, maxPositionDeviation, double, setMaxPositionDeviation);
+GM_OFI_PARAM2(ArucoPoseTracker, maxOrientationDeviation, double, setMaxOrientationDeviation);
 GM_OFI_POINTER2(ArucoPoseTracker, arucoBoard, gmTrack::ArucoBoard, addArucoBoard);
 GM_OFI_POINTER2(ArucoPoseTracker, videoSource, gmTrack::OpenCvVideoCapture, setVideoSource);
 GM_OFI_PARAM2(ArucoPoseTracker, showDebug, bool, setShowDebug);
@@ -31,9 +49,102 @@ size_t getTrackerIdx() {
 
 struct ArucoPoseTracker::Impl : public gmCore::Updateable {
 
-  Impl() : tracker_idx(getTrackerIdx()) {}
+  typedef gmCore::Updateable::clock clock;
+
+  struct Frame {
+    cv::Mat image;
+    clock::time_point time;
+  };
+
+  struct Result {
+    std::optional<State> state;
+    std::map<std::string, double> errors;
+    cv::Mat debug_image;
+  };
+
+  /**
+     Detector and per frame detections of one dictionary, shared by
+     the boards using that dictionary.
+  */
+  struct Detector {
+    cv::aruco::Dictionary dictionary;
+    cv::aruco::ArucoDetector detector;
+    bool needed;
+    std::optional<cv::Rect> roi;
+    std::vector<int> ids;
+    std::vector<std::vector<cv::Point2f>> corners, rejected;
+  };
+
+  struct PoseSample {
+    clock::time_point time;
+    Eigen::Vector3d position;
+    Eigen::Quaterniond orientation;
+  };
 
-  void update(gmCore::Updateable::clock::time_point time, size_t frame);
+  struct BoardData {
+    cv::Ptr<cv::aruco::Board> board;
+    size_t detector_idx;
+    std::optional<cv::Rect> roi; //< Predicted from the latest pose
+
+    /// Pose in the previous frame, if the board was found
+    std::optional<std::pair<cv::Vec3d, cv::Vec3d>> extrinsics;
+
+    /// Markers of the latest pose, for corner tracking
+    std::vector<int> ids;
+    std::vector<std::vector<cv::Point2f>> corners;
+    size_t tracked_frames = 0;
+
+    /// Motion model, from the latest two accepted poses
+    std::optional<PoseSample> latest, previous;
+    size_t rejections = 0;
+  };
+
+  /**
+     Outcome of one board in one frame.
+  */
+  struct BoardResult {
+    bool tracked = false;
+    bool found = false;
+    cv::Vec3d rvec, tvec;
+    double error = 0; //< Mean reprojection error, in pixels
+  };
+
+  Impl() : tracker_idx(getTrackerIdx()) {}
+  ~Impl();
+
+  void update(clock::time_point time, size_t frame) override;
+
+  /**
+     Detects the boards in the specified frame. This is called by
+     the detection thread, if one is running.
+  */
+  void detect(const Frame &frame, Result &result);
+
+  void setup();
+  void adjustCameraMatrix(int width, int height);
+  void forEach(size_t count, const std::function<void(size_t)> &func);
+  void detectMarkers(const cv::Mat &image, size_t detector_idx);
+  bool trackCorners(const cv::Mat &gray, BoardData &data, BoardResult &result);
+  void findBoard(const cv::Mat &image, BoardData &data, BoardResult &result);
+  bool estimatePose(const cv::aruco::Board &board,
+                    const std::vector<std::vector<cv::Point2f>> &corners,
+                    const std::vector<int> &ids,
+                    const BoardData &data,
+                    BoardResult &result,
+                    bool require_precision);
+  double reprojectionError(const cv::Mat &objPoints, const cv::Mat &imgPoints,
+                           const cv::Vec3d &rvec, const cv::Vec3d &tvec) const;
+  bool acceptPose(BoardData &data, const PoseSample &sample);
+  std::optional<cv::Rect> predictRoi(const cv::aruco::Board &board,
+                                     const cv::Vec3d &rvec,
+                                     const cv::Vec3d &tvec,
+                                     cv::Size size) const;
+
+  void pickUpResult();
+
+  void startDetection();
+  void stopDetection();
+  void detectionThread();
 
   static bool readCameraParameters(std::filesystem::path filename,
                                    cv::Mat &camMatrix, cv::Mat &distCoeffs,
@@ -49,18 +160,54 @@ struct ArucoPoseTracker::Impl : public gmCore::Updateable {
   cv::Mat distCoeffs;
 
   std::optional<State> state;
+  std::map<std::string, double> errors;
+
+  Eigen::Vector3f camera_position = Eigen::Vector3f::Zero();
+  Eigen::Quaternionf camera_orientation = Eigen::Quaternionf::Identity();
 
   bool track_camera = false;
   bool refind_markers = false;
+  bool use_roi = true;
+  float roi_margin = 0.5f;
+  size_t corner_tracking_frames = 0;
+  double max_reprojection_error = 2.0;
+  double max_position_deviation = 0.0;
+  double max_orientation_deviation = 0.0;
 
   bool show_debug_output = false;
   const size_t tracker_idx;
+
+  /// Persist over frames, set up at the first detection
+  std::vector<Detector> detectors;
+  std::vector<BoardData> board_data;
+  bool is_setup = false;
+
+  std::shared_ptr<gmCore::JobSystem> job_system;
+
+  bool threaded = true;
+  std::thread detection_thread;
+  std::atomic<bool> detection_thread_alive = false;
+  gmCore::TripleBuffer<Frame> frame_buffer;
+  gmCore::TripleBuffer<Result> result_buffer;
+  std::optional<clock::time_point> last_frame_time;
+
+  std::atomic<double> latency = 0;
+  std::atomic<double> detection_rate = 0;
+  std::atomic<size_t> frame_count = 0;
 };
 
 ArucoPoseTracker::ArucoPoseTracker()
   : _impl(std::make_unique<Impl>()) {}
 
+ArucoPoseTracker::~ArucoPoseTracker() {}
+
+ArucoPoseTracker::Impl::~Impl() {
+  stopDetection();
+}
+
 void ArucoPoseTracker::addArucoBoard(std::shared_ptr<ArucoBoard> board) {
+  if (_impl->is_setup || _impl->detection_thread.joinable())
+    throw gmCore::PreConditionViolation("Cannot add boards after detection has started");
   _impl->boards.push_back(board);
 }
 
@@ -84,8 +231,61 @@ void ArucoPoseTracker::setRefindMarkers(bool on) {
   _impl->refind_markers = on;
 }
 
-void ArucoPoseTracker::Impl::update(
-    gmCore::Updateable::clock::time_point time_now, size_t frame) {
+void ArucoPoseTracker::setThreaded(bool on) {
+  if (_impl->detection_thread.joinable())
+    throw gmCore::PreConditionViolation("Cannot change threading after detection has started");
+  _impl->threaded = on;
+}
+
+void ArucoPoseTracker::setUseRoi(bool on) {
+  _impl->use_roi = on;
+}
+
+void ArucoPoseTracker::setRoiMargin(float margin) {
+  if (margin < 0) throw gmCore::InvalidArgument("ROI margin cannot be negative");
+  _impl->roi_margin = margin;
+}
+
+void ArucoPoseTracker::setCameraPosition(Eigen::Vector3f p) {
+  _impl->camera_position = p;
+}
+
+void ArucoPoseTracker::setCameraOrientation(Eigen::Quaternionf q) {
+  _impl->camera_orientation = q;
+}
+
+void ArucoPoseTracker::setCornerTrackingFrames(size_t n) {
+  _impl->corner_tracking_frames = n;
+}
+
+void ArucoPoseTracker::setMaxReprojectionError(double e) {
+  if (e <= 0) throw gmCore::InvalidArgument("Reprojection error must be positive");
+  _impl->max_reprojection_error = e;
+}
+
+void ArucoPoseTracker::setMaxPositionDeviation(double d) {
+  if (d < 0) throw gmCore::InvalidArgument("Position deviation cannot be negative");
+  _impl->max_position_deviation = d;
+}
+
+void ArucoPoseTracker::setMaxOrientationDeviation(double d) {
+  if (d < 0) throw gmCore::InvalidArgument("Orientation deviation cannot be negative");
+  _impl->max_orientation_deviation = d;
+}
+
+double ArucoPoseTracker::getLatency() {
+  return _impl->latency;
+}
+
+double ArucoPoseTracker::getDetectionRate() {
+  return _impl->detection_rate;
+}
+
+size_t ArucoPoseTracker::getFrameCount() {
+  return _impl->frame_count;
+}
+
+void ArucoPoseTracker::Impl::update(clock::time_point, size_t) {
 
   if (boards.empty()) {
     GM_RUNONCE(GM_ERR("ArucoPoseTracker", "No board to track."));
@@ -105,172 +305,589 @@ void ArucoPoseTracker::Impl::update(
     return;
   }
 
-  cv::Mat image;
-  if (!video_source->retrieve(image)) {
+  Frame frame;
+  if (!video_source->retrieve(frame.image)) {
     GM_RUNLIMITED(GM_WRN("ArucoPoseTracker", "Video source did not provide image."), 1);
-    state = std::nullopt;
+    if (!detection_thread.joinable()) state = std::nullopt;
     return;
   }
+  frame.time = video_source->getFrameTime();
 
-  cv::Mat debug_image;
-  if (show_debug_output)
-    image.copyTo(debug_image);
+  // The video source provides the same frame until it has a newer
+  if (last_frame_time && frame.time <= *last_frame_time) {
+    pickUpResult();
+    return;
+  }
+  last_frame_time = frame.time;
 
-  if (camera_width != image.cols ||
-      camera_height != image.rows) {
+  if (threaded) {
+    if (!detection_thread.joinable()) startDetection();
+    // The image is shared, not copied
+    frame_buffer.write(std::move(frame));
+    pickUpResult();
+    return;
+  }
+
+  Result result;
+  detect(frame, result);
+  state = std::move(result.state);
+  errors = std::move(result.errors);
+
+  if (show_debug_output && !result.debug_image.empty()) {
+    cv::imshow("ArucoPoseTracker", result.debug_image);
+    cv::waitKey(1);
+  }
+}
 
-    if (camera_width * image.rows - camera_height * image.cols)
-      GM_WRN("ArucoPoseTracker", "Video source image size (" << image.cols << "x" << image.rows << ") does not match camera parameters (" << camera_width << "x" << camera_height << ") - adjusting camera matrix accordingly. Even ratio differs, so result will be less than optimal.");
-    else
-      GM_WRN("ArucoPoseTracker", "Video source image size (" << image.cols << "x" << image.rows << ") does not match camera parameters (" << camera_width << "x" << camera_height << ") - adjusting camera matrix accordingly. The ratio is the same, but result may be less than optimal.");
+void ArucoPoseTracker::Impl::pickUpResult() {
 
-    int new_width = image.cols;
-    int new_height = image.rows;
+  if (!detection_thread.joinable()) return;
+  if (!result_buffer.update()) return;
 
-    GM_DBG1("ArucoPoseTracker", "Provided camera matrix: " << camMatrix);
-    camMatrix.at<double>(0, 0) *= double(new_width) / double(camera_width);
-    camMatrix.at<double>(1, 1) *= double(new_height) / double(camera_height);
-    camMatrix.at<double>(0, 2) *= double(new_width) / double(camera_width);
-    camMatrix.at<double>(1, 2) *= double(new_height) / double(camera_height);
-    GM_DBG1("ArucoPoseTracker", "New estimate of camera matrix: " << camMatrix);
+  const Result &result = result_buffer.getReadBuffer();
+  state = result.state;
+  errors = result.errors;
 
-    camera_width = new_width;
-    camera_height = new_height;
+  // HighGUI must be called from the main thread
+  if (show_debug_output && !result.debug_image.empty()) {
+    cv::imshow("ArucoPoseTracker", result.debug_image);
+    cv::waitKey(1);
   }
+}
 
-  cv::aruco::DetectorParameters detectorParams;
-  cv::aruco::RefineParameters refineParams;
+void ArucoPoseTracker::Impl::startDetection() {
 
-  struct DetectionCache {
-    cv::aruco::Dictionary dictionary;
-    std::vector<int> ids;
-    std::vector<std::vector<cv::Point2f>> corners, rejected;
-  };
-  std::vector<DetectionCache> detection_cache;
+  detection_thread_alive = true;
+  detection_thread = std::thread([this] { this->detectionThread(); });
+}
 
-  state = State {};
+void ArucoPoseTracker::Impl::stopDetection() {
 
-  for (size_t board_idx = 0; board_idx < boards.size(); ++board_idx) {
+  if (!detection_thread.joinable()) return;
 
-    auto board = this->boards[board_idx]->getBoard();
+  detection_thread_alive = false;
 
-    if (!board) {
-      GM_RUNLIMITED(
-          GM_WRN("ArucoPoseTracker",
-                 "Board " << board_idx << " did not return aruco board."),
-          1);
+  try {
+    detection_thread.join();
+  } catch (const std::system_error &e) {
+    GM_WRN("ArucoPoseTracker",
+           "Caught system_error while joining detection thread. Code "
+           << e.code() << " meaning " << e.what() << ".");
+  }
+}
+
+void ArucoPoseTracker::Impl::detectionThread() {
+
+  Frame frame;
+  while (detection_thread_alive) {
+
+    if (!frame_buffer.read(frame)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
       continue;
     }
 
-    std::vector<int> ids;
-    std::vector<std::vector<cv::Point2f>> corners, rejected;
+    Result &result = result_buffer.getWriteBuffer();
+    detect(frame, result);
+    result_buffer.publish();
 
-    auto dictionary = board->getDictionary();
-    cv::aruco::ArucoDetector detector(
-        dictionary, detectorParams, refineParams);
+    // Let the video source reuse the image
+    frame.image.release();
+  }
+}
+
+void ArucoPoseTracker::Impl::setup() {
+
+  cv::aruco::DetectorParameters detector_params;
+  cv::aruco::RefineParameters refine_params;
+
+  for (size_t board_idx = 0; board_idx < boards.size(); ++board_idx) {
+
+    auto board = boards[board_idx]->getBoard();
+    if (!board) {
+      GM_WRN("ArucoPoseTracker",
+             "Board " << board_idx << " did not return aruco board.");
+      board_data.push_back({nullptr, 0, std::nullopt});
+      continue;
+    }
 
-    auto find_cache = [dictionary](const DetectionCache &dc) {
+    const auto &dictionary = board->getDictionary();
+    auto same_dictionary = [&dictionary](const Detector &d) {
       return std::equal(dictionary.bytesList.begin<uchar>(),
                         dictionary.bytesList.end<uchar>(),
-                        dc.dictionary.bytesList.begin<uchar>(),
-                        dc.dictionary.bytesList.end<uchar>()) &&
-             (dictionary.markerSize == dc.dictionary.markerSize) &&
-             (dictionary.maxCorrectionBits == dc.dictionary.maxCorrectionBits);
+                        d.dictionary.bytesList.begin<uchar>(),
+                        d.dictionary.bytesList.end<uchar>()) &&
+             (dictionary.markerSize == d.dictionary.markerSize) &&
+             (dictionary.maxCorrectionBits == d.dictionary.maxCorrectionBits);
     };
 
-    auto cache = std::find_if(
-        detection_cache.begin(), detection_cache.end(), find_cache);
-    if (cache != detection_cache.end()) {
-      ids = cache->ids;
-      corners = cache->corners;
-      rejected = cache->rejected;
-    } else {
-      // detect markers
-      detector.detectMarkers(image, corners, ids, rejected);
+    auto detector =
+        std::find_if(detectors.begin(), detectors.end(), same_dictionary);
+    if (detector == detectors.end()) {
+      detectors.push_back(
+          {dictionary,
+           cv::aruco::ArucoDetector(dictionary, detector_params, refine_params),
+           false, std::nullopt, {}, {}, {}});
+      detector = detectors.end() - 1;
+    }
 
-      if (ids.empty()) continue;
+    board_data.push_back(
+        {board, size_t(detector - detectors.begin()), std::nullopt});
+  }
+
+  GM_DBG1("ArucoPoseTracker", "Tracking " << boards.size() << " boards using "
+                                          << detectors.size() << " dictionaries.");
+
+  job_system = gmCore::JobSystem::get();
+  is_setup = true;
+}
 
-      detection_cache.push_back({dictionary, ids, corners, rejected});
+void ArucoPoseTracker::Impl::adjustCameraMatrix(int new_width, int new_height) {
+
+  if (camera_width * new_height - camera_height * new_width)
+    GM_WRN("ArucoPoseTracker", "Video source image size (" << new_width << "x" << new_height << ") does not match camera parameters (" << camera_width << "x" << camera_height << ") - adjusting camera matrix accordingly. Even ratio differs, so result will be less than optimal.");
+  else
+    GM_WRN("ArucoPoseTracker", "Video source image size (" << new_width << "x" << new_height << ") does not match camera parameters (" << camera_width << "x" << camera_height << ") - adjusting camera matrix accordingly. The ratio is the same, but result may be less than optimal.");
+
+  GM_DBG1("ArucoPoseTracker", "Provided camera matrix: " << camMatrix);
+  camMatrix.at<double>(0, 0) *= double(new_width) / double(camera_width);
+  camMatrix.at<double>(1, 1) *= double(new_height) / double(camera_height);
+  camMatrix.at<double>(0, 2) *= double(new_width) / double(camera_width);
+  camMatrix.at<double>(1, 2) *= double(new_height) / double(camera_height);
+  GM_DBG1("ArucoPoseTracker", "New estimate of camera matrix: " << camMatrix);
+
+  camera_width = new_width;
+  camera_height = new_height;
+}
+
+void ArucoPoseTracker::Impl::forEach(size_t count,
+                                     const std::function<void(size_t)> &func) {
+  job_system->parallelFor(0, count, [&func](size_t begin, size_t end) {
+    for (size_t idx = begin; idx < end; ++idx) func(idx);
+  }, 1);
+}
 
-      if (show_debug_output) {
-        if (ids.size() > 0)
-          cv::aruco::drawDetectedMarkers(debug_image, corners, ids);
+void ArucoPoseTracker::Impl::detectMarkers(const cv::Mat &image,
+                                           size_t detector_idx) {
 
-        if (rejected.size() > 0)
-          cv::aruco::drawDetectedMarkers(debug_image, rejected, cv::noArray(), cv::Scalar(0, 0, 100));
+  Detector &detector = detectors[detector_idx];
+
+  // Search the part of the image where the boards of this dictionary
+  // are expected, unless some of them were lost
+  std::optional<cv::Rect> roi;
+  if (use_roi)
+    for (const auto &data : board_data) {
+      if (!data.board || data.detector_idx != detector_idx) continue;
+      if (!data.roi) {
+        roi = std::nullopt;
+        break;
       }
+      roi = roi ? (*roi | *data.roi) : *data.roi;
     }
 
-    // refind strategy to detect more markers
-    if (refind_markers)
-      detector.refineDetectedMarkers(
-          image, *board, corners, ids, rejected, camMatrix, distCoeffs);
+  // Searching a large part of the image costs as much as searching all of it
+  if (roi && 2 * roi->area() > image.cols * image.rows)
+    roi = std::nullopt;
+
+  if (roi) {
+    detector.detector.detectMarkers(
+        image(*roi), detector.corners, detector.ids, detector.rejected);
+
+    const cv::Point2f offset(float(roi->x), float(roi->y));
+    for (auto &marker : detector.corners)
+      for (auto &corner : marker) corner += offset;
+    for (auto &marker : detector.rejected)
+      for (auto &corner : marker) corner += offset;
+  }
+
+  // Fall back to the full image if the expected boards were lost
+  if (!roi || detector.ids.empty()) {
+    detector.detector.detectMarkers(
+        image, detector.corners, detector.ids, detector.rejected);
+    roi = std::nullopt;
+  }
+
+  detector.roi = roi;
+}
+
+bool ArucoPoseTracker::Impl::trackCorners(const cv::Mat &gray,
+                                          BoardData &data,
+                                          BoardResult &result) {
+
+  // Start from where the motion model expects the corners, falling
+  // back to the previous corners
+  std::vector<cv::Point2f> points;
+  if (data.latest && data.previous) {
 
     cv::Mat objPoints, imgPoints;
-    board->matchImagePoints(corners, ids, objPoints, imgPoints);
+    data.board->matchImagePoints(data.corners, data.ids, objPoints, imgPoints);
+    if (objPoints.total() == 0) return false;
+
+    // Assuming the same motion as between the previous two frames
+    Eigen::Vector3d position =
+        2 * data.latest->position - data.previous->position;
+    cv::Vec3d tvec(position.x(), position.y(), position.z());
+    cv::projectPoints(objPoints, data.extrinsics->first, tvec,
+                      camMatrix, distCoeffs, points);
+  } else {
+    for (const auto &marker : data.corners)
+      points.insert(points.end(), marker.begin(), marker.end());
+  }
 
-    if (objPoints.total() == 0) continue;
+  if (points.empty()) return false;
 
-    // Find pose
-    cv::Vec3d rvec, tvec;
-    try {
-      cv::solvePnP(objPoints, imgPoints, camMatrix, distCoeffs, rvec, tvec);
-    } catch (const std::exception &e) {
-      GM_ERR("ArucoPoseTracker", "solvePnP failed: " << e.what());
+  const cv::Rect bounds(0, 0, gray.cols, gray.rows);
+  for (const auto &point : points)
+    if (!bounds.contains(point)) return false;
+
+  cv::cornerSubPix(
+      gray, points, cv::Size(5, 5), cv::Size(-1, -1),
+      cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 20, 0.01));
+
+  std::vector<std::vector<cv::Point2f>> corners(data.corners.size());
+  auto point = points.begin();
+  for (auto &marker : corners)
+    for (size_t idx = 0; idx < 4; ++idx) marker.push_back(*point++);
+
+  if (!estimatePose(*data.board, corners, data.ids, data, result, true))
+    return false;
+
+  data.corners = std::move(corners);
+  return true;
+}
+
+void ArucoPoseTracker::Impl::findBoard(const cv::Mat &image,
+                                       BoardData &data,
+                                       BoardResult &result) {
+
+  const Detector &detector = detectors[data.detector_idx];
+  if (detector.ids.empty()) return;
+
+  auto &board = *data.board;
+
+  data.ids = detector.ids;
+  data.corners = detector.corners;
+  std::vector<std::vector<cv::Point2f>> rejected = detector.rejected;
+
+  // refind strategy to detect more markers
+  if (refind_markers)
+    detector.detector.refineDetectedMarkers(
+        image, board, data.corners, data.ids, rejected, camMatrix, distCoeffs);
+
+  // Keep only the markers of this board, for corner tracking
+  const auto &board_ids = board.getIds();
+  size_t count = 0;
+  for (size_t idx = 0; idx < data.ids.size(); ++idx) {
+    if (std::find(board_ids.begin(), board_ids.end(), data.ids[idx]) ==
+        board_ids.end())
       continue;
-    } catch (...) {
-      GM_ERR("ArucoPoseTracker", "solvePnP failed of unknown reason");
+    data.ids[count] = data.ids[idx];
+    data.corners[count] = std::move(data.corners[idx]);
+    ++count;
+  }
+  data.ids.resize(count);
+  data.corners.resize(count);
+
+  result.found = estimatePose(board, data.corners, data.ids, data, result, false);
+}
+
+bool ArucoPoseTracker::Impl::estimatePose(
+    const cv::aruco::Board &board,
+    const std::vector<std::vector<cv::Point2f>> &corners,
+    const std::vector<int> &ids,
+    const BoardData &data,
+    BoardResult &result,
+    bool require_precision) {
+
+  cv::Mat objPoints, imgPoints;
+  board.matchImagePoints(corners, ids, objPoints, imgPoints);
+
+  if (objPoints.total() == 0) return false;
+
+  cv::Vec3d &rvec = result.rvec;
+  cv::Vec3d &tvec = result.tvec;
+
+  try {
+
+    // Refine the pose of the previous frame, if there is one
+    if (data.extrinsics) {
+      rvec = data.extrinsics->first;
+      tvec = data.extrinsics->second;
+      cv::solvePnP(objPoints, imgPoints, camMatrix, distCoeffs, rvec, tvec,
+                   true, cv::SOLVEPNP_ITERATIVE);
+      result.error = reprojectionError(objPoints, imgPoints, rvec, tvec);
+      if (result.error <= max_reprojection_error) return true;
+      if (require_precision) return false;
+    }
+
+    cv::solvePnP(objPoints, imgPoints, camMatrix, distCoeffs, rvec, tvec);
+
+  } catch (const std::exception &e) {
+    GM_ERR("ArucoPoseTracker", "solvePnP failed: " << e.what());
+    return false;
+  } catch (...) {
+    GM_ERR("ArucoPoseTracker", "solvePnP failed of unknown reason");
+    return false;
+  }
+
+  result.error = reprojectionError(objPoints, imgPoints, rvec, tvec);
+  return !require_precision || result.error <= max_reprojection_error;
+}
+
+double ArucoPoseTracker::Impl::reprojectionError(const cv::Mat &objPoints,
+                                                 const cv::Mat &imgPoints,
+                                                 const cv::Vec3d &rvec,
+                                                 const cv::Vec3d &tvec) const {
+
+  std::vector<cv::Point2f> projected;
+  cv::projectPoints(objPoints, rvec, tvec, camMatrix, distCoeffs, projected);
+
+  double error = 0;
+  const cv::Point2f *measured = imgPoints.ptr<cv::Point2f>();
+  for (size_t idx = 0; idx < projected.size(); ++idx)
+    error += cv::norm(projected[idx] - measured[idx]);
+
+  return projected.empty() ? 0 : error / double(projected.size());
+}
+
+bool ArucoPoseTracker::Impl::acceptPose(BoardData &data,
+                                        const PoseSample &sample) {
+
+  // Poses are accepted again after a few rejections in a row, since
+  // the motion model is then more likely wrong than the detection
+  constexpr size_t MAX_REJECTIONS = 3;
+
+  if (data.latest && data.previous && data.rejections < MAX_REJECTIONS) {
+
+    typedef std::chrono::duration<double> d_seconds;
+    const double dt01 = d_seconds(data.latest->time - data.previous->time).count();
+    const double dt12 = d_seconds(sample.time - data.latest->time).count();
+
+    if (dt01 > 0 && dt12 > 0) {
+      const double r = dt12 / dt01;
+
+      // Constant velocity and angular velocity
+      Eigen::Vector3d position = data.latest->position +
+          r * (data.latest->position - data.previous->position);
+      Eigen::AngleAxisd rotation(
+          data.latest->orientation * data.previous->orientation.conjugate());
+      Eigen::Quaterniond orientation =
+          Eigen::AngleAxisd(r * rotation.angle(), rotation.axis()) *
+          data.latest->orientation;
+
+      bool outlier =
+          (max_position_deviation > 0 &&
+           (sample.position - position).norm() > max_position_deviation) ||
+          (max_orientation_deviation > 0 &&
+           sample.orientation.angularDistance(orientation) > max_orientation_deviation);
+
+      if (outlier) {
+        ++data.rejections;
+        return false;
+      }
+    }
+  }
+
+  if (data.rejections >= MAX_REJECTIONS) data.latest = std::nullopt;
+  data.rejections = 0;
+
+  data.previous = data.latest;
+  data.latest = sample;
+  return true;
+}
+
+std::optional<cv::Rect>
+ArucoPoseTracker::Impl::predictRoi(const cv::aruco::Board &board,
+                                   const cv::Vec3d &rvec,
+                                   const cv::Vec3d &tvec,
+                                   cv::Size size) const {
+
+  std::vector<cv::Point3f> object_points;
+  for (const auto &marker : board.getObjPoints())
+    object_points.insert(object_points.end(), marker.begin(), marker.end());
+
+  std::vector<cv::Point2f> image_points;
+  cv::projectPoints(object_points, rvec, tvec, camMatrix, distCoeffs, image_points);
+
+  cv::Rect rect = cv::boundingRect(image_points);
+  const int margin = int(roi_margin * std::max(rect.width, rect.height));
+  rect.x -= margin;
+  rect.y -= margin;
+  rect.width += 2 * margin;
+  rect.height += 2 * margin;
+
+  rect &= cv::Rect(0, 0, size.width, size.height);
+  if (rect.empty()) return std::nullopt;
+
+  return rect;
+}
+
+void ArucoPoseTracker::Impl::detect(const Frame &frame, Result &result) {
+
+  const cv::Mat &image = frame.image;
+
+  if (!is_setup) setup();
+
+  if (camera_width != image.cols ||
+      camera_height != image.rows)
+    adjustCameraMatrix(image.cols, image.rows);
+
+  std::vector<BoardResult> board_results(board_data.size());
+
+  // Track the corners of boards found in the previous frame instead
+  // of detecting their markers, as long as the tracking holds
+  auto can_track = [this](const BoardData &data) {
+    return corner_tracking_frames > 0 && data.board && data.extrinsics &&
+           data.tracked_frames < corner_tracking_frames;
+  };
+
+  if (std::any_of(board_data.begin(), board_data.end(), can_track)) {
+
+    cv::Mat gray;
+    if (image.channels() == 1) gray = image;
+    else cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+
+    forEach(board_data.size(), [&](size_t idx) {
+      if (!can_track(board_data[idx])) return;
+      board_results[idx].tracked =
+          trackCorners(gray, board_data[idx], board_results[idx]);
+      board_results[idx].found = board_results[idx].tracked;
+    });
+  }
+
+  // Detect markers, once per dictionary, for the boards not tracked
+  for (auto &detector : detectors) {
+    detector.needed = false;
+    detector.roi = std::nullopt;
+    detector.ids.clear();
+    detector.corners.clear();
+    detector.rejected.clear();
+  }
+  for (size_t idx = 0; idx < board_data.size(); ++idx)
+    if (board_data[idx].board && !board_results[idx].tracked)
+      detectors[board_data[idx].detector_idx].needed = true;
+
+  forEach(detectors.size(), [&](size_t idx) {
+    if (detectors[idx].needed) detectMarkers(image, idx);
+  });
+
+  // Estimate the poses of the boards not tracked, in parallel
+  forEach(board_data.size(), [&](size_t idx) {
+    if (!board_data[idx].board || board_results[idx].tracked) return;
+    findBoard(image, board_data[idx], board_results[idx]);
+  });
+
+  result.state = State {};
+  result.errors.clear();
+
+  result.debug_image.release();
+  if (show_debug_output) {
+    image.copyTo(result.debug_image);
+
+    for (const auto &detector : detectors) {
+      if (detector.roi)
+        cv::rectangle(result.debug_image, *detector.roi, cv::Scalar(0, 100, 0));
+
+      if (detector.ids.size() > 0)
+        cv::aruco::drawDetectedMarkers(result.debug_image, detector.corners, detector.ids);
+
+      if (detector.rejected.size() > 0)
+        cv::aruco::drawDetectedMarkers(result.debug_image, detector.rejected, cv::noArray(), cv::Scalar(0, 0, 100));
+    }
+  }
+
+  for (size_t board_idx = 0; board_idx < board_data.size(); ++board_idx) {
+
+    BoardData &data = board_data[board_idx];
+    if (!data.board) continue;
+
+    auto &board = *data.board;
+    BoardResult &board_result = board_results[board_idx];
+    cv::Vec3d &rvec = board_result.rvec;
+    cv::Vec3d &tvec = board_result.tvec;
+
+    if (board_result.tracked) ++data.tracked_frames;
+    else data.tracked_frames = 0;
+
+    data.roi = std::nullopt;
+    data.extrinsics = std::nullopt;
+    if (!board_result.found) {
+      data.latest = data.previous = std::nullopt;
+      continue;
+    }
+
+    const double angle = cv::norm(rvec);
+    Eigen::Quaterniond Q =
+        angle > std::numeric_limits<double>::epsilon()
+            ? Eigen::Quaterniond(Eigen::AngleAxisd(
+                  angle, Eigen::Vector3d(rvec[0], rvec[1], rvec[2]) / angle))
+            : Eigen::Quaterniond::Identity();
+    Eigen::Vector3d T(tvec[0], tvec[1], tvec[2]);
+
+    if (!acceptPose(data, {frame.time, T, Q})) {
+      GM_DBG2("ArucoPoseTracker", "Rejected pose of board " << board_idx
+              << " that deviates from its motion");
       continue;
     }
 
-    cv::Matx33d rotm;
-    cv::Rodrigues(rvec, rotm);
-    cv::Mat M(rotm);
-    Eigen::Map<Eigen::Matrix3d> R(M.ptr<double>());
-    Eigen::Quaterniond Q(R);
-
-    auto pose = gmCore::Pose {
-        .position =
-            track_camera
-                ? (Q.conjugate() *
-                   Eigen::Vector3d(-tvec[0], -tvec[1], -tvec[2]))
-                      .cast<float>()
-                : Eigen::Vector3d(tvec[0], tvec[1], tvec[2]).cast<float>(),
-        .orientation =
-            track_camera ? Q.conjugate().cast<float>() : Q.cast<float>()};
+    if (use_roi) data.roi = predictRoi(board, rvec, tvec, image.size());
+    data.extrinsics = std::make_pair(rvec, tvec);
+
+    auto pose =
+        track_camera
+            ? gmCore::Pose{.position = (Q.conjugate() * -T).cast<float>(),
+                           .orientation = Q.conjugate().cast<float>()}
+            : gmCore::Pose{.position = camera_position +
+                                       camera_orientation * T.cast<float>(),
+                           .orientation = camera_orientation * Q.cast<float>()};
 
     const auto key_base = key.value_or(GM_STR("/aruco/" << tracker_idx));
     const auto key = GM_STR(key_base << "/" << board_idx);
-    state.value()[key] = {.time = time_now, .value = pose};
+    result.state.value()[key] = {.time = frame.time, .value = pose};
+    result.errors[key] = board_result.error;
     GM_DBG3("ArucoPoseTracker", "Pose " << key);
 
     if (show_debug_output) {
       std::vector<std::vector<cv::Point2f>> imagePoints;
-      for (auto mpts : board->getObjPoints()) {
+      for (auto mpts : board.getObjPoints()) {
         std::vector<cv::Point2f> imgpts;
         cv::projectPoints(mpts, rvec, tvec, camMatrix, distCoeffs, imgpts);
         imagePoints.push_back(imgpts);
       }
       cv::aruco::drawDetectedMarkers(
-          debug_image, imagePoints, cv::noArray(), cv::Scalar(255, 0, 0));
+          result.debug_image, imagePoints, cv::noArray(), cv::Scalar(255, 0, 0));
 
       // Draw frame axes with OpenGL axes convention
+      cv::Matx33d rotm;
+      cv::Rodrigues(rvec, rotm);
       rotm = rotm * cv::Matx33d(1, 0, 0, 0, -1, 0, 0, 0, -1);
-      cv::Rodrigues(rotm, rvec);
-      cv::drawFrameAxes(debug_image, camMatrix, distCoeffs, rvec, tvec, 0.1f);
+      cv::Vec3d axes_rvec;
+      cv::Rodrigues(rotm, axes_rvec);
+      cv::drawFrameAxes(result.debug_image, camMatrix, distCoeffs, axes_rvec, tvec, 0.1f);
     }
   }
 
-  if (show_debug_output) {
-    cv::imshow("ArucoPoseTracker", debug_image);
-    cv::waitKey(1);
+  // Exponential averages over roughly the latest 20 frames
+  const double age =
+      std::chrono::duration<double>(clock::now() - frame.time).count();
+  const double found = result.state->empty() ? 0.0 : 1.0;
+  if (frame_count++ == 0) {
+    latency = age;
+    detection_rate = found;
+  } else {
+    latency = 0.95 * latency + 0.05 * age;
+    detection_rate = 0.95 * detection_rate + 0.05 * found;
   }
 }
 
 std::optional<PoseTracker::State> ArucoPoseTracker::get() {
+  _impl->pickUpResult();
   return _impl->state;
 }
 
+std::map<std::string, double> ArucoPoseTracker::getReprojectionErrors() {
+  return _impl->errors;
+}
+
 void ArucoPoseTracker::setCameraConfigurationFile(std::filesystem::path file) {
   file = gmCore::FileResolver::getDefault()->resolve(
       file, gmCore::FileResolver::Check::ReadableFile);
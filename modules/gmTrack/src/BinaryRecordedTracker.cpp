@@ -0,0 +1,11 @@
+
+#include <gmTrack/BinaryRecordedTracker.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(BinaryRecordedTracker);
+GM_OFI_PARAM2(BinaryRecordedTracker, file, std::filesystem::path, setFile);
+GM_OFI_PARAM2(BinaryRecordedTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(BinaryRecordedTracker, loop, bool, setLoop);
+
+END_NAMESPACE_GMTRACK;
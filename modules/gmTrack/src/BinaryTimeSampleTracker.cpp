@@ -8,6 +8,9 @@ GM_OFI_DEFINE(BinaryTimeSampleTracker);
 GM_OFI_PARAM2(BinaryTimeSampleTracker, key, std::string, addKey);
 GM_OFI_PARAM2(BinaryTimeSampleTracker, value, bool, addValue);
 GM_OFI_PARAM2(BinaryTimeSampleTracker, time, double, addTime);
+GM_OFI_PARAM2(BinaryTimeSampleTracker, sampleFile, std::filesystem::path, setSampleFile);
+GM_OFI_PARAM2(BinaryTimeSampleTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(BinaryTimeSampleTracker, loop, bool, setLoop);
 
 template<>
 bool BinaryTimeSampleTracker::Impl::interpolate(bool a, bool b, float r) {
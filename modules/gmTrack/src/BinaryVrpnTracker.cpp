@@ -10,6 +10,7 @@ BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE(BinaryVrpnTracker);
 GM_OFI_PARAM2(BinaryVrpnTracker, connectionString, std::string, addConnectionString);
+GM_OFI_PARAM2(BinaryVrpnTracker, threaded, bool, setThreaded);
 
 template<>
 void VrpnTracker<bool, vrpn_Button_Remote, vrpn_BUTTONCB>::Impl::setState(
@@ -0,0 +1,519 @@
+
+#include <gmTrack/FilteredPoseTracker.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/PoseArray.hh>
+#include <gmCore/RunOnce.hh>
+#include <gmCore/Stringify.hh>
+#include <gmCore/TimeTools.hh>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numbers>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(FilteredPoseTracker);
+GM_OFI_POINTER2(FilteredPoseTracker, poseTracker, PoseTracker, setPoseTracker);
+GM_OFI_PARAM2(FilteredPoseTracker, filter, std::string, setFilter);
+GM_OFI_PARAM2(FilteredPoseTracker, minCutoff, double, setMinCutoff);
+GM_OFI_PARAM2(FilteredPoseTracker, beta, double, setBeta);
+GM_OFI_PARAM2(FilteredPoseTracker, derivativeCutoff, double, setDerivativeCutoff);
+GM_OFI_PARAM2(FilteredPoseTracker, positionError, double, setPositionError);
+GM_OFI_PARAM2(FilteredPoseTracker, orientationError, double, setOrientationError);
+GM_OFI_PARAM2(FilteredPoseTracker, acceleration, double, setAcceleration);
+GM_OFI_PARAM2(FilteredPoseTracker, angularAcceleration, double, setAngularAcceleration);
+
+namespace {
+
+  // Keys are processed in chunks whose temporaries fit on the stack
+  constexpr Eigen::Index CHUNK = 256;
+
+  typedef Eigen::Array<float, Eigen::Dynamic, 1, 0, CHUNK, 1> Lane;
+  typedef Eigen::Map<Eigen::ArrayXf> Column;
+
+  constexpr float TWO_PI = 2.f * std::numbers::pi_v<float>;
+
+  struct Vector {
+    Lane x, y, z;
+  };
+
+  struct Quaternion {
+
+    Quaternion(Eigen::Index n)
+      : w(n), x(n), y(n), z(n) {}
+
+    Quaternion(const gmCore::PoseArray &a, size_t begin, Eigen::Index n)
+      : w(Eigen::Map<const Eigen::ArrayXf>(a.qw.data() + begin, n)),
+        x(Eigen::Map<const Eigen::ArrayXf>(a.qx.data() + begin, n)),
+        y(Eigen::Map<const Eigen::ArrayXf>(a.qy.data() + begin, n)),
+        z(Eigen::Map<const Eigen::ArrayXf>(a.qz.data() + begin, n)) {}
+
+    void store(gmCore::PoseArray &a, size_t begin) const {
+      Eigen::Index n = w.size();
+      Column(a.qw.data() + begin, n) = w;
+      Column(a.qx.data() + begin, n) = x;
+      Column(a.qy.data() + begin, n) = y;
+      Column(a.qz.data() + begin, n) = z;
+    }
+
+    Lane w, x, y, z;
+  };
+
+  /**
+     Returns a * conj(b), for unit quaternions the rotation from b to
+     a in world coordinates.
+  */
+  Quaternion difference(const Quaternion &a, const Quaternion &b) {
+    Quaternion out(a.w.size());
+    out.w = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    out.x = -a.w * b.x + a.x * b.w - a.y * b.z + a.z * b.y;
+    out.y = -a.w * b.y + a.x * b.z + a.y * b.w - a.z * b.x;
+    out.z = -a.w * b.z - a.x * b.y + a.y * b.x + a.z * b.w;
+    return out;
+  }
+
+  /**
+     Returns a * b, normalized.
+  */
+  Quaternion multiply(const Quaternion &a, const Quaternion &b) {
+    Quaternion out(a.w.size());
+    out.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+    out.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+    out.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+    out.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+    Lane inv_norm = (out.w.square() + out.x.square() +
+                     out.y.square() + out.z.square()).rsqrt();
+    out.w *= inv_norm;
+    out.x *= inv_norm;
+    out.y *= inv_norm;
+    out.z *= inv_norm;
+    return out;
+  }
+
+  /**
+     Returns the rotation vector of the specified unit quaternion,
+     along the shortest arc.
+  */
+  Vector log(const Quaternion &q) {
+    Lane sign = (q.w < 0.f).select(Lane::Constant(q.w.size(), -1.f), 1.f);
+    Lane w = (sign * q.w).min(1.f);
+    Lane s = (q.x.square() + q.y.square() + q.z.square()).sqrt();
+    // asin is accurate for small angles, where acos is not
+    Lane angle = 2.f * (w > 0.7f).select(s.min(1.f).asin(), w.acos());
+    Lane scale = sign * (s > 1e-12f).select(angle / s, 2.f);
+    return { scale * q.x, scale * q.y, scale * q.z };
+  }
+
+  /**
+     Returns the unit quaternion of the specified rotation vector.
+  */
+  Quaternion exp(const Vector &r) {
+    Lane angle = (r.x.square() + r.y.square() + r.z.square()).sqrt();
+    Lane half = 0.5f * angle;
+    Lane scale = (angle > 1e-12f).select(half.sin() / angle, 0.5f);
+    Quaternion out(r.x.size());
+    out.w = half.cos();
+    out.x = scale * r.x;
+    out.y = scale * r.y;
+    out.z = scale * r.z;
+    return out;
+  }
+
+  /**
+     Returns the smoothing factor of an exponential filter with the
+     specified cut-off frequency, at the specified sample interval.
+  */
+  template<class DT, class FC>
+  Lane smoothing(const DT &dt, const FC &cutoff) {
+    Lane r = TWO_PI * cutoff * dt;
+    return r / (1.f + r);
+  }
+}
+
+struct FilteredPoseTracker::Impl {
+
+  enum struct Filter { ONE_EURO, KALMAN };
+
+  /**
+     Per key filter state components, besides the pose.
+  */
+  enum Component {
+    VX, VY, VZ,    //< Velocity
+    WX, WY, WZ,    //< Angular velocity
+    P00, P01, P11, //< Position covariance of the Kalman filter
+    O00, O01, O11, //< Orientation covariance of the Kalman filter
+    DT,            //< Time since the previous sample, or zero
+    LATENCY,
+    COMPONENT_COUNT
+  };
+
+  /// Gaps, in seconds, after which a key is filtered from scratch
+  static constexpr double MAX_GAP = 0.25;
+
+  static constexpr size_t NO_INDEX = std::numeric_limits<size_t>::max();
+
+  bool filter(FlatState &state);
+
+  size_t getIndex(TrackerKey::Id key);
+  void reset(size_t idx, const gmCore::Pose &pose);
+
+  void filterOneEuro(size_t begin, Eigen::Index n);
+  void filterKalman(size_t begin, Eigen::Index n);
+
+  Column column(Component c, size_t begin, Eigen::Index n) {
+    return Column(components[c].data() + begin, n);
+  }
+
+  std::shared_ptr<PoseTracker> tracker;
+
+  Filter filter_type = Filter::ONE_EURO;
+
+  float min_cutoff = 1.f;
+  float beta = 1.f;
+  float derivative_cutoff = 1.f;
+
+  float position_error = 0.001f;
+  float orientation_error = 0.005f;
+  float acceleration = 1.f;
+  float angular_acceleration = 5.f;
+
+  /// Filter index per key id
+  std::vector<size_t> indices;
+
+  /// Per filter index
+  std::vector<const std::string *> names;
+  std::vector<clock::time_point> times;
+  gmCore::PoseArray poses;
+  gmCore::PoseArray measurements;
+  gmCore::PoseArray previous_measurements;
+  std::vector<float> components[COMPONENT_COUNT];
+
+  /// Filter index of each sample of the state being filtered
+  std::vector<size_t> sample_indices;
+
+  FlatState buffer;
+
+  /// Guards the filter state above, since trackers may be read from
+  /// several threads, e.g. by Updateables updated in parallel
+  std::mutex lock;
+};
+
+FilteredPoseTracker::FilteredPoseTracker() : _impl(std::make_unique<Impl>()) {}
+
+FilteredPoseTracker::~FilteredPoseTracker() {}
+
+std::optional<PoseTracker::State> FilteredPoseTracker::get() {
+
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  if (!_impl->filter(_impl->buffer)) return std::nullopt;
+
+  State state;
+  state.reserve(_impl->buffer.size());
+  for (size_t idx = 0; idx < _impl->buffer.size(); ++idx)
+    state.emplace(*_impl->names[_impl->sample_indices[idx]],
+                  _impl->buffer[idx].sample);
+
+  return state;
+}
+
+bool FilteredPoseTracker::getFlat(FlatState &state) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  return _impl->filter(state);
+}
+
+size_t FilteredPoseTracker::Impl::getIndex(TrackerKey::Id key) {
+
+  if (key < indices.size() && indices[key] != NO_INDEX) return indices[key];
+
+  if (key >= indices.size()) indices.resize(key + 1, NO_INDEX);
+
+  size_t idx = names.size();
+  indices[key] = idx;
+
+  names.push_back(&TrackerKey::getName(key));
+  times.emplace_back();
+  poses.push_back(gmCore::Pose());
+  measurements.push_back(gmCore::Pose());
+  previous_measurements.push_back(gmCore::Pose());
+  for (auto &c : components) c.push_back(0.f);
+
+  return idx;
+}
+
+void FilteredPoseTracker::Impl::reset(size_t idx, const gmCore::Pose &pose) {
+
+  poses.set(idx, pose);
+  measurements.set(idx, pose);
+  previous_measurements.set(idx, pose);
+  for (auto &c : components) c[idx] = 0.f;
+
+  // Velocity uncertainty from accelerating for a tenth of a second
+  components[P00][idx] = position_error * position_error;
+  components[P11][idx] = 0.01f * acceleration * acceleration;
+  components[O00][idx] = orientation_error * orientation_error;
+  components[O11][idx] = 0.01f * angular_acceleration * angular_acceleration;
+}
+
+bool FilteredPoseTracker::Impl::filter(FlatState &state) {
+
+  if (!tracker) {
+    GM_RUNONCE(GM_WRN("FilteredPoseTracker", "Pose requested but no pose tracker available."));
+    return false;
+  }
+
+  if (!tracker->getFlat(state)) return false;
+
+  std::fill(components[DT].begin(), components[DT].end(), 0.f);
+  sample_indices.clear();
+
+  // Gather the samples, as measurements of their keys
+
+  for (const auto &ks : state) {
+
+    const size_t count = names.size();
+    const size_t idx = getIndex(ks.key);
+    sample_indices.push_back(idx);
+
+    const Sample &sample = ks.sample;
+
+    if (idx == count) {
+      reset(idx, sample.value);
+      times[idx] = sample.time;
+      continue;
+    }
+
+    if (sample.time <= times[idx]) continue;
+
+    double dt = gmCore::TimeTools::durationToSeconds(sample.time - times[idx]);
+    times[idx] = sample.time;
+
+    if (dt > MAX_GAP) {
+      reset(idx, sample.value);
+      continue;
+    }
+
+    previous_measurements.set(idx, measurements.get(idx));
+    measurements.set(idx, sample.value);
+    components[DT][idx] = float(dt);
+  }
+
+  const size_t N = names.size();
+  for (size_t begin = 0; begin < N; begin += CHUNK) {
+    Eigen::Index n = Eigen::Index(std::min<size_t>(CHUNK, N - begin));
+    if (filter_type == Filter::ONE_EURO) filterOneEuro(begin, n);
+    else filterKalman(begin, n);
+  }
+
+  // Scatter the filtered poses
+
+  for (size_t idx = 0; idx < state.size(); ++idx)
+    state[idx].sample.value = poses.get(sample_indices[idx]);
+
+  return true;
+}
+
+void FilteredPoseTracker::Impl::filterOneEuro(size_t begin, Eigen::Index n) {
+
+  // Keys without a new sample are left unchanged by zero gains
+  Lane dt = column(DT, begin, n);
+  auto active = dt > 0.f;
+  Lane inv_dt = active.select(dt, 1.f).inverse();
+  Lane derivative_alpha = active.select(smoothing(dt, derivative_cutoff), 0.f);
+
+  // Positions
+
+  Column px(poses.px.data() + begin, n);
+  Column py(poses.py.data() + begin, n);
+  Column pz(poses.pz.data() + begin, n);
+
+  Column mx(measurements.px.data() + begin, n);
+  Column my(measurements.py.data() + begin, n);
+  Column mz(measurements.pz.data() + begin, n);
+
+  // The speed is estimated from the raw samples
+  Column vx = column(VX, begin, n);
+  Column vy = column(VY, begin, n);
+  Column vz = column(VZ, begin, n);
+  vx += derivative_alpha *
+      ((mx - Column(previous_measurements.px.data() + begin, n)) * inv_dt - vx);
+  vy += derivative_alpha *
+      ((my - Column(previous_measurements.py.data() + begin, n)) * inv_dt - vy);
+  vz += derivative_alpha *
+      ((mz - Column(previous_measurements.pz.data() + begin, n)) * inv_dt - vz);
+
+  Lane cutoff = min_cutoff + beta * (vx.square() + vy.square() + vz.square()).sqrt();
+  Lane alpha = active.select(smoothing(dt, cutoff), 0.f);
+  px += alpha * (mx - px);
+  py += alpha * (my - py);
+  pz += alpha * (mz - pz);
+
+  // Orientations
+
+  Quaternion measured(measurements, begin, n);
+  Vector d = log(difference(measured, Quaternion(previous_measurements, begin, n)));
+
+  Column wx = column(WX, begin, n);
+  Column wy = column(WY, begin, n);
+  Column wz = column(WZ, begin, n);
+  wx += derivative_alpha * (d.x * inv_dt - wx);
+  wy += derivative_alpha * (d.y * inv_dt - wy);
+  wz += derivative_alpha * (d.z * inv_dt - wz);
+
+  Lane angular_cutoff = min_cutoff + beta * (wx.square() + wy.square() + wz.square()).sqrt();
+  Lane angular_alpha = active.select(smoothing(dt, angular_cutoff), 0.f);
+  Quaternion filtered(poses, begin, n);
+  Vector e = log(difference(measured, filtered));
+  multiply(exp({ angular_alpha * e.x, angular_alpha * e.y, angular_alpha * e.z }), filtered)
+      .store(poses, begin);
+
+  // The lag of an exponential filter is its time constant
+  Column latency = column(LATENCY, begin, n);
+  latency = active.select(1.f / (TWO_PI * cutoff.min(angular_cutoff)), latency);
+}
+
+void FilteredPoseTracker::Impl::filterKalman(size_t begin, Eigen::Index n) {
+
+  Lane dt = column(DT, begin, n);
+  auto active = dt > 0.f;
+
+  // Predicts the covariance of a constant velocity model with white
+  // noise acceleration and updates it with a measurement, returning
+  // the gains of the position and velocity. Keys without a new
+  // sample get zero gains and keep their covariance.
+  auto update = [&](Component c00, Component c01, Component c11,
+                    float acc, float error, Lane &k0, Lane &k1) {
+    Column p00 = column(c00, begin, n);
+    Column p01 = column(c01, begin, n);
+    Column p11 = column(c11, begin, n);
+
+    const float q = acc * acc;
+    Lane a00 = p00 + dt * (2.f * p01 + dt * p11) + 0.25f * q * dt.square().square();
+    Lane a01 = p01 + dt * p11 + 0.5f * q * dt.cube();
+    Lane a11 = p11 + q * dt.square();
+
+    Lane s = a00 + error * error;
+    k0 = active.select(a00 / s, 0.f);
+    k1 = active.select(a01 / s, 0.f);
+
+    p00 = active.select((1.f - k0) * a00, p00);
+    p01 = active.select((1.f - k0) * a01, p01);
+    p11 = active.select(a11 - k1 * a01, p11);
+  };
+
+  // Positions
+
+  Lane k0(n), k1(n);
+  update(P00, P01, P11, acceleration, position_error, k0, k1);
+
+  Column px(poses.px.data() + begin, n);
+  Column py(poses.py.data() + begin, n);
+  Column pz(poses.pz.data() + begin, n);
+  Column vx = column(VX, begin, n);
+  Column vy = column(VY, begin, n);
+  Column vz = column(VZ, begin, n);
+
+  px += vx * dt;
+  py += vy * dt;
+  pz += vz * dt;
+
+  Lane ex = Column(measurements.px.data() + begin, n) - px;
+  Lane ey = Column(measurements.py.data() + begin, n) - py;
+  Lane ez = Column(measurements.pz.data() + begin, n) - pz;
+
+  px += k0 * ex;
+  py += k0 * ey;
+  pz += k0 * ez;
+  vx += k1 * ex;
+  vy += k1 * ey;
+  vz += k1 * ez;
+
+  Lane latency_estimate = active.select(dt * (1.f - k0) / k0, 0.f);
+
+  // Orientations
+
+  update(O00, O01, O11, angular_acceleration, orientation_error, k0, k1);
+
+  Column wx = column(WX, begin, n);
+  Column wy = column(WY, begin, n);
+  Column wz = column(WZ, begin, n);
+
+  Quaternion predicted = multiply(exp({ wx * dt, wy * dt, wz * dt }),
+                                  Quaternion(poses, begin, n));
+  Vector e = log(difference(Quaternion(measurements, begin, n), predicted));
+
+  multiply(exp({ k0 * e.x, k0 * e.y, k0 * e.z }), predicted).store(poses, begin);
+  wx += k1 * e.x;
+  wy += k1 * e.y;
+  wz += k1 * e.z;
+
+  latency_estimate = latency_estimate.max(active.select(dt * (1.f - k0) / k0, 0.f));
+
+  Column latency = column(LATENCY, begin, n);
+  latency = active.select(latency_estimate, latency);
+}
+
+double FilteredPoseTracker::getLatency() {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  const auto &latency = _impl->components[Impl::LATENCY];
+  float max_latency = 0.f;
+  for (size_t idx : _impl->sample_indices)
+    max_latency = std::max(max_latency, latency[idx]);
+  return max_latency;
+}
+
+void FilteredPoseTracker::setPoseTracker(std::shared_ptr<PoseTracker> tracker) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->tracker = tracker;
+}
+
+void FilteredPoseTracker::setFilter(std::string name) {
+  if (name == "oneEuro") _impl->filter_type = Impl::Filter::ONE_EURO;
+  else if (name == "kalman") _impl->filter_type = Impl::Filter::KALMAN;
+  else
+    throw gmCore::InvalidArgument(
+        GM_STR("Unknown filter " << name << "; expected oneEuro or kalman"));
+}
+
+void FilteredPoseTracker::setMinCutoff(double frequency) {
+  if (frequency <= 0) throw gmCore::InvalidArgument("Cut-off frequency must be positive");
+  _impl->min_cutoff = float(frequency);
+}
+
+void FilteredPoseTracker::setBeta(double beta) {
+  if (beta < 0) throw gmCore::InvalidArgument("Beta cannot be negative");
+  _impl->beta = float(beta);
+}
+
+void FilteredPoseTracker::setDerivativeCutoff(double frequency) {
+  if (frequency <= 0) throw gmCore::InvalidArgument("Cut-off frequency must be positive");
+  _impl->derivative_cutoff = float(frequency);
+}
+
+void FilteredPoseTracker::setPositionError(double e) {
+  if (e <= 0) throw gmCore::InvalidArgument("Position error must be positive");
+  _impl->position_error = float(e);
+}
+
+void FilteredPoseTracker::setOrientationError(double e) {
+  if (e <= 0) throw gmCore::InvalidArgument("Orientation error must be positive");
+  _impl->orientation_error = float(e);
+}
+
+void FilteredPoseTracker::setAcceleration(double a) {
+  if (a < 0) throw gmCore::InvalidArgument("Acceleration cannot be negative");
+  _impl->acceleration = float(a);
+}
+
+void FilteredPoseTracker::setAngularAcceleration(double a) {
+  if (a < 0) throw gmCore::InvalidArgument("Angular acceleration cannot be negative");
+  _impl->angular_acceleration = float(a);
+}
+
+void FilteredPoseTracker::traverse(Visitor *visitor) {
+  if (_impl->tracker) _impl->tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
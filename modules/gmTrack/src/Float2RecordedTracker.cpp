@@ -0,0 +1,13 @@
+
+#include <gmCore/io_float.hh>
+
+#include <gmTrack/Float2RecordedTracker.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(Float2RecordedTracker);
+GM_OFI_PARAM2(Float2RecordedTracker, file, std::filesystem::path, setFile);
+GM_OFI_PARAM2(Float2RecordedTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(Float2RecordedTracker, loop, bool, setLoop);
+
+END_NAMESPACE_GMTRACK;
@@ -12,6 +12,9 @@ GM_OFI_DEFINE(Float2TimeSampleTracker);
 GM_OFI_PARAM2(Float2TimeSampleTracker, key, std::string, addKey);
 GM_OFI_PARAM2(Float2TimeSampleTracker, value, gmCore::float2, addValue);
 GM_OFI_PARAM2(Float2TimeSampleTracker, time, double, addTime);
+GM_OFI_PARAM2(Float2TimeSampleTracker, sampleFile, std::filesystem::path, setSampleFile);
+GM_OFI_PARAM2(Float2TimeSampleTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(Float2TimeSampleTracker, loop, bool, setLoop);
 
 template<>
 gmCore::float2 Float2TimeSampleTracker::Impl::interpolate(gmCore::float2 a,
@@ -10,6 +10,7 @@ BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE(Float2VrpnTracker);
 GM_OFI_PARAM2(Float2VrpnTracker, connectionString, std::string, addConnectionString);
+GM_OFI_PARAM2(Float2VrpnTracker, threaded, bool, setThreaded);
 
 template<>
 void VrpnTracker<gmCore::float2, vrpn_Analog_Remote, vrpn_ANALOGCB>::Impl::
@@ -0,0 +1,11 @@
+
+#include <gmTrack/FloatRecordedTracker.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(FloatRecordedTracker);
+GM_OFI_PARAM2(FloatRecordedTracker, file, std::filesystem::path, setFile);
+GM_OFI_PARAM2(FloatRecordedTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(FloatRecordedTracker, loop, bool, setLoop);
+
+END_NAMESPACE_GMTRACK;
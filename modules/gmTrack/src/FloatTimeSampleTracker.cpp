@@ -10,6 +10,9 @@ GM_OFI_DEFINE(FloatTimeSampleTracker);
 GM_OFI_PARAM2(FloatTimeSampleTracker, key, std::string, addKey);
 GM_OFI_PARAM2(FloatTimeSampleTracker, value, float, addValue);
 GM_OFI_PARAM2(FloatTimeSampleTracker, time, double, addTime);
+GM_OFI_PARAM2(FloatTimeSampleTracker, sampleFile, std::filesystem::path, setSampleFile);
+GM_OFI_PARAM2(FloatTimeSampleTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(FloatTimeSampleTracker, loop, bool, setLoop);
 
 template<>
 float TimeSampleTracker<float>::Impl::interpolate(float a, float b, float r) {
@@ -10,6 +10,7 @@ BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE(FloatVrpnTracker);
 GM_OFI_PARAM2(FloatVrpnTracker, connectionString, std::string, addConnectionString);
+GM_OFI_PARAM2(FloatVrpnTracker, threaded, bool, setThreaded);
 
 template<>
 void VrpnTracker<float, vrpn_Analog_Remote, vrpn_ANALOGCB>::Impl::setState(
@@ -0,0 +1,300 @@
+
+#include <gmTrack/FusedPoseTracker.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/RunOnce.hh>
+#include <gmCore/TimeTools.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(FusedPoseTracker);
+GM_OFI_POINTER2(FusedPoseTracker, poseTracker, PoseTracker, addPoseTracker);
+GM_OFI_PARAM2(FusedPoseTracker, confidence, float, addConfidence);
+GM_OFI_PARAM2(FusedPoseTracker, latency, double, addLatency);
+GM_OFI_PARAM2(FusedPoseTracker, staleness, double, setStaleness);
+GM_OFI_PARAM2(FusedPoseTracker, maxAge, double, setMaxAge);
+GM_OFI_PARAM2(FusedPoseTracker, maxExtrapolation, double, setMaxExtrapolation);
+
+struct FusedPoseTracker::Impl {
+
+  struct Source {
+    std::shared_ptr<PoseTracker> tracker;
+    FlatState state;
+  };
+
+  /**
+     The latest sample of one key from one source, with the velocity
+     estimated from the previous samples.
+  */
+  struct Track {
+    bool valid = false;
+    clock::time_point time;
+    gmCore::Pose pose;
+    Eigen::Vector3f velocity = Eigen::Vector3f::Zero();
+    Eigen::Vector3f angular_velocity = Eigen::Vector3f::Zero();
+  };
+
+  struct Key {
+    TrackerKey::Id id;
+    const std::string *name;
+    uint64_t generation; //< Of the latest fusion in which a source reported the key
+  };
+
+  /// Weight of a new velocity estimate, since differences of
+  /// consecutive samples are noisy
+  static constexpr float VELOCITY_SMOOTHING = 0.5f;
+
+  static constexpr size_t NO_INDEX = std::numeric_limits<size_t>::max();
+
+  bool fuse(FlatState &state);
+  bool fuseKey(size_t idx, Sample &sample) const;
+
+  size_t getIndex(TrackerKey::Id key);
+  void addSample(Track &track, const Sample &sample, size_t source_idx);
+
+  float getConfidence(size_t source_idx) const {
+    return source_idx < confidences.size() ? confidences[source_idx] : 1.f;
+  }
+
+  void clearKeys() {
+    indices.clear();
+    keys.clear();
+    tracks.clear();
+  }
+
+  std::vector<Source> sources;
+  std::vector<float> confidences;
+  std::vector<clock::duration> latencies;
+
+  double staleness = 0.02;
+  double max_age = 0.1;
+  double max_extrapolation = 0.02;
+
+  /// Index into keys, per key id
+  std::vector<size_t> indices;
+  std::vector<Key> keys;
+
+  /// Tracks of all sources for each key, key by key
+  std::vector<Track> tracks;
+
+  uint64_t generation = 0;
+
+  FlatState buffer;
+
+  /// Guards the sources, tracks and buffers above, since trackers
+  /// may be read from several threads, e.g. by Updateables updated
+  /// in parallel
+  std::mutex lock;
+};
+
+FusedPoseTracker::FusedPoseTracker() : _impl(std::make_unique<Impl>()) {}
+
+FusedPoseTracker::~FusedPoseTracker() {}
+
+std::optional<PoseTracker::State> FusedPoseTracker::get() {
+
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  if (!_impl->fuse(_impl->buffer)) return std::nullopt;
+
+  State state;
+  state.reserve(_impl->buffer.size());
+  for (const auto &ks : _impl->buffer)
+    state.emplace(*_impl->keys[_impl->indices[ks.key]].name, ks.sample);
+
+  return state;
+}
+
+bool FusedPoseTracker::getFlat(FlatState &state) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  return _impl->fuse(state);
+}
+
+size_t FusedPoseTracker::Impl::getIndex(TrackerKey::Id key) {
+
+  if (key < indices.size() && indices[key] != NO_INDEX) return indices[key];
+
+  if (key >= indices.size()) indices.resize(key + 1, NO_INDEX);
+
+  size_t idx = keys.size();
+  indices[key] = idx;
+  keys.push_back({key, &TrackerKey::getName(key), 0});
+  tracks.resize(tracks.size() + sources.size());
+
+  return idx;
+}
+
+void FusedPoseTracker::Impl::addSample(Track &track,
+                                       const Sample &sample,
+                                       size_t source_idx) {
+
+  clock::time_point time = sample.time;
+  if (source_idx < latencies.size()) time -= latencies[source_idx];
+
+  if (track.valid && time <= track.time) return;
+
+  double dt = track.valid
+    ? gmCore::TimeTools::durationToSeconds(time - track.time)
+    : std::numeric_limits<double>::infinity();
+
+  if (dt > max_age) {
+    track = { true, time, sample.value };
+    return;
+  }
+
+  const gmCore::Pose &pose = sample.value;
+
+  Eigen::Vector3f velocity = (pose.position - track.pose.position) / float(dt);
+
+  Eigen::Quaternionf delta = pose.orientation * track.pose.orientation.conjugate();
+  if (delta.w() < 0) delta.coeffs() = -delta.coeffs();
+  Eigen::AngleAxisf aa(delta);
+  Eigen::Vector3f angular_velocity = (aa.angle() / float(dt)) * aa.axis();
+
+  track.velocity += VELOCITY_SMOOTHING * (velocity - track.velocity);
+  track.angular_velocity += VELOCITY_SMOOTHING * (angular_velocity - track.angular_velocity);
+  track.time = time;
+  track.pose = pose;
+}
+
+bool FusedPoseTracker::Impl::fuse(FlatState &state) {
+
+  state.clear();
+
+  if (sources.empty()) {
+    GM_RUNONCE(GM_WRN("FusedPoseTracker", "Pose requested but no pose trackers available."));
+    return false;
+  }
+
+  ++generation;
+  const size_t S = sources.size();
+
+  bool has_state = false;
+  for (size_t source_idx = 0; source_idx < S; ++source_idx) {
+
+    Source &source = sources[source_idx];
+    if (!source.tracker->getFlat(source.state)) continue;
+    has_state = true;
+
+    for (const auto &ks : source.state) {
+      size_t idx = getIndex(ks.key);
+      keys[idx].generation = generation;
+      addSample(tracks[idx * S + source_idx], ks.sample, source_idx);
+    }
+  }
+
+  if (!has_state) return false;
+
+  Sample sample;
+  for (size_t idx = 0; idx < keys.size(); ++idx)
+    if (keys[idx].generation == generation && fuseKey(idx, sample))
+      state.push_back({keys[idx].id, sample});
+
+  return true;
+}
+
+bool FusedPoseTracker::Impl::fuseKey(size_t idx, Sample &sample) const {
+
+  const size_t S = sources.size();
+  const Track *key_tracks = tracks.data() + idx * S;
+
+  // The latest sample is the reference for time and orientation sign
+
+  const Track *latest = nullptr;
+  for (size_t source_idx = 0; source_idx < S; ++source_idx) {
+    const Track &track = key_tracks[source_idx];
+    if (track.valid && getConfidence(source_idx) > 0 &&
+        (!latest || track.time > latest->time))
+      latest = &track;
+  }
+  if (!latest) return false;
+
+  const Eigen::Vector4f &reference = latest->pose.orientation.coeffs();
+
+  Eigen::Vector3f position = Eigen::Vector3f::Zero();
+  Eigen::Vector4f orientation = Eigen::Vector4f::Zero();
+  float weight_sum = 0.f;
+
+  for (size_t source_idx = 0; source_idx < S; ++source_idx) {
+
+    const Track &track = key_tracks[source_idx];
+    if (!track.valid) continue;
+
+    double age = gmCore::TimeTools::durationToSeconds(latest->time - track.time);
+    if (age > max_age) continue;
+
+    float weight = getConfidence(source_idx) * float(std::exp(-age / staleness));
+    if (!(weight > 0.f)) continue;
+
+    // Align to the time of the latest sample
+    float dt = float(std::min(age, max_extrapolation));
+    Eigen::Vector3f position_i = track.pose.position + dt * track.velocity;
+
+    Eigen::Vector4f orientation_i = track.pose.orientation.coeffs();
+    Eigen::Vector3f rotation = dt * track.angular_velocity;
+    float angle = rotation.norm();
+    if (angle > std::numeric_limits<float>::epsilon())
+      orientation_i = (Eigen::Quaternionf(Eigen::AngleAxisf(angle, rotation / angle)) *
+                       track.pose.orientation).coeffs();
+
+    if (orientation_i.dot(reference) < 0) orientation_i = -orientation_i;
+
+    position += weight * position_i;
+    orientation += weight * orientation_i;
+    weight_sum += weight;
+  }
+
+  if (!(weight_sum > 0.f)) return false;
+
+  sample.time = latest->time;
+  sample.value.position = position / weight_sum;
+  sample.value.orientation = Eigen::Quaternionf(orientation.normalized());
+  return true;
+}
+
+void FusedPoseTracker::addPoseTracker(std::shared_ptr<PoseTracker> tracker) {
+  if (!tracker) throw gmCore::InvalidArgument("Cannot fuse null tracker");
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->sources.push_back({tracker, {}});
+  _impl->clearKeys();
+}
+
+void FusedPoseTracker::addConfidence(float confidence) {
+  if (confidence < 0) throw gmCore::InvalidArgument("Confidence cannot be negative");
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->confidences.push_back(confidence);
+}
+
+void FusedPoseTracker::addLatency(double seconds) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->latencies.push_back(std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(seconds)));
+  _impl->clearKeys();
+}
+
+void FusedPoseTracker::setStaleness(double seconds) {
+  if (seconds <= 0) throw gmCore::InvalidArgument("Staleness time must be positive");
+  _impl->staleness = seconds;
+}
+
+void FusedPoseTracker::setMaxAge(double seconds) {
+  if (seconds < 0) throw gmCore::InvalidArgument("Max age cannot be negative");
+  _impl->max_age = seconds;
+}
+
+void FusedPoseTracker::setMaxExtrapolation(double seconds) {
+  if (seconds < 0) throw gmCore::InvalidArgument("Extrapolation time cannot be negative");
+  _impl->max_extrapolation = seconds;
+}
+
+void FusedPoseTracker::traverse(Visitor *visitor) {
+  for (auto &source : _impl->sources)
+    source.tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
@@ -6,7 +6,9 @@
 #include <gmCore/RunOnce.hh>
 
 #include <gmCore/io_eigen.hh>
+#include <gmCore/PoseArray.hh>
 
+#include <algorithm>
 #include <unordered_set>
 
 BEGIN_NAMESPACE_GMTRACK;
@@ -20,10 +22,17 @@ GM_OFI_PARAM2(OffsetPoseTracker, offsetMatrix, Eigen::Matrix4f, setOffsetMatrix)
 struct OffsetPoseTracker::Impl {
 
   std::optional<State> get();
+  bool getFlat(FlatState &state);
+
+  /**
+     Offsets the specified samples in one batch, in place.
+  */
+  void offset(const std::vector<Sample *> &targets);
 
   std::shared_ptr<PoseTracker> tracker;
 
   std::unordered_set<std::string> keys;
+  std::vector<TrackerKey::Id> key_ids;
 
   Eigen::Vector3f position_offset = Eigen::Vector3f::Zero();
   Eigen::Quaternionf orientation_offset = Eigen::Quaternionf::Identity();
@@ -37,11 +46,14 @@ void OffsetPoseTracker::setPoseTracker(std::shared_ptr<PoseTracker> tracker) {
 }
 
 void OffsetPoseTracker::addKey(std::string key) {
-  _impl->keys.insert(key);
+  if (_impl->keys.insert(key).second)
+    _impl->key_ids.push_back(TrackerKey::getId(key));
 }
 
 std::optional<PoseTracker::State> OffsetPoseTracker::get() { return _impl->get(); }
 
+bool OffsetPoseTracker::getFlat(FlatState &state) { return _impl->getFlat(state); }
+
 std::optional<PoseTracker::State> OffsetPoseTracker::Impl::get() {
 
   if (!tracker) {
@@ -49,24 +61,52 @@ std::optional<PoseTracker::State> OffsetPoseTracker::Impl::get() {
     return std::nullopt;
   }
 
-  auto raw_state = tracker->get();
-  if (!raw_state) return std::nullopt;
+  auto state = tracker->get();
+  if (!state) return std::nullopt;
+
+  thread_local std::vector<Sample *> targets;
+  targets.clear();
+
+  for (auto &as : state.value())
+    if (keys.contains(as.first))
+      targets.push_back(&as.second);
+
+  offset(targets);
+  return state;
+}
+
+bool OffsetPoseTracker::Impl::getFlat(FlatState &state) {
+
+  if (!tracker) {
+    GM_RUNONCE(GM_WRN("OffsetPoseTracker", "Pose requested but no pose tracker available."));
+    return false;
+  }
+
+  if (!tracker->getFlat(state)) return false;
+
+  thread_local std::vector<Sample *> targets;
+  targets.clear();
+
+  for (auto &ks : state)
+    if (std::find(key_ids.begin(), key_ids.end(), ks.key) != key_ids.end())
+      targets.push_back(&ks.sample);
+
+  offset(targets);
+  return true;
+}
+
+void OffsetPoseTracker::Impl::offset(const std::vector<Sample *> &targets) {
+
+  thread_local gmCore::PoseArray poses;
+  poses.clear();
 
-  State reg_state;
+  for (auto sample : targets)
+    poses.push_back(sample->value);
 
-  for (const auto as : raw_state.value())
-    if (keys.contains(as.first)) {
-      reg_state[as.first] = {
-          .time = as.second.time,
-          .value = {.position = as.second.value.position +
-                                as.second.value.orientation * position_offset,
-                    .orientation =
-                        as.second.value.orientation * orientation_offset}};
-    } else {
-      reg_state[as.first] = as.second;
-    }
+  gmCore::PoseArray::compose(poses, {position_offset, orientation_offset}, poses);
 
-  return reg_state;
+  for (size_t idx = 0; idx < targets.size(); ++idx)
+    targets[idx]->value = poses.get(idx);
 }
 
 void OffsetPoseTracker::setPositionOffset(Eigen::Vector3f p) {
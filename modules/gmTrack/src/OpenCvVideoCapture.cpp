@@ -5,6 +5,10 @@
 
 #include <gmCore/Console.hh>
 #include <gmCore/FileResolver.hh>
+#include <gmCore/TripleBuffer.hh>
+
+#include <atomic>
+#include <thread>
 
 BEGIN_NAMESPACE_GMTRACK;
 
@@ -16,12 +20,21 @@ GM_OFI_PARAM2(OpenCvVideoCapture, cameraHeight, int, setCameraHeight);
 GM_OFI_PARAM2(OpenCvVideoCapture, cameraFramerate, int, setCameraFramerate);
 GM_OFI_PARAM2(OpenCvVideoCapture, cameraFourCC, std::string, setCameraFourCC);
 GM_OFI_PARAM2(OpenCvVideoCapture, backend, std::string, setBackend);
+GM_OFI_PARAM2(OpenCvVideoCapture, threaded, bool, setThreaded);
 
 struct OpenCvVideoCapture::Impl {
 
-  void update();
+  typedef gmCore::Updateable::clock clock;
+
+  ~Impl();
+
+  void update(clock::time_point now);
   bool retrieve(cv::Mat &image);
 
+  void startCapture();
+  void stopCapture();
+  void captureThread();
+
   void openCamera(int id);
   void openVideo(std::filesystem::path file);
 
@@ -43,12 +56,34 @@ struct OpenCvVideoCapture::Impl {
 
   bool initialized = false;
 
+  struct Frame {
+    cv::Mat image;
+    clock::time_point time;
+  };
+
+  bool threaded = true;
+  std::thread capture_thread;
+  std::atomic<bool> capture_thread_alive = false;
+  gmCore::TripleBuffer<Frame> frame_buffer;
+
+  /// The frame picked up by the latest update
+  Frame frame;
+
+  std::atomic<size_t> capture_count = 0;
+  std::atomic<size_t> drop_count = 0;
+  double latency = 0;
 };
 
 OpenCvVideoCapture::OpenCvVideoCapture()
   : Updateable(20),
     _impl(std::make_unique<Impl>()) {}
 
+OpenCvVideoCapture::~OpenCvVideoCapture() {}
+
+OpenCvVideoCapture::Impl::~Impl() {
+  stopCapture();
+}
+
 void OpenCvVideoCapture::setVideoFile(std::filesystem::path file) {
   _impl->use_camera = false;
   _impl->video_file = gmCore::FileResolver::getDefault()->resolve(
@@ -107,6 +142,11 @@ void OpenCvVideoCapture::setBackend(std::string b) {
   _impl->backend = Impl::backendFromString(b);
 }
 
+void OpenCvVideoCapture::setThreaded(bool on) {
+  _impl->threaded = on;
+  _impl->initialized = false;
+}
+
 cv::VideoCaptureAPIs OpenCvVideoCapture::Impl::backendFromString(std::string api) {
 
 #define BACKEND(NAME) if (api == #NAME) return cv::CAP_##NAME;
@@ -192,21 +232,97 @@ void OpenCvVideoCapture::Impl::openCamera(int id) {
   }
 }
 
-void OpenCvVideoCapture::update(gmCore::Updateable::clock::time_point, size_t) {
-  _impl->update();
+void OpenCvVideoCapture::update(gmCore::Updateable::clock::time_point now, size_t) {
+  _impl->update(now);
 }
 
-void OpenCvVideoCapture::Impl::update() {
+void OpenCvVideoCapture::Impl::update(clock::time_point now) {
 
   if (!initialized) {
 
-    if (use_camera) openCamera(camera_id);
-    else openVideo(video_file);
+    stopCapture();
+
+    if (use_camera && threaded) {
+      startCapture();
+    } else {
+      video_capture.release();
+      if (use_camera) openCamera(camera_id);
+      else openVideo(video_file);
+    }
 
     initialized = true;
   }
 
+  if (capture_thread.joinable()) {
+
+    // Keep the current frame until a newer has been captured
+    if (!frame_buffer.update()) return;
+
+    frame = frame_buffer.getReadBuffer();
+    latency = std::chrono::duration<double>(now - frame.time).count();
+    alive = !frame.image.empty();
+    return;
+  }
+
   alive = video_capture.grab();
+  if (!alive) return;
+
+  frame.time = now;
+  ++capture_count;
+}
+
+void OpenCvVideoCapture::Impl::startCapture() {
+
+  capture_thread_alive = true;
+  capture_thread = std::thread([this] { this->captureThread(); });
+}
+
+void OpenCvVideoCapture::Impl::stopCapture() {
+
+  if (!capture_thread.joinable()) return;
+
+  capture_thread_alive = false;
+
+  try {
+    capture_thread.join();
+  } catch (const std::system_error &e) {
+    GM_WRN("OpenCvVideoCapture",
+           "Caught system_error while joining capture thread. Code "
+           << e.code() << " meaning " << e.what() << ".");
+  }
+
+  frame = {};
+  alive = false;
+}
+
+void OpenCvVideoCapture::Impl::captureThread() {
+
+  video_capture.release();
+  openCamera(camera_id);
+
+  while (capture_thread_alive) {
+
+    if (!video_capture.isOpened() || !video_capture.grab()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    Frame &target = frame_buffer.getWriteBuffer();
+    target.time = clock::now();
+
+    // Decoding into an image that a consumer still refers to would
+    // change the consumer's data, so release such an image first. No
+    // new references can appear while this is the only one.
+    if (target.image.u && target.image.u->refcount > 1)
+      target.image.release();
+
+    if (!video_capture.retrieve(target.image)) continue;
+
+    ++capture_count;
+    if (frame_buffer.publish()) ++drop_count;
+  }
+
+  video_capture.release();
 }
 
 bool OpenCvVideoCapture::retrieve(cv::Mat &image) {
@@ -215,10 +331,33 @@ bool OpenCvVideoCapture::retrieve(cv::Mat &image) {
 
 bool OpenCvVideoCapture::Impl::retrieve(cv::Mat &image) {
   if (!alive) return false;
+
+  // Frames from the capture thread are shared, not copied
+  if (capture_thread.joinable()) {
+    image = frame.image;
+    return true;
+  }
+
   video_capture.retrieve(image);
   return true;
 }
 
+gmCore::Updateable::clock::time_point OpenCvVideoCapture::getFrameTime() {
+  return _impl->frame.time;
+}
+
+size_t OpenCvVideoCapture::getCaptureCount() {
+  return _impl->capture_count;
+}
+
+size_t OpenCvVideoCapture::getDropCount() {
+  return _impl->drop_count;
+}
+
+double OpenCvVideoCapture::getLatency() {
+  return _impl->latency;
+}
+
 END_NAMESPACE_GMTRACK;
 
 #endif
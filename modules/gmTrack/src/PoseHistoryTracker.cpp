@@ -0,0 +1,309 @@
+#include <gmTrack/PoseHistoryTracker.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/PreConditionViolation.hh>
+#include <gmCore/RunOnce.hh>
+#include <gmCore/Updateable.hh>
+
+#include <atomic>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(PoseHistoryTracker);
+GM_OFI_POINTER2(PoseHistoryTracker, poseTracker, PoseTracker, setPoseTracker);
+GM_OFI_PARAM2(PoseHistoryTracker, capacity, size_t, setCapacity);
+GM_OFI_PARAM2(PoseHistoryTracker, keyCapacity, size_t, setKeyCapacity);
+GM_OFI_PARAM2(PoseHistoryTracker, maxExtrapolation, double, setMaxExtrapolation);
+
+struct PoseHistoryTracker::Impl : gmCore::Updateable {
+
+  /**
+     One sample of the ring. The sequence number is odd while the
+     writer fills in the slot and otherwise even and unique for each
+     sample written to the slot, so that a reader can tell whether it
+     read a complete sample and whether it was the expected one.
+
+     All fields are atomic, so that concurrent reading and writing is
+     well defined; the sequence number orders them.
+  */
+  struct Slot {
+    std::atomic<uint64_t> sequence = 0;
+    std::atomic<clock::rep> time = 0;
+    std::atomic<float> values[7];
+  };
+
+  struct Sample {
+    clock::time_point time;
+    gmCore::Pose pose;
+  };
+
+  /**
+     The history of one key. The key is set once, before the history
+     is made visible to readers.
+  */
+  struct History {
+    std::string key;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> count = 0; //< Number of samples ever written
+    clock::time_point last_time;     //< Only used by the writer
+  };
+
+  Impl() : gmCore::Updateable(0) {}
+
+  void update(clock::time_point now, size_t frame) override;
+
+  void allocate();
+  void write(History &history, clock::time_point time, const gmCore::Pose &pose);
+
+  /**
+     Reads the sample with the specified index, if it is still in the
+     ring and not being written.
+  */
+  bool read(const History &history, uint64_t idx, Sample &sample) const;
+
+  bool getAt(const History &history, clock::time_point time, gmCore::Pose &pose) const;
+
+  std::shared_ptr<PoseTracker> tracker;
+
+  size_t capacity = 256;
+  size_t key_capacity = 32;
+  double max_extrapolation = 0.05;
+
+  std::unique_ptr<History[]> histories_storage;
+
+  /// Published after allocation, for readers in other threads
+  std::atomic<History *> histories = nullptr;
+  std::atomic<size_t> key_count = 0;
+};
+
+PoseHistoryTracker::PoseHistoryTracker() : _impl(std::make_unique<Impl>()) {}
+PoseHistoryTracker::~PoseHistoryTracker() {}
+
+void PoseHistoryTracker::Impl::allocate() {
+
+  histories_storage = std::make_unique<History[]>(key_capacity);
+  for (size_t idx = 0; idx < key_capacity; ++idx)
+    histories_storage[idx].slots = std::make_unique<Slot[]>(capacity);
+
+  histories.store(histories_storage.get(), std::memory_order_release);
+}
+
+void PoseHistoryTracker::Impl::update(clock::time_point, size_t) {
+
+  if (!tracker) {
+    GM_RUNONCE(GM_WRN("PoseHistoryTracker", "No pose tracker to keep history of."));
+    return;
+  }
+
+  if (!histories_storage) allocate();
+
+  auto state = tracker->get();
+  if (!state) return;
+
+  History *begin = histories_storage.get();
+  size_t count = key_count.load(std::memory_order_relaxed);
+
+  for (const auto &sample : *state) {
+
+    History *history = nullptr;
+    for (size_t idx = 0; idx < count; ++idx)
+      if (begin[idx].key == sample.first) {
+        history = begin + idx;
+        break;
+      }
+
+    if (!history) {
+      if (count == key_capacity) {
+        GM_RUNONCE(GM_WRN("PoseHistoryTracker",
+                          "More than " << key_capacity << " keys; ignoring "
+                          << sample.first));
+        continue;
+      }
+      history = begin + count;
+      history->key = sample.first;
+      key_count.store(++count, std::memory_order_release);
+    } else if (sample.second.time <= history->last_time) {
+      continue;
+    }
+
+    write(*history, sample.second.time, sample.second.value);
+  }
+}
+
+void PoseHistoryTracker::Impl::write(History &history,
+                                     clock::time_point time,
+                                     const gmCore::Pose &pose) {
+
+  const uint64_t idx = history.count.load(std::memory_order_relaxed);
+  Slot &slot = history.slots[idx % capacity];
+
+  slot.sequence.store(2 * idx + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+  const float values[7] = { pose.position.x(), pose.position.y(), pose.position.z(),
+                            pose.orientation.w(), pose.orientation.x(),
+                            pose.orientation.y(), pose.orientation.z() };
+  for (size_t jdx = 0; jdx < 7; ++jdx)
+    slot.values[jdx].store(values[jdx], std::memory_order_relaxed);
+
+  slot.sequence.store(2 * idx + 2, std::memory_order_release);
+  history.count.store(idx + 1, std::memory_order_release);
+  history.last_time = time;
+}
+
+bool PoseHistoryTracker::Impl::read(const History &history,
+                                    uint64_t idx,
+                                    Sample &sample) const {
+
+  const Slot &slot = history.slots[idx % capacity];
+
+  if (slot.sequence.load(std::memory_order_acquire) != 2 * idx + 2) return false;
+
+  clock::rep time = slot.time.load(std::memory_order_relaxed);
+  float values[7];
+  for (size_t jdx = 0; jdx < 7; ++jdx)
+    values[jdx] = slot.values[jdx].load(std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != 2 * idx + 2) return false;
+
+  sample.time = clock::time_point(clock::duration(time));
+  sample.pose.position = Eigen::Vector3f(values[0], values[1], values[2]);
+  sample.pose.orientation =
+      Eigen::Quaternionf(values[3], values[4], values[5], values[6]);
+  return true;
+}
+
+bool PoseHistoryTracker::Impl::getAt(const History &history,
+                                     clock::time_point time,
+                                     gmCore::Pose &pose) const {
+
+  const uint64_t count = history.count.load(std::memory_order_acquire);
+  if (count == 0) return false;
+
+  Sample last;
+  if (!read(history, count - 1, last)) return false;
+
+  Sample a, b;
+
+  if (time >= last.time) {
+    // Extrapolate from the two latest samples
+    if (count < 2 || !read(history, count - 2, a) || a.time >= last.time) {
+      pose = last.pose;
+      return true;
+    }
+    b = last;
+    time = std::min(time,
+                    last.time + std::chrono::duration_cast<clock::duration>(
+                                    std::chrono::duration<double>(max_extrapolation)));
+  } else {
+    // Binary search for the latest sample not after the time, in
+    // the part of the ring that has not been overwritten
+    uint64_t first = count > capacity ? count - capacity : 0;
+    uint64_t last_idx = count - 1;
+
+    // The oldest sample may be overwritten while reading
+    if (!read(history, first, a) && !read(history, ++first, a)) return false;
+    if (time < a.time) return false;
+
+    while (last_idx - first > 1) {
+      uint64_t middle = first + (last_idx - first) / 2;
+      Sample sample;
+      if (!read(history, middle, sample)) return false;
+      if (sample.time <= time) {
+        first = middle;
+        a = sample;
+      } else {
+        last_idx = middle;
+      }
+    }
+
+    if (!read(history, last_idx, b)) return false;
+  }
+
+  typedef std::chrono::duration<double> d_seconds;
+  const double r = std::chrono::duration_cast<d_seconds>(time - a.time).count() /
+                   std::chrono::duration_cast<d_seconds>(b.time - a.time).count();
+
+  pose.position = a.pose.position + float(r) * (b.pose.position - a.pose.position);
+  pose.orientation = a.pose.orientation.slerp(float(r), b.pose.orientation);
+  return true;
+}
+
+bool PoseHistoryTracker::getAt(const std::string &key,
+                               clock::time_point time,
+                               gmCore::Pose &pose) {
+
+  const Impl::History *histories = _impl->histories.load(std::memory_order_acquire);
+  if (!histories) return false;
+
+  const size_t count = _impl->key_count.load(std::memory_order_acquire);
+  for (size_t idx = 0; idx < count; ++idx)
+    if (histories[idx].key == key)
+      return _impl->getAt(histories[idx], time, pose);
+
+  return false;
+}
+
+std::optional<PoseTracker::State> PoseHistoryTracker::getAt(clock::time_point time) {
+
+  const Impl::History *histories = _impl->histories.load(std::memory_order_acquire);
+  if (!histories) return std::nullopt;
+
+  State state;
+  const size_t count = _impl->key_count.load(std::memory_order_acquire);
+  gmCore::Pose pose;
+  for (size_t idx = 0; idx < count; ++idx)
+    if (_impl->getAt(histories[idx], time, pose))
+      state[histories[idx].key] = { time, pose };
+
+  return state;
+}
+
+std::optional<PoseTracker::State> PoseHistoryTracker::get() {
+
+  const Impl::History *histories = _impl->histories.load(std::memory_order_acquire);
+  if (!histories) return std::nullopt;
+
+  State state;
+  const size_t count = _impl->key_count.load(std::memory_order_acquire);
+  Impl::Sample sample;
+  for (size_t idx = 0; idx < count; ++idx) {
+    uint64_t samples = histories[idx].count.load(std::memory_order_acquire);
+    if (samples > 0 && _impl->read(histories[idx], samples - 1, sample))
+      state[histories[idx].key] = { sample.time, sample.pose };
+  }
+
+  return state;
+}
+
+void PoseHistoryTracker::setPoseTracker(std::shared_ptr<PoseTracker> tracker) {
+  _impl->tracker = tracker;
+}
+
+void PoseHistoryTracker::setCapacity(size_t n) {
+  if (n < 2) throw gmCore::InvalidArgument("History capacity must be at least 2");
+  if (_impl->histories_storage)
+    throw gmCore::PreConditionViolation("Cannot change capacity after first update");
+  _impl->capacity = n;
+}
+
+void PoseHistoryTracker::setKeyCapacity(size_t n) {
+  if (n == 0) throw gmCore::InvalidArgument("Key capacity must be positive");
+  if (_impl->histories_storage)
+    throw gmCore::PreConditionViolation("Cannot change key capacity after first update");
+  _impl->key_capacity = n;
+}
+
+void PoseHistoryTracker::setMaxExtrapolation(double seconds) {
+  if (seconds < 0) throw gmCore::InvalidArgument("Extrapolation time cannot be negative");
+  _impl->max_extrapolation = seconds;
+}
+
+void PoseHistoryTracker::traverse(Visitor *visitor) {
+  if (_impl->tracker) _impl->tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
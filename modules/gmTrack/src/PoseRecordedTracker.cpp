@@ -0,0 +1,13 @@
+
+#include <gmCore/io_eigen.hh>
+
+#include <gmTrack/PoseRecordedTracker.hh>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(PoseRecordedTracker);
+GM_OFI_PARAM2(PoseRecordedTracker, file, std::filesystem::path, setFile);
+GM_OFI_PARAM2(PoseRecordedTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(PoseRecordedTracker, loop, bool, setLoop);
+
+END_NAMESPACE_GMTRACK;
@@ -7,7 +7,9 @@
 #include <gmCore/Console.hh>
 
 #include <Eigen/LU>
+#include <Eigen/Eigenvalues>
 
+#include <algorithm>
 #include <limits>
 #include <type_traits>
 
@@ -92,6 +94,7 @@ void PoseSampleCollector::Impl::update(clock::time_point now) {
   if (!collecting) {
     if (buttons.value()[StdKey::MAIN_BUTTON].value) {
       collecting = true;
+      accumulator = Accumulator();
       GM_INF("PoseSampleCollector", "going into collect mode");
     } else {
       return;
@@ -104,8 +107,7 @@ void PoseSampleCollector::Impl::update(clock::time_point now) {
     if (samples_per_second < std::numeric_limits<float>::epsilon()) {
       if (last_sample_time == clock::time_point::min()) {
         GM_DBG1("PoseSampleCollector", "collecting a single sample");
-        sample_positions.push_back(pose.position);
-        sample_orientations.push_back(pose.orientation);
+        collectSample(pose);
       }
       last_sample_time = now;
       return;
@@ -117,8 +119,7 @@ void PoseSampleCollector::Impl::update(clock::time_point now) {
       return;
 
     GM_DBG1("PoseSampleCollector", "collecting sample");
-    sample_positions.push_back(pose.position);
-    sample_orientations.push_back(pose.orientation);
+    collectSample(pose);
     last_sample_time = now;
 
     return;
@@ -129,53 +130,167 @@ void PoseSampleCollector::Impl::update(clock::time_point now) {
   collecting = false;
   last_sample_time = clock::time_point::min();
 
-  if (sample_positions.empty()) {
+  if (!accumulator.seeded) seed();
+
+  if (accumulator.count == 0) {
     GM_RUNONCE(GM_ERR("PoseSampleCollector", "No samples collected"));
     return;
   }
 
-  float stddev, maxdev;
-  size_t inlier_count;
-  Eigen::Vector3f pos = getAverage(
-      sample_positions, &stddev, &maxdev, inlier_threshold, &inlier_count);
+  const size_t total_count = accumulator.count + accumulator.rejected_count;
+
+  Eigen::Vector3f pos = accumulator.mean.cast<float>();
   tracker_positions.push_back(pos);
 
+  float stddev = float(accumulator.getPositionDeviation());
+  float maxdev = float(accumulator.max_position_deviation);
   if (maxdev > warning_threshold) {
     GM_WRN("PoseSampleCollector",
            "Estimated mean, " << pos.transpose() << " (stddev " << stddev
                               << "), has worst offset " << maxdev << " in "
-                              << inlier_count << " of "
-                              << sample_positions.size() << " samples.");
+                              << accumulator.count << " of "
+                              << total_count << " samples.");
   } else {
     GM_INF("PoseSampleCollector",
            "Estimated mean: " << pos.transpose() << " (stddev " << stddev
                               << ", worst offset " << maxdev << ") from "
-                              << inlier_count << " of "
-                              << sample_positions.size() << " samples.");
+                              << accumulator.count << " of "
+                              << total_count << " samples.");
   }
-  sample_positions.clear();
 
-  Eigen::Quaternionf ori = getAverage(sample_orientations,
-                                      &stddev,
-                                      &maxdev,
-                                      orientation_inlier_threshold,
-                                      &inlier_count);
+  Eigen::Quaternionf ori = accumulator.orientation.cast<float>();
   tracker_orientations.push_back(ori);
 
+  stddev = float(accumulator.getOrientationDeviation());
+  maxdev = float(accumulator.max_orientation_deviation);
   if (maxdev > orientation_warning_threshold) {
     GM_WRN("PoseSampleCollector",
            "Estimated orientation (stddev "
                << stddev << "), has worst offset " << maxdev << " in "
-               << inlier_count << " of " << sample_orientations.size()
+               << accumulator.count << " of " << total_count
                << " samples.");
   } else {
     GM_INF("PoseSampleCollector",
            "Estimated orientation (stddev "
                << stddev << ", worst offset " << maxdev << ") from "
-               << inlier_count << " of " << sample_orientations.size()
+               << accumulator.count << " of " << total_count
                << " samples.");
   }
-  sample_orientations.clear();
+}
+
+void PoseSampleCollector::Impl::collectSample(const gmCore::Pose &pose) {
+
+  Accumulator &acc = accumulator;
+  if (acc.seeded) {
+    checkSample(pose);
+    return;
+  }
+
+  acc.seed_samples.push_back(pose);
+  if (acc.seed_samples.size() >= SEED_SAMPLES) seed();
+}
+
+void PoseSampleCollector::Impl::seed() {
+
+  Accumulator &acc = accumulator;
+  acc.seeded = true;
+  if (acc.seed_samples.empty()) return;
+
+  const size_t N = acc.seed_samples.size();
+
+  // Median position, per component
+
+  std::vector<float> values(N);
+  for (Eigen::Index dim = 0; dim < 3; ++dim) {
+    for (size_t idx = 0; idx < N; ++idx)
+      values[idx] = acc.seed_samples[idx].position[dim];
+    std::nth_element(values.begin(), values.begin() + N / 2, values.end());
+    acc.seed_position[dim] = values[N / 2];
+  }
+
+  // Medoid orientation, i.e. the sample closest to all the others
+
+  double best_sum = std::numeric_limits<double>::max();
+  for (size_t idx = 0; idx < N; ++idx) {
+    double sum = 0.0;
+    for (size_t jdx = 0; jdx < N; ++jdx)
+      sum += acc.seed_samples[idx].orientation.angularDistance(
+          acc.seed_samples[jdx].orientation);
+    if (sum >= best_sum) continue;
+    best_sum = sum;
+    acc.seed_orientation = acc.seed_samples[idx].orientation.cast<double>().normalized();
+  }
+
+  for (const auto &pose : acc.seed_samples)
+    checkSample(pose);
+  acc.seed_samples.clear();
+}
+
+void PoseSampleCollector::Impl::checkSample(const gmCore::Pose &pose) {
+
+  Accumulator &acc = accumulator;
+
+  Eigen::Vector3d position = pose.position.cast<double>();
+  Eigen::Quaterniond orientation = pose.orientation.cast<double>().normalized();
+
+  // Gate against the seed until the running averages have settled
+  bool settled = acc.count >= MIN_GATE_SAMPLES;
+  double position_deviation =
+    (position - (settled ? acc.mean : acc.seed_position)).norm();
+  double orientation_deviation =
+    (settled ? acc.orientation : acc.seed_orientation).angularDistance(orientation);
+
+  if ((inlier_threshold > 0.f && position_deviation > inlier_threshold) ||
+      (orientation_inlier_threshold > 0.f &&
+       orientation_deviation > orientation_inlier_threshold)) {
+    GM_DBG2("PoseSampleCollector",
+            "dropped outlier sample (" << position_deviation << " from mean position, "
+            << orientation_deviation << " radians from average orientation)");
+    ++acc.rejected_count;
+    return;
+  }
+
+  addSample(pose);
+}
+
+void PoseSampleCollector::Impl::addSample(const gmCore::Pose &pose) {
+
+  Accumulator &acc = accumulator;
+
+  Eigen::Vector3d position = pose.position.cast<double>();
+  Eigen::Quaterniond orientation = pose.orientation.cast<double>().normalized();
+
+  double position_deviation = acc.count ? (position - acc.mean).norm() : 0.0;
+  double orientation_deviation =
+    acc.count ? acc.orientation.angularDistance(orientation) : 0.0;
+
+  ++acc.count;
+  Eigen::Vector3d delta = position - acc.mean;
+  acc.mean += delta / double(acc.count);
+  acc.scatter += delta * (position - acc.mean).transpose();
+
+  Eigen::Vector4d q = orientation.coeffs();
+  acc.orientation_scatter += q * q.transpose();
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> solver(acc.orientation_scatter);
+  acc.orientation.coeffs() = solver.eigenvectors().col(3);
+  acc.orientation_eigenvalue = solver.eigenvalues()[3];
+
+  acc.max_position_deviation = std::max(acc.max_position_deviation, position_deviation);
+  acc.max_orientation_deviation =
+    std::max(acc.max_orientation_deviation, orientation_deviation);
+}
+
+double PoseSampleCollector::Impl::Accumulator::getPositionDeviation() const {
+  if (count == 0) return 0.0;
+  return std::sqrt(scatter.trace() / double(count));
+}
+
+double PoseSampleCollector::Impl::Accumulator::getOrientationDeviation() const {
+  if (count == 0) return 0.0;
+  // The eigenvalue over the count is the mean squared cosine of the
+  // half angle between the samples and the average
+  double sqr_sin = std::clamp(1.0 - orientation_eigenvalue / double(count), 0.0, 1.0);
+  return 2.0 * std::asin(std::sqrt(sqr_sin));
 }
 
 Eigen::Vector3f
@@ -343,6 +458,26 @@ PoseSampleCollector::getAverage(std::vector<Eigen::Quaternionf> samples,
   return x;
 }
 
+bool PoseSampleCollector::isCollecting() const {
+  return _impl->collecting;
+}
+
+size_t PoseSampleCollector::getSampleCount() const {
+  return _impl->accumulator.count + _impl->accumulator.seed_samples.size();
+}
+
+size_t PoseSampleCollector::getRejectedSampleCount() const {
+  return _impl->accumulator.rejected_count;
+}
+
+float PoseSampleCollector::getPositionDeviation() const {
+  return float(_impl->accumulator.getPositionDeviation());
+}
+
+float PoseSampleCollector::getOrientationDeviation() const {
+  return float(_impl->accumulator.getOrientationDeviation());
+}
+
 const std::vector<Eigen::Vector3f> &
 PoseSampleCollector::getTrackerPositions() const {
   return _impl->tracker_positions;
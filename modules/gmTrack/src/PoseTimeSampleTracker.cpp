@@ -10,6 +10,9 @@ GM_OFI_DEFINE(PoseTimeSampleTracker);
 GM_OFI_PARAM2(PoseTimeSampleTracker, key, std::string, addKey);
 GM_OFI_PARAM2(PoseTimeSampleTracker, value, gmCore::Pose, addValue);
 GM_OFI_PARAM2(PoseTimeSampleTracker, time, double, addTime);
+GM_OFI_PARAM2(PoseTimeSampleTracker, sampleFile, std::filesystem::path, setSampleFile);
+GM_OFI_PARAM2(PoseTimeSampleTracker, speed, double, setSpeed);
+GM_OFI_PARAM2(PoseTimeSampleTracker, loop, bool, setLoop);
 
 template<>
 gmCore::Pose TimeSampleTracker<gmCore::Pose>::Impl::interpolate(gmCore::Pose a,
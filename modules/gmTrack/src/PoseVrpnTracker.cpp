@@ -10,6 +10,7 @@ BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE(PoseVrpnTracker);
 GM_OFI_PARAM2(PoseVrpnTracker, connectionString, std::string, addConnectionString);
+GM_OFI_PARAM2(PoseVrpnTracker, threaded, bool, setThreaded);
 
 template<>
 void VrpnTracker<gmCore::Pose, vrpn_Tracker_Remote, vrpn_TRACKERCB>::Impl::
@@ -0,0 +1,218 @@
+#include <gmTrack/PredictivePoseTracker.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/RunOnce.hh>
+
+#include <gmMisc/EFFOAW.hh>
+#include <gmMisc/EFHOAW.hh>
+
+#include <mutex>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(PredictivePoseTracker);
+GM_OFI_POINTER2(PredictivePoseTracker, poseTracker, PoseTracker, setPoseTracker);
+GM_OFI_PARAM2(PredictivePoseTracker, latency, double, setLatency);
+GM_OFI_PARAM2(PredictivePoseTracker, order, size_t, setOrder);
+GM_OFI_PARAM2(PredictivePoseTracker, positionError, double, setPositionError);
+GM_OFI_PARAM2(PredictivePoseTracker, orientationError, double, setOrientationError);
+GM_OFI_PARAM2(PredictivePoseTracker, historyLength, size_t, setHistoryLength);
+GM_OFI_PARAM2(PredictivePoseTracker, historyDuration, double, setHistoryDuration);
+
+struct PredictivePoseTracker::Impl {
+
+  std::optional<State> get();
+
+  void addSample(const std::string &key, const Sample &sample);
+  void predict(const std::string &key, gmCore::Pose &pose);
+
+  Eigen::Vector3d estimateOffset(size_t id, double error);
+
+  double toSeconds(clock::time_point t) const {
+    return std::chrono::duration<double>(t - epoch).count();
+  }
+
+  std::shared_ptr<PoseTracker> tracker;
+
+  double latency = 0.03;
+  size_t order = 1;
+  double position_error = 0.001;
+  double orientation_error = 0.005;
+  size_t history_length = 10;
+  double history_duration = 0.2;
+
+  /**
+     Estimator ids and the latest sample of a key. Orientations are
+     estimated from the rotation vector accumulated over the
+     samples.
+  */
+  struct KeyData {
+    size_t position_id;
+    size_t rotation_id;
+    double time;
+    Eigen::Quaterniond orientation;
+    Eigen::Vector3d rotation = Eigen::Vector3d::Zero();
+  };
+  std::unordered_map<std::string, KeyData> keys;
+
+  clock::time_point epoch;
+
+  gmMisc::EFFOAW effoaw;
+  gmMisc::EFHOAW efhoaw;
+
+  /// Guards the key data and estimators above, since trackers may
+  /// be read from several threads, e.g. by Updateables updated in
+  /// parallel
+  std::mutex lock;
+};
+
+PredictivePoseTracker::PredictivePoseTracker() : _impl(std::make_unique<Impl>()) {
+  setHistoryLength(_impl->history_length);
+  setHistoryDuration(_impl->history_duration);
+}
+
+PredictivePoseTracker::~PredictivePoseTracker() {}
+
+std::optional<PoseTracker::State> PredictivePoseTracker::get() {
+  return _impl->get();
+}
+
+std::optional<PoseTracker::State> PredictivePoseTracker::Impl::get() {
+
+  std::lock_guard<std::mutex> guard(lock);
+
+  if (!tracker) {
+    GM_RUNONCE(GM_WRN("PredictivePoseTracker", "Pose requested but no pose tracker available."));
+    return std::nullopt;
+  }
+
+  auto state = tracker->get();
+  if (!state) return std::nullopt;
+
+  for (auto &sample : *state) {
+    addSample(sample.first, sample.second);
+    predict(sample.first, sample.second.value);
+  }
+
+  return state;
+}
+
+void PredictivePoseTracker::Impl::addSample(const std::string &key,
+                                            const Sample &sample) {
+
+  if (keys.empty()) epoch = sample.time;
+  const double time = toSeconds(sample.time);
+
+  auto it = keys.find(key);
+  if (it == keys.end()) {
+    KeyData data;
+    data.position_id = 2 * keys.size();
+    data.rotation_id = 2 * keys.size() + 1;
+    data.time = time;
+    data.orientation = sample.value.orientation.cast<double>();
+    it = keys.emplace(key, data).first;
+  } else {
+    KeyData &data = it->second;
+    if (time <= data.time) return;
+
+    // Accumulate the rotation since the previous sample, in world
+    // coordinates, along the shortest arc
+    Eigen::Quaterniond orientation = sample.value.orientation.cast<double>();
+    Eigen::Quaterniond delta = orientation * data.orientation.conjugate();
+    if (delta.w() < 0) delta.coeffs() = -delta.coeffs();
+    Eigen::AngleAxisd aa(delta);
+    data.rotation += aa.angle() * aa.axis();
+
+    data.time = time;
+    data.orientation = orientation;
+  }
+
+  KeyData &data = it->second;
+  Eigen::Vector3d position = sample.value.position.cast<double>();
+
+  if (order <= 1) {
+    effoaw.addSample(data.position_id, position, time);
+    effoaw.addSample(data.rotation_id, data.rotation, time);
+  } else {
+    efhoaw.addSample(data.position_id, position, time);
+    efhoaw.addSample(data.rotation_id, data.rotation, time);
+  }
+
+  // Keeps the history within its length and duration
+  if (order <= 1) effoaw.cleanup(time);
+  else efhoaw.cleanup(time);
+}
+
+Eigen::Vector3d PredictivePoseTracker::Impl::estimateOffset(size_t id,
+                                                            double error) {
+  if (order <= 1)
+    return latency * effoaw.estimateVelocity(id, error);
+
+  auto coefficients = efhoaw.estimateCoefficients(id, error, order);
+  if (coefficients.cols() == 0) return Eigen::Vector3d::Zero();
+
+  // The fit need not pass through the latest sample, so only its
+  // change over the latency is used
+  double time = efhoaw.getLastSampleTime(id);
+  return efhoaw.getPolynomialPosition(int(id), time + latency) -
+         efhoaw.getPolynomialPosition(int(id), time);
+}
+
+void PredictivePoseTracker::Impl::predict(const std::string &key,
+                                          gmCore::Pose &pose) {
+
+  const KeyData &data = keys.at(key);
+
+  Eigen::Vector3d position_offset = estimateOffset(data.position_id, position_error);
+  pose.position += position_offset.cast<float>();
+
+  Eigen::Vector3d rotation_offset = estimateOffset(data.rotation_id, orientation_error);
+  double angle = rotation_offset.norm();
+  if (angle > std::numeric_limits<double>::epsilon())
+    pose.orientation =
+        (Eigen::AngleAxisd(angle, rotation_offset / angle) *
+         pose.orientation.cast<double>()).cast<float>().normalized();
+}
+
+void PredictivePoseTracker::setPoseTracker(std::shared_ptr<PoseTracker> tracker) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->tracker = tracker;
+}
+
+void PredictivePoseTracker::setLatency(double seconds) {
+  _impl->latency = seconds;
+}
+
+void PredictivePoseTracker::setOrder(size_t order) {
+  if (order == 0) throw gmCore::InvalidArgument("Estimation order must be at least 1");
+  _impl->order = order;
+}
+
+void PredictivePoseTracker::setPositionError(double e) {
+  _impl->position_error = e;
+}
+
+void PredictivePoseTracker::setOrientationError(double e) {
+  _impl->orientation_error = e;
+}
+
+void PredictivePoseTracker::setHistoryLength(size_t n) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->history_length = n;
+  _impl->effoaw.setHistoryLength(n);
+  _impl->efhoaw.setHistoryLength(n);
+}
+
+void PredictivePoseTracker::setHistoryDuration(double seconds) {
+  std::lock_guard<std::mutex> guard(_impl->lock);
+  _impl->history_duration = seconds;
+  _impl->effoaw.setHistoryDuration(seconds);
+  _impl->efhoaw.setHistoryDuration(seconds);
+}
+
+void PredictivePoseTracker::traverse(Visitor *visitor) {
+  if (_impl->tracker) _impl->tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
@@ -9,15 +9,17 @@
 #include <gmCore/Console.hh>
 #include <gmCore/PreConditionViolation.hh>
 #include <gmCore/io_float.hh>
-#include <gmCore/MathConstants.hh>
+#include <gmCore/JobSystem.hh>
 
 #include <gmMisc/PolyFit.hh>
 
 #include <gmCore/FreeImage.hh>
 #include <FreeImage.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
-//#include <type_traits>
+#include <mutex>
 
 BEGIN_NAMESPACE_GMTRACK;
 
@@ -44,7 +46,14 @@ struct ProjectionTextureGenerator::Impl : PoseSampleCollector::Impl {
   void addRegion(size_t order);
   void saveImage();
   void checkPreconditions();
-  size_t getRegionIdx(Eigen::Vector2f pt0);
+
+  /**
+     Sets the index of the region covering each pixel of the row at
+     the specified height, or max size_t for pixels outside all
+     regions, by intersecting the row with the region hulls. Where
+     regions overlap the later one is used.
+  */
+  void getRowRegions(double y, std::vector<size_t> &regions) const;
 };
 
 ProjectionTextureGenerator::ProjectionTextureGenerator()
@@ -162,24 +171,12 @@ void ProjectionTextureGenerator::Impl::saveImage() {
     }
   }
 
-  std::vector<gmCore::float3> image_data;
-  image_data.reserve(resolution[0] * resolution[1]);
-
-  for (size_t idx_y = 0; idx_y < resolution[1]; ++idx_y)
-    for (size_t idx_x = 0; idx_x < resolution[0]; ++idx_x) {
+  for (auto &poly : polys) poly->estimateCoefficients();
 
-      auto x = idx_x / (double)resolution[0];
-      auto y = idx_y / (double)resolution[1];
+  std::shared_ptr<gmCore::FreeImage> freeimage = gmCore::FreeImage::get();
 
-      size_t closest = getRegionIdx({x, y});
-      if (closest == std::numeric_limits<size_t>::max()) {
-        auto nan = std::numeric_limits<float>::quiet_NaN();
-        image_data.push_back({nan, nan, nan});
-      } else {
-        auto res = polys[closest]->getValue({x, y});
-        image_data.push_back({(float)res[0], (float)res[1], (float)res[2]});
-      }
-    }
+  FIBITMAP *bitmap =
+      FreeImage_AllocateT(FIT_RGBF, resolution[0], resolution[1], 3*32);
 
   std::array<float, 3> min = {
       std::numeric_limits<float>::max(),
@@ -187,20 +184,81 @@ void ProjectionTextureGenerator::Impl::saveImage() {
       std::numeric_limits<float>::max(),
   };
   std::array<float, 3> max = {
-      std::numeric_limits<float>::min(),
-      std::numeric_limits<float>::min(),
-      std::numeric_limits<float>::min(),
+      std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest(),
   };
-
-#define IDX(X,Y) ((X) + resolution[1] * (Y))
-
-  for (size_t idx_y = 0; idx_y < resolution[1]; ++idx_y)
-    for (size_t idx_x = 0; idx_x < resolution[0]; ++idx_x)
-      for (size_t idx_D = 0; idx_D < 3; ++idx_D) {
-        auto res = image_data[IDX(idx_x, idx_y)][idx_D];
-        min[idx_D] = std::min(min[idx_D], res);
-        max[idx_D] = std::max(max[idx_D], res);
+  std::mutex range_lock;
+
+  const size_t width = resolution[0];
+  auto job_system = gmCore::JobSystem::get();
+
+  // Rows are written straight into the bitmap, evaluating each run of
+  // pixels in the same region as one batch
+  job_system->parallelFor(0, resolution[1], [&](size_t begin, size_t end) {
+
+    std::vector<size_t> regions(width);
+    std::vector<double> in_values(2 * width);
+    std::vector<double> out_values(3 * width);
+
+    // Merged into the shared range, under lock, when the chunk is done
+    std::array<float, 3> chunk_min = {
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(),
+    };
+    std::array<float, 3> chunk_max = {
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest(),
+    };
+
+    for (size_t idx_y = begin; idx_y < end; ++idx_y) {
+
+      const double y = idx_y / (double)resolution[1];
+      getRowRegions(y, regions);
+
+      float *row = (float *)FreeImage_GetScanLine(bitmap, int(idx_y));
+
+      size_t run_begin = 0;
+      while (run_begin < width) {
+
+        const size_t region = regions[run_begin];
+        size_t run_end = run_begin + 1;
+        while (run_end < width && regions[run_end] == region) ++run_end;
+
+        if (region == std::numeric_limits<size_t>::max()) {
+          std::fill(row + 3 * run_begin, row + 3 * run_end,
+                    std::numeric_limits<float>::quiet_NaN());
+          run_begin = run_end;
+          continue;
+        }
+
+        const size_t count = run_end - run_begin;
+        for (size_t idx = 0; idx < count; ++idx) {
+          in_values[2 * idx] = (run_begin + idx) / (double)width;
+          in_values[2 * idx + 1] = y;
+        }
+
+        polys[region]->getValues(in_values.data(), out_values.data(), count);
+
+        for (size_t idx = 0; idx < 3 * count; ++idx) {
+          float value = (float)out_values[idx];
+          row[3 * run_begin + idx] = value;
+          chunk_min[idx % 3] = std::min(chunk_min[idx % 3], value);
+          chunk_max[idx % 3] = std::max(chunk_max[idx % 3], value);
+        }
+
+        run_begin = run_end;
       }
+    }
+
+    std::lock_guard<std::mutex> guard(range_lock);
+    for (size_t idx_D = 0; idx_D < 3; ++idx_D) {
+      min[idx_D] = std::min(min[idx_D], chunk_min[idx_D]);
+      max[idx_D] = std::max(max[idx_D], chunk_max[idx_D]);
+    }
+  });
 
   scale = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
   offset = {min[0], min[1], min[2]};
@@ -211,20 +269,13 @@ void ProjectionTextureGenerator::Impl::saveImage() {
       1.f / scale[2]
   };
 
-  for (size_t idx_y = 0; idx_y < resolution[1]; ++idx_y)
-    for (size_t idx_x = 0; idx_x < resolution[0]; ++idx_x)
-      for (size_t idx_D = 0; idx_D < 3; ++idx_D)
-        image_data[IDX(idx_x, idx_y)][idx_D] =
-            rescale[idx_D] *
-            (image_data[IDX(idx_x, idx_y)][idx_D] - offset[idx_D]);
-
-  std::shared_ptr<gmCore::FreeImage> freeimage = gmCore::FreeImage::get();
-
-  FIBITMAP *bitmap =
-      FreeImage_AllocateT(FIT_RGBF, resolution[0], resolution[1], 3*32);
-  memcpy(FreeImage_GetBits(bitmap),
-         image_data.data(),
-         resolution[0] * resolution[1] * 3 * 4);
+  job_system->parallelFor(0, resolution[1], [&](size_t begin, size_t end) {
+    for (size_t idx_y = begin; idx_y < end; ++idx_y) {
+      float *row = (float *)FreeImage_GetScanLine(bitmap, int(idx_y));
+      for (size_t idx = 0; idx < 3 * width; ++idx)
+        row[idx] = rescale[idx % 3] * (row[idx] - offset[idx % 3]);
+    }
+  });
 
   bool success = FreeImage_Save(FIF_TIFF, bitmap, file.string().c_str(), TIFF_LZW);
 
@@ -283,64 +334,59 @@ void ProjectionTextureGenerator::Impl::checkPreconditions() {
   }
 }
 
-namespace {
-int wind_diff(int q0, int q1, Eigen::Vector2f pt0, Eigen::Vector2f pt1) {
+void ProjectionTextureGenerator::Impl::getRowRegions(double y,
+                                                     std::vector<size_t> &regions) const {
 
-  if (q0 == q1) return 0;
+  const size_t width = regions.size();
 
-  int q_diff = q1 - q0;
-  if (-4 < q_diff && q_diff < 4) return q_diff;
-  if (q_diff > 4) return q_diff - 8;
-  if (q_diff < -4) return q_diff + 8;
-
-  float a0 = std::atan2(pt0[1], pt0[0]);
-  float a1 = std::atan2(pt1[1], pt1[0]);
-  if (a0 > a1) return (a0 - a1) > GM_PI ? 4 : -4;
-  else return (a1 - a0) < GM_PI ? 4 : -4;
-}
-}
+  if (region_positions.size() == 1) {
+    std::fill(regions.begin(), regions.end(), 0);
+    return;
+  }
 
-size_t ProjectionTextureGenerator::Impl::getRegionIdx(Eigen::Vector2f ptq) {
+  std::fill(regions.begin(), regions.end(), std::numeric_limits<size_t>::max());
 
-  if (region_positions.size() == 1) return 0;
+  // Crossings of the row with the hull edges and their direction,
+  // for a non-zero winding rule
+  std::vector<std::pair<double, int>> crossings;
 
-  size_t region = std::numeric_limits<size_t>::max();
+  for (size_t idx_R = 0; idx_R < region_order.size(); ++idx_R) {
 
-  /// Non-trigonometric winding using octant instead of angle (higher
-  /// resolution quadrant) summarizing to 0 or ±8
-#define Q(X, Y)                                                                \
-  (((X) >= 0.f && (Y) >= 0.f)  ? ((+X) > (+Y) ? 0 : 1)                         \
-   : ((X) < 0.f && (Y) >= 0.f) ? ((-X) > (+Y) ? 3 : 2)                         \
-   : ((X) < 0.f && (Y) < 0.f)  ? ((-X) > (-Y) ? 4 : 5)                         \
-                               : ((+X) > (-Y) ? 7 : 6))
+    const auto &hull = region_hull_positions[idx_R];
 
-  Eigen::Vector2f pt0, pt1;
-  for (size_t idx_R = 0; idx_R < region_order.size(); ++idx_R) {
+    crossings.clear();
+    for (size_t idx_H = 0; idx_H < hull.size(); ++idx_H) {
 
-    pt1 = region_hull_positions[idx_R].back() - ptq;
-    int q0 = Q(pt1[0], pt1[1]);
+      Eigen::Vector2d p0 = hull[idx_H].cast<double>();
+      Eigen::Vector2d p1 = hull[(idx_H + 1) % hull.size()].cast<double>();
 
-    pt0 = pt1;
-    pt1 = region_hull_positions[idx_R].front() - ptq;
-    int q1 = Q(pt1[0], pt1[1]);
+      if ((p0[1] <= y) == (p1[1] <= y)) continue;
 
-    int q_sum = wind_diff(q0, q1, pt0, pt1);
+      double x = p0[0] + (y - p0[1]) * (p1[0] - p0[0]) / (p1[1] - p0[1]);
+      crossings.push_back({x, p1[1] > p0[1] ? 1 : -1});
+    }
 
-    for (size_t idx_H = 1; idx_H < region_hull_positions[idx_R].size(); ++idx_H) {
+    std::sort(crossings.begin(), crossings.end());
 
-      q0 = q1;
-      pt0 = pt1;
+    int winding = 0;
+    double span_begin = 0.0;
+    for (const auto &crossing : crossings) {
 
-      pt1 = region_hull_positions[idx_R][idx_H] - ptq;
-      q1 = Q(pt1[0], pt1[1]);
+      int previous = winding;
+      winding += crossing.second;
 
-      q_sum += wind_diff(q0, q1, pt0, pt1);
+      if (previous == 0 && winding != 0) {
+        span_begin = crossing.first;
+      } else if (previous != 0 && winding == 0) {
+        // Pixels at x = idx / width within [span_begin, x)
+        double first = std::ceil(span_begin * width);
+        double last = std::ceil(crossing.first * width);
+        size_t idx_begin = size_t(std::clamp(first, 0.0, double(width)));
+        size_t idx_end = size_t(std::clamp(last, 0.0, double(width)));
+        std::fill(regions.begin() + idx_begin, regions.begin() + idx_end, idx_R);
+      }
     }
-
-    if (std::fabs(q_sum) == 8) region = idx_R;
   }
-
-  return region;
 }
 
 END_NAMESPACE_GMTRACK;
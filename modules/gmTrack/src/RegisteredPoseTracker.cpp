@@ -6,7 +6,9 @@
 #include <gmCore/RunOnce.hh>
 
 #include <gmCore/io_eigen.hh>
+#include <gmCore/PoseArray.hh>
 
+#include <algorithm>
 #include <unordered_set>
 
 BEGIN_NAMESPACE_GMTRACK;
@@ -22,10 +24,17 @@ GM_OFI_PARAM2(RegisteredPoseTracker, orientationBias, Eigen::Quaternionf, setOri
 struct RegisteredPoseTracker::Impl {
 
   std::optional<State> get();
+  bool getFlat(FlatState &state);
+
+  /**
+     Registers the specified samples in one batch, in place.
+  */
+  void registerPoses(const std::vector<Sample *> &targets);
 
   std::shared_ptr<PoseTracker> tracker;
 
   std::unordered_set<std::string> keys;
+  std::vector<TrackerKey::Id> key_ids;
 
   Eigen::Matrix4f reg_matrix = Eigen::Matrix4f::Identity();
   Eigen::Matrix4f bias_matrix = Eigen::Matrix4f::Identity();
@@ -42,7 +51,8 @@ void RegisteredPoseTracker::setPoseTracker(std::shared_ptr<PoseTracker> tracker)
 }
 
 void RegisteredPoseTracker::addKey(std::string key) {
-  _impl->keys.insert(key);
+  if (_impl->keys.insert(key).second)
+    _impl->key_ids.push_back(TrackerKey::getId(key));
 }
 
 void RegisteredPoseTracker::setRegistrationMatrix(Eigen::Matrix4f m) {
@@ -66,6 +76,8 @@ void RegisteredPoseTracker::setOrientationBias(Eigen::Quaternionf q) {
 
 std::optional<PoseTracker::State> RegisteredPoseTracker::get() { return _impl->get(); }
 
+bool RegisteredPoseTracker::getFlat(FlatState &state) { return _impl->getFlat(state); }
+
 std::optional<PoseTracker::State> RegisteredPoseTracker::Impl::get() {
 
   if (!tracker) {
@@ -73,39 +85,57 @@ std::optional<PoseTracker::State> RegisteredPoseTracker::Impl::get() {
     return std::nullopt;
   }
 
-  auto raw_state = tracker->get();
-  if (!raw_state) return std::nullopt;
-
-  State reg_state;
-
-  if (keys.empty()) {
-    for (const auto as : raw_state.value()) {
-      const Eigen::Affine3f M = as.second.value.asMatrix();
-      reg_state[as.first] = {
-          .time = as.second.time,
-          .value = {
-              .position =
-                  (reg_matrix * M.matrix() * bias_matrix).block<3, 1>(0, 3),
-              .orientation =
-                  reg_rotation * as.second.value.orientation * bias_rotation}};
-    }
-  } else {
-    for (const auto as : raw_state.value())
-      if (!keys.contains(as.first)) {
-        reg_state[as.first] = as.second;
-      } else {
-        const Eigen::Affine3f M = as.second.value.asMatrix();
-        reg_state[as.first] = {
-            .time = as.second.time,
-            .value = {
-                .position =
-                    (reg_matrix * M.matrix() * bias_matrix).block<3, 1>(0, 3),
-                .orientation = reg_rotation * as.second.value.orientation *
-                               bias_rotation}};
-      }
+  auto state = tracker->get();
+  if (!state) return std::nullopt;
+
+  thread_local std::vector<Sample *> targets;
+  targets.clear();
+
+  for (auto &as : state.value())
+    if (keys.empty() || keys.contains(as.first))
+      targets.push_back(&as.second);
+
+  registerPoses(targets);
+  return state;
+}
+
+bool RegisteredPoseTracker::Impl::getFlat(FlatState &state) {
+
+  if (!tracker) {
+    GM_RUNONCE(GM_WRN("RegisteredPoseTracker", "Pose requested but no pose tracker available."));
+    return false;
   }
 
-  return reg_state;
+  if (!tracker->getFlat(state)) return false;
+
+  thread_local std::vector<Sample *> targets;
+  targets.clear();
+
+  for (auto &ks : state)
+    if (key_ids.empty() ||
+        std::find(key_ids.begin(), key_ids.end(), ks.key) != key_ids.end())
+      targets.push_back(&ks.sample);
+
+  registerPoses(targets);
+  return true;
+}
+
+void RegisteredPoseTracker::Impl::registerPoses(const std::vector<Sample *> &targets) {
+
+  thread_local gmCore::PoseArray poses;
+  poses.clear();
+
+  for (auto sample : targets)
+    poses.push_back(sample->value);
+
+  gmCore::PoseArray::compose(Eigen::Affine3f(reg_matrix),
+                             reg_rotation,
+                             poses,
+                             {bias_matrix.block<3, 1>(0, 3), bias_rotation},
+                             poses);
+
+  for (size_t idx = 0; idx < targets.size(); ++idx)
+    targets[idx]->value = poses.get(idx);
 }
 
 void RegisteredPoseTracker::traverse(Visitor *visitor) {
@@ -3,7 +3,10 @@
 
 #include <gmCore/RunOnce.hh>
 #include <gmCore/Console.hh>
+#include <gmCore/PoseArray.hh>
 
+#include <algorithm>
+#include <mutex>
 #include <unordered_set>
 
 BEGIN_NAMESPACE_GMTRACK;
@@ -17,11 +20,19 @@ GM_OFI_POINTER2(RelativePoseTracker, poseTracker, PoseTracker, setPoseTracker);
 struct RelativePoseTracker::Impl {
 
   std::optional<State> get();
+  bool getFlat(FlatState &state);
 
   std::optional<std::string> origin_key;
   std::unordered_set<std::string> relative_keys;
+  std::optional<TrackerKey::Id> origin_key_id;
+  std::vector<TrackerKey::Id> relative_key_ids;
   std::shared_ptr<PoseTracker> origin_tracker;
   std::shared_ptr<PoseTracker> pose_tracker;
+
+  /// State of the origin tracker, per instance since the origin
+  /// tracker may itself be a RelativePoseTracker
+  FlatState origin_buffer;
+  std::mutex origin_lock;
 };
 
 RelativePoseTracker::RelativePoseTracker() : _impl(std::make_unique<Impl>()) {}
@@ -31,6 +42,10 @@ std::optional<PoseTracker::State> RelativePoseTracker::get() {
   return _impl->get();
 }
 
+bool RelativePoseTracker::getFlat(FlatState &state) {
+  return _impl->getFlat(state);
+}
+
 std::optional<PoseTracker::State> RelativePoseTracker::Impl::get() {
 
   if (!pose_tracker) {
@@ -55,63 +70,140 @@ std::optional<PoseTracker::State> RelativePoseTracker::Impl::get() {
     return std::nullopt;
   }
 
-  State state;
+  // Transform the selected poses in one batch, in place
+  thread_local gmCore::PoseArray poses;
+  thread_local gmCore::PoseArray origins;
+  thread_local std::vector<Sample *> targets;
+  poses.clear();
+  origins.clear();
+  targets.clear();
 
   if (origin_key) {
     if (!origin_state->contains(*origin_key))
       return std::nullopt;
     const auto o_sample = origin_state.value()[*origin_key];
 
-    if (relative_keys.empty()) {
-      // Transform all keys
-      for (const auto as : relative_state.value())
-        state[as.first] = {
-            .time = std::max(o_sample.time, as.second.time),
-            .value = {.position =
-                          o_sample.value.orientation.conjugate() *
-                          (as.second.value.position - o_sample.value.position),
-                      .orientation = o_sample.value.orientation.conjugate() *
-                                     as.second.value.orientation}};
-    } else {
-      // Transform only keys listed in relative_keys
-      for (const auto as : relative_state.value())
-        if (!relative_keys.contains(as.first))
-          state[as.first] = as.second;
-        else
-          state[as.first] = {
-              .time = std::max(o_sample.time, as.second.time),
-              .value = {.position = o_sample.value.orientation.conjugate() *
-                                    (as.second.value.position -
-                                     o_sample.value.position),
-                        .orientation = o_sample.value.orientation.conjugate() *
-                                       as.second.value.orientation}};
-    }
+    for (auto &as : relative_state.value())
+      if (relative_keys.empty() || relative_keys.contains(as.first)) {
+        poses.push_back(as.second.value);
+        targets.push_back(&as.second);
+        as.second.time = std::max(o_sample.time, as.second.time);
+      }
+
+    const Eigen::Quaternionf o_inverse = o_sample.value.orientation.conjugate();
+    gmCore::PoseArray::compose({-(o_inverse * o_sample.value.position), o_inverse},
+                               poses, poses);
   } else {
-    for (const auto as : relative_state.value())
-      if (origin_state->contains(as.first) &&
-          relative_keys.contains(as.first)) {
-        const auto o_sample = origin_state.value()[as.first];
-        state[as.first] = {
-            .time = std::max(o_sample.time, as.second.time),
-            .value = {.position =
-                          o_sample.value.orientation.conjugate() *
-                          (as.second.value.position - o_sample.value.position),
-                      .orientation = o_sample.value.orientation.conjugate() *
-                                     as.second.value.orientation}};
-      } else {
-        state[as.first] = as.second;
+    for (auto &as : relative_state.value()) {
+      if (!relative_keys.contains(as.first)) continue;
+      auto it = origin_state->find(as.first);
+      if (it == origin_state->end()) continue;
+
+      poses.push_back(as.second.value);
+      origins.push_back(it->second.value);
+      targets.push_back(&as.second);
+      as.second.time = std::max(it->second.time, as.second.time);
+    }
+
+    gmCore::PoseArray::inverse(origins, origins);
+    gmCore::PoseArray::compose(origins, poses, poses);
+  }
+
+  for (size_t idx = 0; idx < targets.size(); ++idx)
+    targets[idx]->value = poses.get(idx);
+
+  return relative_state;
+}
+
+bool RelativePoseTracker::Impl::getFlat(FlatState &state) {
+
+  if (!pose_tracker) {
+    GM_RUNONCE(GM_WRN("RelativePoseTracker",
+                      "Pose requested but no relative tracker available."));
+    return false;
+  }
+
+  if (!origin_tracker && !origin_key) {
+    GM_RUNONCE(GM_WRN(
+        "RelativePoseTracker",
+        "Pose requested but no origin tracker available and no origin key specified to read from relative tracker."));
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(origin_lock);
+  const FlatState &origin_state = origin_tracker ? origin_buffer : state;
+
+  if (!pose_tracker->getFlat(state) ||
+      (origin_tracker && !origin_tracker->getFlat(origin_buffer))) {
+    GM_RUNONCE(
+        GM_WRN("RelativePoseTracker", "Pose requested but missing states."));
+    state.clear();
+    return false;
+  }
+
+  auto contains = [](const std::vector<TrackerKey::Id> &ids, TrackerKey::Id id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+  };
+
+  // Transform the selected poses in one batch, in place
+  thread_local gmCore::PoseArray poses;
+  thread_local gmCore::PoseArray origins;
+  thread_local std::vector<Sample *> targets;
+  poses.clear();
+  origins.clear();
+  targets.clear();
+
+  if (origin_key_id) {
+    auto it = std::find_if(origin_state.begin(), origin_state.end(),
+                           [this](const KeySample &ks) { return ks.key == *origin_key_id; });
+    if (it == origin_state.end()) {
+      state.clear();
+      return false;
+    }
+    // Copied, since the origin may be among the transformed samples
+    const Sample o_sample = it->sample;
+
+    for (auto &ks : state)
+      if (relative_key_ids.empty() || contains(relative_key_ids, ks.key)) {
+        poses.push_back(ks.sample.value);
+        targets.push_back(&ks.sample);
+        ks.sample.time = std::max(o_sample.time, ks.sample.time);
       }
+
+    const Eigen::Quaternionf o_inverse = o_sample.value.orientation.conjugate();
+    gmCore::PoseArray::compose({-(o_inverse * o_sample.value.position), o_inverse},
+                               poses, poses);
+  } else {
+    for (auto &ks : state) {
+      if (!contains(relative_key_ids, ks.key)) continue;
+      auto it = std::find_if(origin_state.begin(), origin_state.end(),
+                             [&ks](const KeySample &o) { return o.key == ks.key; });
+      if (it == origin_state.end()) continue;
+
+      poses.push_back(ks.sample.value);
+      origins.push_back(it->sample.value);
+      targets.push_back(&ks.sample);
+      ks.sample.time = std::max(it->sample.time, ks.sample.time);
+    }
+
+    gmCore::PoseArray::inverse(origins, origins);
+    gmCore::PoseArray::compose(origins, poses, poses);
   }
 
-  return state;
+  for (size_t idx = 0; idx < targets.size(); ++idx)
+    targets[idx]->value = poses.get(idx);
+
+  return true;
 }
 
 void RelativePoseTracker::setOriginKey(std::string key) {
   _impl->origin_key = key;
+  _impl->origin_key_id = TrackerKey::getId(key);
 }
 
 void RelativePoseTracker::addRelativeKey(std::string key) {
-  _impl->relative_keys.insert(key);
+  if (_impl->relative_keys.insert(key).second)
+    _impl->relative_key_ids.push_back(TrackerKey::getId(key));
 }
 
 void RelativePoseTracker::setOriginTracker(std::shared_ptr<PoseTracker> tracker) {
@@ -0,0 +1,372 @@
+#include <gmTrack/TimeSampleFile.hh>
+
+#include <gmCore/MappedFile.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/Console.hh>
+#include <gmCore/Stringify.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+namespace {
+  constexpr char MAGIC[4] = { 'G', 'M', 'T', 'S' };
+  constexpr char CHUNK_MAGIC[4] = { 'C', 'H', 'N', 'K' };
+
+  constexpr uint32_t VERSION = 2;
+
+  size_t align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+}
+
+struct TimeSampleFile::Impl {
+
+  Impl(std::filesystem::path path) : file(path) {}
+
+  struct Chunk {
+    size_t first_record;
+    size_t record_count;
+    const char *records;
+    size_t record_size;
+    std::vector<int32_t> local_key; //< Chunk key index per file key, or -1
+  };
+
+  template<class T>
+  T read(size_t &offset) const {
+    if (offset + sizeof(T) > file.size())
+      throw gmCore::InvalidArgument(GM_STR("Unexpected end of data in "
+                                           << file.getPath()));
+    T value;
+    std::memcpy(&value, file.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+  }
+
+  /**
+     Reads a key dictionary and registers the chunk of records
+     following it. Returns the offset after the chunk.
+  */
+  size_t readChunk(size_t offset);
+
+  /**
+     Returns the values of the specified key index in the specified
+     record, i.e. the components followed by the age, or nullptr if
+     the key is not in the chunk of the record.
+  */
+  const char * getValues(size_t record, size_t key_idx) const {
+    const auto &chunk = getChunk(record);
+    int32_t local_key = chunk.local_key[key_idx];
+    if (local_key < 0) return nullptr;
+    return chunk.records
+      + (record - chunk.first_record) * chunk.record_size
+      + sizeof(double) + local_key * (components + 1) * sizeof(float);
+  }
+
+  const Chunk & getChunk(size_t record) const {
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), record,
+                               [](size_t record, const Chunk &chunk) {
+                                 return record < chunk.first_record;
+                               });
+    return *(it - 1);
+  }
+
+  gmCore::MappedFile file;
+
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, size_t> key_index;
+  size_t components = 0;
+
+  std::vector<Chunk> chunks;
+  size_t record_count = 0;
+};
+
+size_t TimeSampleFile::Impl::readChunk(size_t offset) {
+
+  uint32_t key_count = read<uint32_t>(offset);
+
+  Chunk chunk;
+  chunk.first_record = record_count;
+  chunk.local_key.assign(keys.size(), -1);
+
+  for (uint32_t idx = 0; idx < key_count; ++idx) {
+    uint32_t length = read<uint32_t>(offset);
+    if (offset + length > file.size())
+      throw gmCore::InvalidArgument(GM_STR("Unexpected end of data in "
+                                           << file.getPath()));
+    std::string key(file.data() + offset, length);
+    offset += length;
+
+    auto it = key_index.find(key);
+    if (it == key_index.end()) {
+      it = key_index.emplace(key, keys.size()).first;
+      keys.push_back(key);
+      chunk.local_key.push_back(-1);
+    }
+    chunk.local_key[it->second] = int32_t(idx);
+  }
+
+  // Each value is followed by its age
+  chunk.record_size = sizeof(double) + key_count * (components + 1) * sizeof(float);
+
+  offset = align8(offset);
+  if (offset + sizeof(uint64_t) > file.size()) {
+    GM_WRN("TimeSampleFile", "Ignoring incomplete last chunk in " << file.getPath());
+    return file.size();
+  }
+  size_t count = size_t(read<uint64_t>(offset));
+
+  size_t available = (file.size() - std::min(offset, file.size())) / chunk.record_size;
+  if (count > available) {
+    // Typically from a recording that was not properly closed
+    GM_WRN("TimeSampleFile", "Ignoring incomplete last chunk in " << file.getPath());
+    count = available;
+  }
+
+  chunk.records = file.data() + offset;
+  chunk.record_count = count;
+
+  size_t end = offset + count * chunk.record_size;
+
+  record_count += count;
+  if (count > 0) chunks.push_back(std::move(chunk));
+
+  return end;
+}
+
+TimeSampleFile::TimeSampleFile(std::filesystem::path path)
+  : _impl(std::make_unique<Impl>(path)) {
+
+  Impl &impl = *_impl;
+
+  if (impl.file.size() < sizeof(MAGIC) ||
+      std::memcmp(impl.file.data(), MAGIC, sizeof(MAGIC)) != 0)
+    throw gmCore::InvalidArgument(GM_STR(path << " is not a time sample file"));
+
+  size_t offset = sizeof(MAGIC);
+
+  uint32_t version = impl.read<uint32_t>(offset);
+  if (version != VERSION)
+    throw gmCore::InvalidArgument(GM_STR("Unsupported version " << version
+                                         << " of time sample file " << path));
+
+  impl.components = impl.read<uint32_t>(offset);
+  if (impl.components == 0)
+    throw gmCore::InvalidArgument(GM_STR("Time sample file " << path
+                                         << " has no values"));
+
+  impl.read<uint32_t>(offset); // Reserved
+
+  while (offset + sizeof(CHUNK_MAGIC) <= impl.file.size()) {
+    if (std::memcmp(impl.file.data() + offset, CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) != 0)
+      throw gmCore::InvalidArgument(GM_STR("Corrupt chunk at " << offset << " in " << path));
+    offset = impl.readChunk(offset + sizeof(CHUNK_MAGIC));
+  }
+
+  for (auto &chunk : impl.chunks) chunk.local_key.resize(impl.keys.size(), -1);
+
+  GM_DBG1("TimeSampleFile", "Mapped " << impl.record_count << " records in "
+          << impl.chunks.size() << " chunks, of " << impl.keys.size()
+          << " keys, from " << path);
+}
+
+TimeSampleFile::~TimeSampleFile() {}
+
+const std::vector<std::string> & TimeSampleFile::getKeys() const {
+  return _impl->keys;
+}
+
+size_t TimeSampleFile::getComponentCount() const {
+  return _impl->components;
+}
+
+size_t TimeSampleFile::size() const {
+  return _impl->record_count;
+}
+
+double TimeSampleFile::getTime(size_t record) const {
+  const auto &chunk = _impl->getChunk(record);
+  double time;
+  std::memcpy(&time,
+              chunk.records + (record - chunk.first_record) * chunk.record_size,
+              sizeof(double));
+  return time;
+}
+
+bool TimeSampleFile::getComponents(size_t record, size_t key_idx,
+                                   double *components) const {
+
+  const char *data = _impl->getValues(record, key_idx);
+  if (!data) return false;
+
+  const size_t N = _impl->components;
+  for (size_t idx = 0; idx < N; ++idx) {
+    float value;
+    std::memcpy(&value, data + idx * sizeof(float), sizeof(float));
+    if (idx == 0 && std::isnan(value)) return false;
+    components[idx] = value;
+  }
+
+  return true;
+}
+
+double TimeSampleFile::getAge(size_t record, size_t key_idx) const {
+
+  const char *data = _impl->getValues(record, key_idx);
+  if (!data) return 0.0;
+
+  float age;
+  std::memcpy(&age, data + _impl->components * sizeof(float), sizeof(float));
+  return std::isnan(age) ? 0.0 : age;
+}
+
+struct TimeSampleFile::Writer::Impl {
+
+  template<class T>
+  void write(const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    position += sizeof(T);
+  }
+
+  void write(const char *data, size_t size) {
+    out.write(data, size);
+    position += size;
+  }
+
+  void pad() {
+    static const char padding[8] = {};
+    write(padding, align8(position) - position);
+  }
+
+  std::ofstream out;
+  size_t position = 0;
+
+  size_t components;
+  size_t chunk_size;
+
+  std::optional<double> last_time;
+
+  /// Keys of the current chunk
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, size_t> key_index;
+
+  /// Record being built, with components and age for each key
+  std::vector<float> pending;
+
+  /// Completed records of the current chunk
+  std::vector<double> times;
+  std::vector<size_t> record_key_count;
+  std::vector<float> values;
+};
+
+TimeSampleFile::Writer::Writer(std::filesystem::path path,
+                               size_t components,
+                               size_t chunk_size)
+  : _impl(std::make_unique<Impl>()) {
+
+  if (components == 0)
+    throw gmCore::InvalidArgument("Cannot write time samples without components");
+
+  _impl->out.open(path, std::ios::binary | std::ios::trunc);
+  if (!_impl->out)
+    throw gmCore::InvalidArgument(GM_STR("Cannot open " << path << " for writing"));
+
+  _impl->components = components;
+  _impl->chunk_size = std::max(chunk_size, size_t(1));
+
+  _impl->write(MAGIC, sizeof(MAGIC));
+  _impl->write(VERSION);
+  _impl->write(uint32_t(components));
+  _impl->write(uint32_t(0));
+}
+
+TimeSampleFile::Writer::~Writer() {
+  flush();
+}
+
+void TimeSampleFile::Writer::add(const std::string &key,
+                                 const float *components,
+                                 double age) {
+  Impl &impl = *_impl;
+  const size_t N = impl.components;
+
+  auto it = impl.key_index.find(key);
+  if (it == impl.key_index.end()) {
+    it = impl.key_index.emplace(key, impl.keys.size()).first;
+    impl.keys.push_back(key);
+    impl.pending.resize(impl.keys.size() * (N + 1),
+                        std::numeric_limits<float>::quiet_NaN());
+  }
+
+  auto values = impl.pending.begin() + it->second * (N + 1);
+  std::copy(components, components + N, values);
+  values[N] = float(age);
+}
+
+void TimeSampleFile::Writer::commit(double time) {
+  Impl &impl = *_impl;
+
+  if (impl.last_time && time <= *impl.last_time)
+    throw gmCore::InvalidArgument(GM_STR("Sample time must be increasing; "
+                                         << time << " <= " << *impl.last_time));
+  impl.last_time = time;
+
+  impl.times.push_back(time);
+  impl.record_key_count.push_back(impl.keys.size());
+  impl.values.insert(impl.values.end(), impl.pending.begin(), impl.pending.end());
+  std::fill(impl.pending.begin(), impl.pending.end(),
+            std::numeric_limits<float>::quiet_NaN());
+
+  if (impl.times.size() >= impl.chunk_size) flush();
+}
+
+void TimeSampleFile::Writer::flush() {
+  Impl &impl = *_impl;
+
+  if (impl.times.empty()) return;
+
+  const size_t N = impl.components;
+  const size_t key_count = impl.keys.size();
+
+  impl.write(CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+  impl.write(uint32_t(key_count));
+  for (const auto &key : impl.keys) {
+    impl.write(uint32_t(key.size()));
+    impl.write(key.data(), key.size());
+  }
+  impl.pad();
+  impl.write(uint64_t(impl.times.size()));
+
+  // Records completed before a key was added lack its values
+  const std::vector<float> missing(key_count * (N + 1),
+                                   std::numeric_limits<float>::quiet_NaN());
+
+  size_t offset = 0;
+  for (size_t idx = 0; idx < impl.times.size(); ++idx) {
+    size_t count = impl.record_key_count[idx] * (N + 1);
+    impl.write(impl.times[idx]);
+    impl.write(reinterpret_cast<const char *>(impl.values.data() + offset),
+               count * sizeof(float));
+    impl.write(reinterpret_cast<const char *>(missing.data()),
+               (key_count * (N + 1) - count) * sizeof(float));
+    offset += count;
+  }
+
+  impl.out.flush();
+
+  impl.times.clear();
+  impl.record_key_count.clear();
+  impl.values.clear();
+
+  // Each chunk has its own dictionary, of the keys used in the chunk
+  impl.keys.clear();
+  impl.key_index.clear();
+  impl.pending.clear();
+}
+
+END_NAMESPACE_GMTRACK;
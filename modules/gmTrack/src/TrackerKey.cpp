@@ -0,0 +1,64 @@
+
+#include <gmTrack/TrackerKey.hh>
+
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/Stringify.hh>
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+namespace {
+
+struct StringHash {
+  typedef void is_transparent;
+  size_t operator()(std::string_view str) const {
+    return std::hash<std::string_view>{}(str);
+  }
+};
+
+struct Registry {
+
+  static Registry &get() {
+    static Registry registry;
+    return registry;
+  }
+
+  std::shared_mutex lock;
+  std::unordered_map<std::string, TrackerKey::Id, StringHash, std::equal_to<>> ids;
+
+  /// Deque, so that references to the names remain valid
+  std::deque<std::string> names;
+};
+}
+
+TrackerKey::Id TrackerKey::getId(std::string_view key) {
+
+  Registry &registry = Registry::get();
+
+  {
+    std::shared_lock<std::shared_mutex> guard(registry.lock);
+    auto it = registry.ids.find(key);
+    if (it != registry.ids.end()) return it->second;
+  }
+
+  std::unique_lock<std::shared_mutex> guard(registry.lock);
+  auto [it, inserted] = registry.ids.try_emplace(std::string(key), Id(registry.names.size()));
+  if (inserted) registry.names.emplace_back(key);
+  return it->second;
+}
+
+const std::string &TrackerKey::getName(Id id) {
+
+  Registry &registry = Registry::get();
+
+  std::shared_lock<std::shared_mutex> guard(registry.lock);
+  if (id >= registry.names.size())
+    throw gmCore::InvalidArgument(GM_STR("No tracker key with id " << id));
+  return registry.names[id];
+}
+
+END_NAMESPACE_GMTRACK;
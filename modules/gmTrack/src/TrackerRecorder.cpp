@@ -0,0 +1,283 @@
+#include <gmTrack/TrackerRecorder.hh>
+#include <gmTrack/TimeSampleFile.hh>
+
+#include <gmCore/Console.hh>
+#include <gmCore/FastParser.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/PreConditionViolation.hh>
+#include <gmCore/RunOnce.hh>
+#include <gmCore/SpscQueue.hh>
+#include <gmCore/TimeTools.hh>
+#include <gmCore/Updateable.hh>
+
+#include <atomic>
+#include <thread>
+
+BEGIN_NAMESPACE_GMTRACK;
+
+GM_OFI_DEFINE(TrackerRecorder);
+GM_OFI_PARAM2(TrackerRecorder, file, std::filesystem::path, setFile);
+GM_OFI_PARAM2(TrackerRecorder, queueSize, size_t, setQueueSize);
+GM_OFI_POINTER2(TrackerRecorder, poseTracker, PoseTracker, setPoseTracker);
+GM_OFI_POINTER2(TrackerRecorder, binaryTracker, BinaryTracker, setBinaryTracker);
+GM_OFI_POINTER2(TrackerRecorder, floatTracker, FloatTracker, setFloatTracker);
+GM_OFI_POINTER2(TrackerRecorder, float2Tracker, Float2Tracker, setFloat2Tracker);
+
+struct TrackerRecorder::Impl : gmCore::Updateable {
+
+  typedef std::chrono::steady_clock clock;
+
+  /**
+     A tracker state flattened into interned keys and, for each key,
+     the value components followed by the age of the sample.
+  */
+  struct Record {
+    double time;
+    std::vector<TrackerKey::Id> keys;
+    std::vector<float> values;
+  };
+
+  Impl() : gmCore::Updateable(-100) {}
+  ~Impl();
+
+  void initialize();
+  void update(clock::time_point time, size_t frame) override;
+
+  template<class TYPE>
+  bool sample(TrackerBase<TYPE> &tracker,
+              typename TrackerBase<TYPE>::FlatState &state);
+
+  void write();
+  void close();
+
+  size_t getComponentCount() const;
+
+  std::shared_ptr<PoseTracker> pose_tracker;
+  std::shared_ptr<BinaryTracker> binary_tracker;
+  std::shared_ptr<FloatTracker> float_tracker;
+  std::shared_ptr<Float2Tracker> float2_tracker;
+
+  std::filesystem::path path;
+  size_t queue_size = 1024;
+
+  std::optional<clock::time_point> first_time;
+  std::optional<clock::time_point> last_time;
+
+  /// States read from the tracker, reused between updates
+  PoseTracker::FlatState pose_state;
+  BinaryTracker::FlatState binary_state;
+  FloatTracker::FlatState float_state;
+  Float2Tracker::FlatState float2_state;
+
+  /// Record being built
+  Record record;
+
+  std::unique_ptr<gmCore::SpscQueue<Record>> queue;
+
+  /// Written records handed back, to reuse their buffers
+  std::unique_ptr<gmCore::SpscQueue<Record>> free_records;
+
+  std::unique_ptr<TimeSampleFile::Writer> writer;
+  std::thread write_thread;
+  std::atomic<bool> write_thread_alive = false;
+
+  std::atomic<size_t> record_count = 0;
+  std::atomic<size_t> drop_count = 0;
+};
+
+TrackerRecorder::TrackerRecorder() : _impl(std::make_unique<Impl>()) {}
+
+TrackerRecorder::~TrackerRecorder() {}
+
+TrackerRecorder::Impl::~Impl() {
+  close();
+}
+
+void TrackerRecorder::initialize() {
+  _impl->initialize();
+  gmCore::Object::initialize();
+}
+
+size_t TrackerRecorder::Impl::getComponentCount() const {
+  if (pose_tracker) return gmCore::NumericLayout<gmCore::Pose>::components;
+  if (binary_tracker) return gmCore::NumericLayout<bool>::components;
+  if (float_tracker) return gmCore::NumericLayout<float>::components;
+  if (float2_tracker) return gmCore::NumericLayout<gmCore::float2>::components;
+  return 0;
+}
+
+void TrackerRecorder::Impl::initialize() {
+
+  if (!!pose_tracker + !!binary_tracker + !!float_tracker + !!float2_tracker != 1)
+    throw gmCore::PreConditionViolation(
+        "TrackerRecorder requires exactly one tracker to record");
+
+  if (path.empty())
+    throw gmCore::PreConditionViolation("TrackerRecorder requires a file");
+
+  writer = std::make_unique<TimeSampleFile::Writer>(path, getComponentCount());
+  queue = std::make_unique<gmCore::SpscQueue<Record>>(queue_size);
+  free_records = std::make_unique<gmCore::SpscQueue<Record>>(queue_size);
+
+  write_thread_alive = true;
+  write_thread = std::thread([this] { this->write(); });
+
+  GM_DBG1("TrackerRecorder", "Recording to " << path);
+}
+
+template<class TYPE>
+bool TrackerRecorder::Impl::sample(TrackerBase<TYPE> &tracker,
+                                   typename TrackerBase<TYPE>::FlatState &state) {
+
+  if (!tracker.getFlat(state) || state.empty()) return false;
+
+  clock::time_point latest = clock::time_point::min();
+  for (const auto &ks : state)
+    latest = std::max(latest, ks.sample.time);
+
+  if (last_time && latest <= *last_time) return false;
+  last_time = latest;
+  if (!first_time) first_time = latest;
+
+  record.time = gmCore::TimeTools::durationToSeconds(latest - *first_time);
+
+  constexpr size_t N = gmCore::NumericLayout<TYPE>::components;
+  record.keys.clear();
+  record.values.resize(state.size() * (N + 1));
+
+  // Keys that were not updated are recorded with the age of their sample
+  double numbers[N];
+  float *values = record.values.data();
+  for (const auto &ks : state) {
+    record.keys.push_back(ks.key);
+    gmCore::NumericLayout<TYPE>::extract(ks.sample.value, numbers);
+    for (size_t idx = 0; idx < N; ++idx) *values++ = float(numbers[idx]);
+    *values++ = float(gmCore::TimeTools::durationToSeconds(latest - ks.sample.time));
+  }
+
+  return true;
+}
+
+void TrackerRecorder::Impl::update(clock::time_point, size_t) {
+
+  if (!queue) return;
+
+  bool recorded =
+    pose_tracker ? sample(*pose_tracker, pose_state) :
+    binary_tracker ? sample(*binary_tracker, binary_state) :
+    float_tracker ? sample(*float_tracker, float_state) :
+    float2_tracker ? sample(*float2_tracker, float2_state) : false;
+  if (!recorded) return;
+
+  if (!queue->tryPush(std::move(record))) {
+    GM_RUNONCE(GM_WRN("TrackerRecorder",
+                      "Writing to " << path << " falls behind; dropping records"));
+    ++drop_count;
+    return;
+  }
+
+  ++record_count;
+
+  // Continue with the buffers of a written record, if any
+  free_records->tryPop(record);
+}
+
+void TrackerRecorder::Impl::write() {
+
+  const size_t N = getComponentCount();
+
+  Record record;
+  while (true) {
+
+    // Read before popping, so that all records queued before the stop are written
+    bool alive = write_thread_alive;
+
+    if (!queue->tryPop(record)) {
+      if (!alive) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      continue;
+    }
+
+    try {
+      for (size_t idx = 0; idx < record.keys.size(); ++idx) {
+        const float *values = record.values.data() + idx * (N + 1);
+        writer->add(TrackerKey::getName(record.keys[idx]), values, values[N]);
+      }
+      writer->commit(record.time);
+    } catch (const gmCore::InvalidArgument &e) {
+      GM_RUNONCE(GM_ERR("TrackerRecorder", "Could not write record: " << e.what));
+    }
+
+    free_records->tryPush(std::move(record));
+  }
+
+  writer->flush();
+}
+
+void TrackerRecorder::Impl::close() {
+
+  if (!write_thread.joinable()) return;
+
+  write_thread_alive = false;
+
+  try {
+    write_thread.join();
+  } catch (const std::system_error &e) {
+    GM_WRN("TrackerRecorder",
+           "Caught system_error while joining write thread. Code "
+           << e.code() << " meaning " << e.what() << ".");
+  }
+
+  writer.reset();
+  queue.reset();
+  free_records.reset();
+
+  GM_DBG1("TrackerRecorder", "Wrote " << record_count << " records to " << path
+          << " (" << drop_count << " dropped)");
+}
+
+void TrackerRecorder::close() {
+  _impl->close();
+}
+
+void TrackerRecorder::setFile(std::filesystem::path file) {
+  _impl->path = file;
+}
+
+void TrackerRecorder::setQueueSize(size_t n) {
+  if (n == 0) throw gmCore::InvalidArgument("Queue size must be positive");
+  _impl->queue_size = n;
+}
+
+void TrackerRecorder::setPoseTracker(std::shared_ptr<PoseTracker> tracker) {
+  _impl->pose_tracker = tracker;
+}
+
+void TrackerRecorder::setBinaryTracker(std::shared_ptr<BinaryTracker> tracker) {
+  _impl->binary_tracker = tracker;
+}
+
+void TrackerRecorder::setFloatTracker(std::shared_ptr<FloatTracker> tracker) {
+  _impl->float_tracker = tracker;
+}
+
+void TrackerRecorder::setFloat2Tracker(std::shared_ptr<Float2Tracker> tracker) {
+  _impl->float2_tracker = tracker;
+}
+
+size_t TrackerRecorder::getRecordCount() {
+  return _impl->record_count;
+}
+
+size_t TrackerRecorder::getDropCount() {
+  return _impl->drop_count;
+}
+
+void TrackerRecorder::traverse(Visitor *visitor) {
+  if (_impl->pose_tracker) _impl->pose_tracker->accept(visitor);
+  if (_impl->binary_tracker) _impl->binary_tracker->accept(visitor);
+  if (_impl->float_tracker) _impl->float_tracker->accept(visitor);
+  if (_impl->float2_tracker) _impl->float2_tracker->accept(visitor);
+}
+
+END_NAMESPACE_GMTRACK;
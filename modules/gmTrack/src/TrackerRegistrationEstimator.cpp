@@ -4,25 +4,61 @@
 
 #include <gmCore/RunOnce.hh>
 #include <gmCore/Console.hh>
+#include <gmCore/InvalidArgument.hh>
+#include <gmCore/JobSystem.hh>
 
 #include <Eigen/LU>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
 
+#include <array>
+#include <future>
 #include <limits>
+#include <random>
 #include <type_traits>
 
 BEGIN_NAMESPACE_GMTRACK;
 
 GM_OFI_DEFINE_SUB(TrackerRegistrationEstimator, PoseSampleCollector);
 GM_OFI_PARAM2(TrackerRegistrationEstimator, actualPosition, Eigen::Vector3f, addActualPosition);
+GM_OFI_PARAM2(TrackerRegistrationEstimator, robust, bool, setRobust);
+GM_OFI_PARAM2(TrackerRegistrationEstimator, ransacIterations, size_t, setRansacIterations);
+GM_OFI_PARAM2(TrackerRegistrationEstimator, ransacThreshold, float, setRansacThreshold);
 
 struct TrackerRegistrationEstimator::Impl : PoseSampleCollector::Impl {
 
   typedef gmCore::Updateable::clock clock;
 
+  /**
+     Correspondences and settings for a robust estimation, copied so
+     that the estimation can run while new samples are collected.
+  */
+  struct RobustProblem {
+    std::vector<Eigen::Vector3f> tracker_data;
+    std::vector<Eigen::Vector3f> actual_data;
+    /// Sample indices per actual position
+    std::vector<std::vector<size_t>> groups;
+    float threshold;
+    size_t iterations;
+    float planar_sphericity;
+  };
+
+  struct RobustResult {
+    bool success = false;
+    Eigen::Matrix4f raw;
+    Eigen::Matrix4f unit;
+    std::vector<float> residuals;
+    size_t inlier_count = 0;
+  };
+
   std::vector<Eigen::Vector3f> actual_positions;
 
+  ~Impl();
+
   void update(clock::time_point t) override;
 
+  void addSample(const gmCore::Pose &pose) override;
+
   float estimateSphericity(std::vector<Eigen::Vector3f> samples);
 
   void performRegistration();
@@ -41,14 +77,44 @@ struct TrackerRegistrationEstimator::Impl : PoseSampleCollector::Impl {
   */
   void expandPlanar(std::vector<Eigen::Vector3f> &data, int &idx0, int &idx1);
 
-  bool estimateRegistration(const std::vector<Eigen::Vector3f> &tracker_data,
-                            const std::vector<Eigen::Vector3f> &actual_data,
-                            Eigen::Matrix4f &M);
+  static bool estimateRegistration(const std::vector<Eigen::Vector3f> &tracker_data,
+                                   const std::vector<Eigen::Vector3f> &actual_data,
+                                   Eigen::Matrix4f &M);
+
+  static void estimateUnitRegistration(const std::vector<Eigen::Vector3f> &tracker_data,
+                                       const std::vector<Eigen::Vector3f> &actual_data,
+                                       const Eigen::Matrix4f &M_raw,
+                                       Eigen::Matrix4f &M_unit);
 
-  void estimateUnitRegistration(const std::vector<Eigen::Vector3f> &tracker_data,
-                                const std::vector<Eigen::Vector3f> &actual_data,
-                                const Eigen::Matrix4f &M_raw,
-                                Eigen::Matrix4f &M_unit);
+  void startRobustRegistration();
+
+  /**
+     Picks up the result of a robust estimation, if finished or if
+     specified to wait for it. Returns true if a result was picked
+     up.
+  */
+  bool pickUpResult(bool wait);
+
+  static RobustResult estimateRobust(const RobustProblem &problem,
+                                     gmCore::JobSystem &job_system);
+
+  /**
+     Returns the singular values of the specified samples around
+     their centroid, in descending order.
+  */
+  static Eigen::Vector3f getSpread(const std::vector<Eigen::Vector3f> &data,
+                                   const std::vector<size_t> &indices);
+
+  /**
+     Refines the specified similarity transform, minimizing the Huber
+     loss of the registration offsets of the specified samples with
+     Levenberg-Marquardt.
+  */
+  static Eigen::Matrix4f refineSimilarity(const std::vector<Eigen::Vector3f> &tracker_data,
+                                          const std::vector<Eigen::Vector3f> &actual_data,
+                                          const std::vector<size_t> &indices,
+                                          const Eigen::Matrix4f &M,
+                                          float delta);
 
   void checkResult(const std::vector<Eigen::Vector3f> &tracker_data,
                    const std::vector<Eigen::Vector3f> &actual_data,
@@ -61,7 +127,21 @@ struct TrackerRegistrationEstimator::Impl : PoseSampleCollector::Impl {
   Eigen::Matrix4f registration_unit;
   bool successful_registration = false;
 
+  std::vector<float> residuals;
+  size_t inlier_count = 0;
+
   size_t position_to_collect = std::numeric_limits<size_t>::max();
+
+  bool robust = false;
+  size_t ransac_iterations = 1000;
+  float ransac_threshold = 0.01f;
+
+  /// Individual samples and the actual position each was taken for
+  std::vector<Eigen::Vector3f> raw_samples;
+  std::vector<size_t> raw_sample_positions;
+
+  std::shared_ptr<gmCore::JobSystem> job_system;
+  std::future<RobustResult> robust_result;
 };
 
 TrackerRegistrationEstimator::TrackerRegistrationEstimator()
@@ -69,14 +149,37 @@ TrackerRegistrationEstimator::TrackerRegistrationEstimator()
 
 TrackerRegistrationEstimator::~TrackerRegistrationEstimator() {}
 
+TrackerRegistrationEstimator::Impl::~Impl() {
+  if (robust_result.valid()) robust_result.wait();
+}
+
 void TrackerRegistrationEstimator::addActualPosition(Eigen::Vector3f p) {
   auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
   _impl->actual_positions.push_back(p);
 }
 
+void TrackerRegistrationEstimator::setRobust(bool on) {
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->robust = on;
+}
+
+void TrackerRegistrationEstimator::setRansacIterations(size_t n) {
+  if (n == 0) throw gmCore::InvalidArgument("RANSAC iterations must be positive");
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->ransac_iterations = n;
+}
+
+void TrackerRegistrationEstimator::setRansacThreshold(float d) {
+  if (d <= 0.f) throw gmCore::InvalidArgument("RANSAC threshold must be positive");
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->ransac_threshold = d;
+}
+
 bool TrackerRegistrationEstimator::getRegistration(Eigen::Matrix4f * RAW, Eigen::Matrix4f * UNIT) {
   auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
 
+  _impl->pickUpResult(false);
+
   if (!_impl->successful_registration)
     return false;
 
@@ -89,8 +192,34 @@ bool TrackerRegistrationEstimator::getRegistration(Eigen::Matrix4f * RAW, Eigen:
   return true;
 }
 
+std::vector<float> TrackerRegistrationEstimator::getResiduals() {
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->pickUpResult(false);
+  return _impl->residuals;
+}
+
+size_t TrackerRegistrationEstimator::getInlierCount() {
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->pickUpResult(false);
+  return _impl->inlier_count;
+}
+
+bool TrackerRegistrationEstimator::waitForRegistration() {
+  auto _impl = static_cast<TrackerRegistrationEstimator::Impl *>(this->_impl.get());
+  _impl->pickUpResult(true);
+  return _impl->successful_registration;
+}
+
+void TrackerRegistrationEstimator::Impl::addSample(const gmCore::Pose &pose) {
+  PoseSampleCollector::Impl::addSample(pose);
+  raw_samples.push_back(pose.position);
+  raw_sample_positions.push_back(tracker_positions.size());
+}
+
 void TrackerRegistrationEstimator::Impl::update(clock::time_point now) {
 
+  pickUpResult(false);
+
   if (actual_positions.empty())
     return;
 
@@ -126,6 +255,11 @@ void TrackerRegistrationEstimator::Impl::performRegistration() {
     return;
   }
 
+  if (robust) {
+    startRobustRegistration();
+    return;
+  }
+
   float tracker_data_sph = estimateSphericity(tracker_positions);
   float actual_data_sph = estimateSphericity(actual_positions);
 
@@ -167,7 +301,357 @@ void TrackerRegistrationEstimator::Impl::performRegistration() {
   GM_DBG1("TrackerRegistrationEstimator", "Unit registration matrix:\n" << M_unit);
   checkResult(tracker_data, actual_data, M_unit, "unit");
 
+  residuals.resize(tracker_positions.size());
+  for (size_t idx = 0; idx < tracker_positions.size(); ++idx)
+    residuals[idx] = (actual_positions[idx] -
+                      (M_reg * tracker_positions[idx].homogeneous()).hnormalized()).norm();
+  inlier_count = tracker_positions.size();
+
+  tracker_positions.clear();
+  raw_samples.clear();
+  raw_sample_positions.clear();
+}
+
+void TrackerRegistrationEstimator::Impl::startRobustRegistration() {
+
+  if (robust_result.valid()) {
+    GM_WRN("TrackerRegistrationEstimator",
+           "Registration triggered while previous estimation is still running");
+    return;
+  }
+
+  RobustProblem problem;
+  problem.actual_data.reserve(raw_samples.size());
+  problem.groups.resize(actual_positions.size());
+  problem.threshold = ransac_threshold;
+  problem.iterations = ransac_iterations;
+  problem.planar_sphericity = planar_sphericity;
+
+  // Use the individual samples if these cover all actual positions,
+  // otherwise the tracker positions as given
+  bool has_raw_samples = !raw_samples.empty();
+  for (size_t idx : raw_sample_positions)
+    if (idx < actual_positions.size()) problem.groups[idx].push_back(0);
+  for (auto &group : problem.groups) {
+    if (group.empty()) has_raw_samples = false;
+    group.clear();
+  }
+
+  if (has_raw_samples) {
+    for (size_t idx = 0; idx < raw_samples.size(); ++idx) {
+      if (raw_sample_positions[idx] >= actual_positions.size()) continue;
+      problem.groups[raw_sample_positions[idx]].push_back(problem.tracker_data.size());
+      problem.tracker_data.push_back(raw_samples[idx]);
+      problem.actual_data.push_back(actual_positions[raw_sample_positions[idx]]);
+    }
+  } else {
+    problem.tracker_data = tracker_positions;
+    problem.actual_data = actual_positions;
+    for (size_t idx = 0; idx < actual_positions.size(); ++idx)
+      problem.groups[idx].push_back(idx);
+  }
+
+  GM_INF("TrackerRegistrationEstimator",
+         "Starting robust estimation from " << problem.tracker_data.size()
+         << " samples");
+
+  if (!job_system) job_system = gmCore::JobSystem::get();
+  // Runs on the workers only, since threads waiting for task groups,
+  // such as the update loop, run jobs of their own group only. The
+  // job system is kept alive by this instance, which waits for the
+  // estimation before being destroyed
+  robust_result = job_system->async
+    ([problem = std::move(problem), job_system = job_system.get()] {
+       return estimateRobust(problem, *job_system);
+     });
+
   tracker_positions.clear();
+  raw_samples.clear();
+  raw_sample_positions.clear();
+}
+
+bool TrackerRegistrationEstimator::Impl::pickUpResult(bool wait) {
+
+  if (!robust_result.valid()) return false;
+  if (!wait && robust_result.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready)
+    return false;
+
+  RobustResult result;
+  try {
+    result = robust_result.get();
+  } catch (const gmCore::InvalidArgument &e) {
+    GM_ERR("TrackerRegistrationEstimator", "Robust estimation failed: " << e.what);
+    return true;
+  } catch (const std::exception &e) {
+    GM_ERR("TrackerRegistrationEstimator", "Robust estimation failed: " << e.what());
+    return true;
+  }
+
+  if (!result.success) {
+    GM_ERR("TrackerRegistrationEstimator",
+           "Robust estimation found no consistent registration ("
+           << result.inlier_count << " of " << result.residuals.size()
+           << " samples within " << ransac_threshold << ")");
+    return true;
+  }
+
+  registration_raw = result.raw;
+  registration_unit = result.unit;
+  residuals = std::move(result.residuals);
+  inlier_count = result.inlier_count;
+  successful_registration = true;
+
+  GM_INF("TrackerRegistrationEstimator",
+         "Robust estimation used " << inlier_count << " of "
+         << residuals.size() << " samples");
+  GM_DBG1("TrackerRegistrationEstimator", "Raw registration matrix:\n" << registration_raw);
+  GM_DBG1("TrackerRegistrationEstimator", "Unit registration matrix:\n" << registration_unit);
+
+  return true;
+}
+
+Eigen::Vector3f TrackerRegistrationEstimator::Impl::getSpread
+(const std::vector<Eigen::Vector3f> &data,
+ const std::vector<size_t> &indices) {
+
+  Eigen::Vector3d cp = Eigen::Vector3d::Zero();
+  for (size_t idx : indices) cp += data[idx].cast<double>();
+  cp /= double(indices.size());
+
+  Eigen::Matrix3d C = Eigen::Matrix3d::Zero();
+  for (size_t idx : indices) {
+    Eigen::Vector3d d = data[idx].cast<double>() - cp;
+    C += d * d.transpose();
+  }
+
+  // Singular values of the centered data are the square roots of the
+  // eigenvalues of its scatter matrix, which are in ascending order
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(C, Eigen::EigenvaluesOnly);
+  Eigen::Vector3d ev = solver.eigenvalues().cwiseMax(0.0).cwiseSqrt();
+  return Eigen::Vector3f(float(ev[2]), float(ev[1]), float(ev[0]));
+}
+
+TrackerRegistrationEstimator::Impl::RobustResult
+TrackerRegistrationEstimator::Impl::estimateRobust(const RobustProblem &problem,
+                                                   gmCore::JobSystem &job_system) {
+
+  const auto &tracker_data = problem.tracker_data;
+  const auto &actual_data = problem.actual_data;
+  const size_t N = tracker_data.size();
+  const float sqr_threshold = problem.threshold * problem.threshold;
+
+  RobustResult result;
+  result.residuals.resize(N, std::numeric_limits<float>::max());
+  if (N < 4) return result;
+
+  // Four samples from different actual positions when possible,
+  // since samples of the same position are nearly coincident
+  const size_t group_count = problem.groups.size();
+  const bool distinct = group_count >= 4;
+
+  struct Hypothesis {
+    float cost = std::numeric_limits<float>::max();
+    Eigen::Matrix4f M;
+  };
+  std::vector<Hypothesis> hypotheses(problem.iterations);
+
+  // The subsets are drawn up front from one engine, so that they are
+  // independent of each other and of how the iterations are split
+  // over the workers
+  std::vector<std::array<size_t, 4>> subsets(problem.iterations);
+  std::mt19937 random;
+  for (auto &subset : subsets) {
+
+    for (size_t jdx = 0; jdx < 4; ++jdx) {
+      size_t group_idx;
+      bool taken;
+      do {
+        group_idx = random() % group_count;
+        taken = false;
+        for (size_t kdx = 0; distinct && kdx < jdx; ++kdx)
+          if (subset[kdx] == group_idx) taken = true;
+      } while (taken);
+      subset[jdx] = group_idx;
+    }
+
+    for (size_t jdx = 0; jdx < 4; ++jdx) {
+      const auto &group = problem.groups[subset[jdx]];
+      subset[jdx] = group[random() % group.size()];
+    }
+  }
+
+  job_system.parallelFor
+    (0, problem.iterations, [&](size_t begin, size_t end) {
+
+      std::vector<size_t> subset(4);
+      Eigen::Matrix<float, 3, 4> src, dst;
+
+      for (size_t it = begin; it < end; ++it) {
+
+        subset.assign(subsets[it].begin(), subsets[it].end());
+
+        // Skip subsets that are too close to collinear
+        Eigen::Vector3f spread = getSpread(tracker_data, subset);
+        if (spread[1] <= 1e-3f * spread[0] ||
+            spread[1] <= std::numeric_limits<float>::epsilon())
+          continue;
+
+        for (size_t jdx = 0; jdx < 4; ++jdx) {
+          src.col(jdx) = tracker_data[subset[jdx]];
+          dst.col(jdx) = actual_data[subset[jdx]];
+        }
+        Eigen::Matrix4f M = Eigen::umeyama(src, dst, true);
+        if (!M.allFinite()) continue;
+
+        // Truncated quadratic cost (MSAC)
+        float cost = 0.f;
+        for (size_t idx = 0; idx < N; ++idx)
+          cost += std::min(sqr_threshold,
+                           (actual_data[idx] -
+                            (M * tracker_data[idx].homogeneous()).hnormalized())
+                           .squaredNorm());
+
+        hypotheses[it].cost = cost;
+        hypotheses[it].M = M;
+      }
+    }, 16);
+
+  auto best = std::min_element(hypotheses.begin(), hypotheses.end(),
+                               [](const Hypothesis &a, const Hypothesis &b) {
+                                 return a.cost < b.cost;
+                               });
+  if (best->cost == std::numeric_limits<float>::max()) return result;
+
+  auto getInliers = [&](const Eigen::Matrix4f &M) {
+    std::vector<size_t> inliers;
+    for (size_t idx = 0; idx < N; ++idx)
+      if ((actual_data[idx] - (M * tracker_data[idx].homogeneous()).hnormalized())
+          .squaredNorm() <= sqr_threshold)
+        inliers.push_back(idx);
+    return inliers;
+  };
+
+  std::vector<size_t> inliers = getInliers(best->M);
+  result.inlier_count = inliers.size();
+  if (inliers.size() < 4) return result;
+
+  Eigen::Matrix4f M_sim = refineSimilarity(tracker_data, actual_data, inliers,
+                                           best->M, problem.threshold);
+  inliers = getInliers(M_sim);
+  result.inlier_count = inliers.size();
+  if (inliers.size() < 4 ||
+      getSpread(tracker_data, inliers)[1] <= std::numeric_limits<float>::epsilon())
+    return result;
+
+  std::vector<Eigen::Vector3f> tracker_inliers, actual_inliers;
+  tracker_inliers.reserve(inliers.size());
+  actual_inliers.reserve(inliers.size());
+  for (size_t idx : inliers) {
+    tracker_inliers.push_back(tracker_data[idx]);
+    actual_inliers.push_back(actual_data[idx]);
+  }
+
+  // A general affine transform can be estimated only if the
+  // consensus set spans all three dimensions
+  Eigen::Vector3f tracker_spread = getSpread(tracker_data, inliers);
+  Eigen::Vector3f actual_spread = getSpread(actual_data, inliers);
+  if (std::min(tracker_spread[2] / tracker_spread[0],
+               actual_spread[2] / actual_spread[0]) > problem.planar_sphericity)
+    estimateRegistration(tracker_inliers, actual_inliers, result.raw);
+  else
+    result.raw = M_sim;
+
+  estimateUnitRegistration(tracker_inliers, actual_inliers, M_sim, result.unit);
+
+  for (size_t idx = 0; idx < N; ++idx)
+    result.residuals[idx] =
+      (actual_data[idx] - (result.raw * tracker_data[idx].homogeneous()).hnormalized()).norm();
+
+  result.success = result.raw.allFinite() && result.unit.allFinite();
+  return result;
+}
+
+Eigen::Matrix4f TrackerRegistrationEstimator::Impl::refineSimilarity
+(const std::vector<Eigen::Vector3f> &tracker_data,
+ const std::vector<Eigen::Vector3f> &actual_data,
+ const std::vector<size_t> &indices,
+ const Eigen::Matrix4f &M,
+ float delta) {
+
+  // Transform s R p + t, updated as s exp(ds), exp([dw]x) R and t + dt
+  Eigen::Matrix3d sR = M.block<3,3>(0,0).cast<double>();
+  double s = std::cbrt(sR.determinant());
+  Eigen::Matrix3d R = sR / s;
+  Eigen::Vector3d t = M.block<3,1>(0,3).cast<double>();
+
+  auto getCost = [&](double s, const Eigen::Matrix3d &R, const Eigen::Vector3d &t) {
+    double cost = 0.0;
+    for (size_t idx : indices) {
+      double r = (s * R * tracker_data[idx].cast<double>() + t -
+                  actual_data[idx].cast<double>()).norm();
+      cost += r <= delta ? 0.5 * r * r : delta * (r - 0.5 * delta);
+    }
+    return cost;
+  };
+
+  double cost = getCost(s, R, t);
+  double lambda = 1e-3;
+
+  for (size_t iteration = 0; iteration < 50; ++iteration) {
+
+    Eigen::Matrix<double, 7, 7> H = Eigen::Matrix<double, 7, 7>::Zero();
+    Eigen::Matrix<double, 7, 1> g = Eigen::Matrix<double, 7, 1>::Zero();
+
+    for (size_t idx : indices) {
+      Eigen::Vector3d q = s * R * tracker_data[idx].cast<double>();
+      Eigen::Vector3d r = q + t - actual_data[idx].cast<double>();
+      double norm = r.norm();
+      double w = norm <= delta ? 1.0 : delta / norm;
+
+      Eigen::Matrix<double, 3, 7> J;
+      J.block<3,3>(0,0) <<
+        0, q.z(), -q.y(),
+        -q.z(), 0, q.x(),
+        q.y(), -q.x(), 0;
+      J.block<3,3>(0,3) = Eigen::Matrix3d::Identity();
+      J.col(6) = q;
+
+      H += w * J.transpose() * J;
+      g += w * J.transpose() * r;
+    }
+
+    Eigen::Matrix<double, 7, 7> A = H;
+    A.diagonal() += lambda * H.diagonal() +
+      Eigen::Matrix<double, 7, 1>::Constant(1e-12);
+    Eigen::Matrix<double, 7, 1> dx = A.ldlt().solve(-g);
+
+    Eigen::Vector3d dw = dx.head<3>();
+    double angle = dw.norm();
+    Eigen::Matrix3d new_R = angle > 0
+      ? Eigen::Matrix3d(Eigen::AngleAxisd(angle, dw / angle) * R) : R;
+    double new_s = s * std::exp(dx[6]);
+    Eigen::Vector3d new_t = t + dx.segment<3>(3);
+
+    double new_cost = getCost(new_s, new_R, new_t);
+    if (new_cost < cost) {
+      bool converged = cost - new_cost <= 1e-12 * cost;
+      s = new_s;
+      R = new_R;
+      t = new_t;
+      cost = new_cost;
+      lambda *= 0.1;
+      if (converged) break;
+    } else {
+      lambda *= 10;
+      if (lambda > 1e8) break;
+    }
+  }
+
+  Eigen::Matrix4f result = Eigen::Matrix4f::Identity();
+  result.block<3,3>(0,0) = (s * R).cast<float>();
+  result.block<3,1>(0,3) = t.cast<float>();
+  return result;
 }
 
 float TrackerRegistrationEstimator::Impl::estimateSphericity(std::vector<Eigen::Vector3f> data) {
@@ -0,0 +1,235 @@
+#include <gmCore/config.hh>
+
+#ifdef gramods_ENABLE_Eigen3
+
+#include <gmCore/io_eigen.hh>
+#include <gmCore/io_float.hh>
+#include <gmCore/io_size.hh>
+#include <gmCore/Pose.hh>
+#include <gmCore/TimeTools.hh>
+#include <gmCore/OFactory.hh>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+
+template<class T> bool streamParse(std::string s, T &val) {
+  std::stringstream ss(s);
+  ss >> std::setbase(0) >> val;
+  return bool(ss);
+}
+
+struct FastParserTarget : gmCore::Object {
+  int i = 0;
+  size_t s = 0;
+  float f = 0.f;
+  gmCore::size2 s2 = {0, 0};
+  Eigen::Matrix4f m = Eigen::Matrix4f::Zero();
+  std::vector<gmCore::Pose> path;
+  void setI(int v) { i = v; }
+  void setS(size_t v) { s = v; }
+  void setF(float v) { f = v; }
+  void setS2(gmCore::size2 v) { s2 = v; }
+  void setM(Eigen::Matrix4f v) { m = v; }
+  void setPath(std::vector<gmCore::Pose> v) { path = v; }
+  GM_OFI_DECLARE;
+};
+
+GM_OFI_DEFINE(FastParserTarget);
+GM_OFI_PARAM2(FastParserTarget, i, int, setI);
+GM_OFI_PARAM2(FastParserTarget, s, size_t, setS);
+GM_OFI_PARAM2(FastParserTarget, f, float, setF);
+GM_OFI_PARAM2(FastParserTarget, s2, gmCore::size2, setS2);
+GM_OFI_PARAM2(FastParserTarget, m, Eigen::Matrix4f, setM);
+GM_OFI_PARAM2(FastParserTarget, path, std::vector<gmCore::Pose>, setPath);
+
+std::string setterError(FastParserTarget &obj, std::string name, std::string value) {
+  try {
+    FastParserTarget::_gm_ofi.setParamValueFromString(&obj, name, value);
+  } catch (const gmCore::InvalidArgument &e) {
+    return e.what;
+  }
+  return "";
+}
+}
+
+TEST(gmCoreFastParser, Numbers) {
+
+  for (std::string s : {"0", "12", " -7", "+42", "12abc", "2147483647"}) {
+    int fast, slow;
+    EXPECT_TRUE(gmCore::FastParser<int>::parse(s, fast)) << s;
+    EXPECT_TRUE(streamParse(s, slow)) << s;
+    EXPECT_EQ(slow, fast) << s;
+  }
+
+  for (std::string s : {"0", "1.5", " -0.25", "+3", ".5", "1e3", "2.5E-2x", "1.5 2"}) {
+    float fast, slow;
+    EXPECT_TRUE(gmCore::FastParser<float>::parse(s, fast)) << s;
+    EXPECT_TRUE(streamParse(s, slow)) << s;
+    EXPECT_EQ(slow, fast) << s;
+  }
+
+  // Forms that are left to the istream operator
+  for (std::string s : {"0x10", "010", "abc", "", "  ", "+-1", "2147483648"}) {
+    int fast = 17;
+    EXPECT_FALSE(gmCore::FastParser<int>::parse(s, fast)) << s;
+    EXPECT_EQ(17, fast);
+  }
+  for (std::string s : {"inf", "nan", "1e", "2east", "-", "1e99"}) {
+    float fast = 17.f;
+    EXPECT_FALSE(gmCore::FastParser<float>::parse(s, fast)) << s;
+    EXPECT_EQ(17.f, fast);
+  }
+  {
+    size_t fast = 17;
+    EXPECT_FALSE(gmCore::FastParser<size_t>::parse("-1", fast));
+    EXPECT_EQ(17, fast);
+  }
+}
+
+TEST(gmCoreFastParser, Eigen) {
+
+  for (std::string s : {"1 2 3", " 1.5\t-2\n3e1 4", "1 2 3 4 5 6 7 8 9"}) {
+    Eigen::Vector3f fast, slow;
+    EXPECT_TRUE(gmCore::FastParser<Eigen::Vector3f>::parse(s, fast)) << s;
+    EXPECT_TRUE(streamParse(s, slow)) << s;
+    EXPECT_EQ(slow, fast) << s;
+  }
+
+  for (std::string s : {"1 2 3 4 5 6 7 8 9",
+                        "1 2 3 4 5 6 7 8 9 10 11 12",
+                        "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16"}) {
+    Eigen::Matrix4f fast, slow;
+    EXPECT_TRUE(gmCore::FastParser<Eigen::Matrix4f>::parse(s, fast)) << s;
+    EXPECT_TRUE(streamParse(s, slow)) << s;
+    EXPECT_EQ(slow, fast) << s;
+  }
+
+  for (std::string s : {"1 0 0 0", "quaternion 0 1 0 0", "QUATERNION 0 0 1 0"}) {
+    Eigen::Quaternionf fast, slow;
+    EXPECT_TRUE(gmCore::FastParser<Eigen::Quaternionf>::parse(s, fast)) << s;
+    EXPECT_TRUE(streamParse(s, slow)) << s;
+    EXPECT_EQ(slow.coeffs(), fast.coeffs()) << s;
+  }
+
+  for (std::string s : {"ypr 0.1 0 0", "axisangle 0 1 0 0.1"}) {
+    Eigen::Quaternionf fast;
+    EXPECT_FALSE(gmCore::FastParser<Eigen::Quaternionf>::parse(s, fast)) << s;
+  }
+}
+
+TEST(gmCoreFastParser, Poses) {
+
+  std::string s = "1 2 3; 1 0 0 0, 4 5 6, 7 8 9 ;quaternion 0 1 0 0,";
+
+  std::vector<gmCore::Pose> fast, slow;
+  EXPECT_TRUE(gmCore::FastParser<std::vector<gmCore::Pose>>::parse(s, fast));
+  EXPECT_TRUE(streamParse(s, slow));
+
+  ASSERT_EQ(3, fast.size());
+  ASSERT_EQ(slow.size(), fast.size());
+  for (size_t idx = 0; idx < fast.size(); ++idx) {
+    EXPECT_EQ(slow[idx].position, fast[idx].position);
+    EXPECT_EQ(slow[idx].orientation.coeffs(), fast[idx].orientation.coeffs());
+  }
+
+  std::vector<gmCore::Pose> bad;
+  EXPECT_FALSE(gmCore::FastParser<std::vector<gmCore::Pose>>::parse("1 2 3,,4 5 6", bad));
+  EXPECT_TRUE(bad.empty());
+}
+
+TEST(gmCoreFastParser, ParamSetter) {
+
+  FastParserTarget obj;
+
+  EXPECT_EQ("", setterError(obj, "i", "0x10"));
+  EXPECT_EQ(16, obj.i);
+  EXPECT_EQ("", setterError(obj, "i", "010"));
+  EXPECT_EQ(8, obj.i);
+  EXPECT_EQ("", setterError(obj, "i", "-12"));
+  EXPECT_EQ(-12, obj.i);
+  EXPECT_EQ("", setterError(obj, "s2", "0x10 5"));
+  EXPECT_EQ(16, obj.s2[0]);
+  EXPECT_EQ(5, obj.s2[1]);
+  EXPECT_EQ("", setterError(obj, "m", "1 2 3 4 5 6 7 8 9 x"));
+  EXPECT_EQ(1.f, obj.m(3, 3));
+  EXPECT_EQ("", setterError(obj, "path", "1 2 3; ypr 0 0 0, 4 5 6"));
+  EXPECT_EQ(2, obj.path.size());
+
+  // Error reporting is that of the stream based parsing
+  for (auto [name, value] : std::vector<std::pair<std::string, std::string>>{
+           {"i", "abc"}, {"s", "x1"}, {"f", "1e"}, {"f", "inf"},
+           {"s2", "1"}, {"m", "1 2 3"}, {"path", "1 2 3,,4 5 6"}}) {
+    auto error = setterError(obj, name, value);
+    EXPECT_EQ(0, error.find(GM_STR("cannot parse '" << value << "'")))
+      << name << " = " << value;
+  }
+}
+
+TEST(gmCoreFastParser, DISABLED_Benchmark100kFloats) {
+
+  const size_t N = 100000;
+
+  std::vector<std::string> values;
+  values.reserve(N);
+  for (size_t idx = 0; idx < N; ++idx)
+    values.push_back(GM_STR(0.001f * float(idx) - 17.f));
+
+  typedef gmCore::TimeTools::clock clock;
+
+  FastParserTarget obj;
+  double sum_fast = 0, sum_stream = 0, sum_setter = 0;
+
+  auto t0 = clock::now();
+  for (const auto &s : values) {
+    float val;
+    gmCore::FastParser<float>::parse(s, val);
+    sum_fast += val;
+  }
+  auto t1 = clock::now();
+  for (const auto &s : values) {
+    float val;
+    streamParse(s, val);
+    sum_stream += val;
+  }
+  auto t2 = clock::now();
+  for (const auto &s : values) {
+    FastParserTarget::_gm_ofi.setParamValueFromString(&obj, "f", s);
+    sum_setter += obj.f;
+  }
+  auto t3 = clock::now();
+
+  EXPECT_EQ(sum_stream, sum_fast);
+  EXPECT_EQ(sum_stream, sum_setter);
+
+  std::string path;
+  for (size_t idx = 0; idx < N / 7; ++idx)
+    path += GM_STR((idx ? ", " : "") << idx << " 0.5 -1; 1 0 0 0");
+
+  auto t4 = clock::now();
+  std::vector<gmCore::Pose> fast_path;
+  EXPECT_TRUE(gmCore::FastParser<std::vector<gmCore::Pose>>::parse(path, fast_path));
+  auto t5 = clock::now();
+  std::vector<gmCore::Pose> stream_path;
+  EXPECT_TRUE(streamParse(path, stream_path));
+  auto t6 = clock::now();
+
+  EXPECT_EQ(stream_path.size(), fast_path.size());
+
+  std::cout << "Parsing " << N << " floats: "
+            << gmCore::TimeTools::durationToSeconds(t1 - t0) << " s (fast), "
+            << gmCore::TimeTools::durationToSeconds(t2 - t1) << " s (stream), "
+            << gmCore::TimeTools::durationToSeconds(t3 - t2) << " s (through OFactory)"
+            << std::endl;
+  std::cout << "Parsing " << N / 7 << " poses: "
+            << gmCore::TimeTools::durationToSeconds(t5 - t4) << " s (fast), "
+            << gmCore::TimeTools::durationToSeconds(t6 - t5) << " s (stream)"
+            << std::endl;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include <gmCore/FrameArena.hh>
+#include <gmCore/Updateable.hh>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+struct TransientUpdateable : gmCore::Updateable {
+
+  TransientUpdateable() : gmCore::Updateable(0) {}
+
+  void update(clock::time_point, size_t frame) override {
+    std::pmr::unordered_map<int, double> map(gmCore::FrameArena::get());
+    std::pmr::vector<float> values(gmCore::FrameArena::get());
+    for (size_t idx = 0; idx < 100 + (frame % 10) * 100; ++idx) {
+      map[int(idx)] = double(idx);
+      values.push_back(float(idx));
+    }
+    sum += values.size() + map.size();
+  }
+
+  size_t sum = 0;
+};
+}
+
+TEST(gmCoreFrameArena, SteadyStateWithoutHeapAllocations) {
+
+  TransientUpdateable updateable;
+  gmCore::FrameArena::nextFrame();
+
+  // Warm up the arena to the largest frame
+  for (size_t frame = 0; frame < 10; ++frame)
+    gmCore::Updateable::updateAll(gmCore::Updateable::clock::now(), frame);
+
+  for (size_t frame = 10; frame < 30; ++frame) {
+    gmCore::Updateable::updateAll(gmCore::Updateable::clock::now(), frame);
+    auto statistics = gmCore::FrameArena::getFrameStatistics();
+    EXPECT_GT(statistics.allocation_count, 0);
+    EXPECT_GT(statistics.allocated_bytes, 0);
+    EXPECT_EQ(statistics.upstream_allocation_count, 0);
+  }
+
+  EXPECT_GT(updateable.sum, 0);
+}
+
+TEST(gmCoreFrameArena, CountsAllocations) {
+
+  gmCore::FrameArena::nextFrame();
+  {
+    std::pmr::vector<int> values(gmCore::FrameArena::get());
+    values.reserve(10);
+    std::pmr::string text(100, 'x', gmCore::FrameArena::get());
+  }
+  gmCore::FrameArena::nextFrame();
+
+  auto statistics = gmCore::FrameArena::getFrameStatistics();
+  EXPECT_EQ(statistics.allocation_count, 2);
+  EXPECT_GE(statistics.allocated_bytes, 10 * sizeof(int) + 100);
+}
+
+TEST(gmCoreFrameArena, Alignment) {
+
+  auto *arena = gmCore::FrameArena::get();
+
+  std::vector<void*> pointers;
+  for (size_t alignment : { 1, 2, 4, 8, 16, 32, 64, 128, 4096 }) {
+    void *ptr = arena->allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+    pointers.push_back(ptr);
+  }
+
+  // Larger than the current block
+  void *ptr = arena->allocate(1 << 20, 64);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 64, 0);
+  pointers.push_back(ptr);
+
+  for (auto ptr : pointers)
+    arena->deallocate(ptr, 3);
+}
+
+TEST(gmCoreFrameArena, LiveDataIsKept) {
+
+  std::pmr::vector<int> kept(gmCore::FrameArena::get());
+  for (int idx = 0; idx < 1000; ++idx) kept.push_back(idx);
+
+  // The arena must not rewind while kept is alive, even over frames
+  // and with other allocations coming and going
+  for (int frame = 0; frame < 5; ++frame) {
+    std::pmr::vector<int> transient(1000, -1, gmCore::FrameArena::get());
+    gmCore::FrameArena::nextFrame();
+  }
+
+  for (int idx = 0; idx < 1000; ++idx)
+    ASSERT_EQ(kept[idx], idx);
+}
+
+TEST(gmCoreFrameArena, ThreadLocalArenas) {
+
+  gmCore::FrameArena *main_arena = gmCore::FrameArena::get();
+  gmCore::FrameArena *thread_arena = nullptr;
+
+  std::pmr::vector<int> values(1000, 1, main_arena);
+
+  std::thread thread([&] {
+    thread_arena = gmCore::FrameArena::get();
+    // Deallocation from another thread than the owning
+    values = std::pmr::vector<int>(main_arena);
+    std::pmr::vector<int> other(1000, 2, thread_arena);
+    EXPECT_EQ(other.back(), 2);
+  });
+  thread.join();
+
+  EXPECT_NE(main_arena, thread_arena);
+  EXPECT_EQ(gmCore::FrameArena::get(), main_arena);
+}
+
+TEST(gmCoreFrameArena, LiveDataDoesNotGrowArena) {
+
+  std::pmr::vector<int> kept(10, 1, gmCore::FrameArena::get());
+
+  // Only the block of the kept data is held, so that later frames
+  // reuse the other blocks
+  for (int frame = 0; frame < 20; ++frame) {
+    {
+      std::pmr::vector<int> transient(100000, -1, gmCore::FrameArena::get());
+    }
+    gmCore::FrameArena::nextFrame();
+    if (frame > 2) {
+      EXPECT_EQ(gmCore::FrameArena::getFrameStatistics().upstream_allocation_count, 0);
+    }
+  }
+
+  EXPECT_EQ(kept.back(), 1);
+}
+
+TEST(gmCoreFrameArena, ArenasOfExitedThreadsAreReused) {
+
+  gmCore::FrameArena *first_arena = nullptr;
+  std::pmr::vector<int> values;
+
+  std::thread first([&] {
+    first_arena = gmCore::FrameArena::get();
+    values = std::pmr::vector<int>(1000, 3, first_arena);
+  });
+  first.join();
+
+  // Data from the arena of an exited thread is still valid
+  EXPECT_EQ(values.back(), 3);
+
+  gmCore::FrameArena *second_arena = nullptr;
+  std::thread second([&] { second_arena = gmCore::FrameArena::get(); });
+  second.join();
+
+  EXPECT_EQ(first_arena, second_arena);
+}
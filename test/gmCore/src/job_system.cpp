@@ -0,0 +1,167 @@
+#include <gmCore/JobSystem.hh>
+#include <gmCore/Updateable.hh>
+#include <gmCore/RuntimeException.hh>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+TEST(gmCoreJobSystem, ParallelFor) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(3);
+  job_system->initialize();
+
+  EXPECT_EQ(3, job_system->getWorkerCount());
+  EXPECT_EQ(job_system, gmCore::JobSystem::get());
+
+  std::vector<int> data(100000, 0);
+  job_system->parallelFor(0, data.size(), [&data](size_t begin, size_t end) {
+    for (size_t idx = begin; idx < end; ++idx) data[idx] = int(idx % 7);
+  });
+
+  long long sum = std::accumulate(data.begin(), data.end(), 0ll);
+  long long expected = 0;
+  for (size_t idx = 0; idx < data.size(); ++idx) expected += idx % 7;
+  EXPECT_EQ(expected, sum);
+
+  std::atomic<size_t> smallest_chunk = data.size();
+  job_system->parallelFor(0, data.size(), [&](size_t begin, size_t end) {
+    size_t current = smallest_chunk;
+    while (end - begin < current &&
+           !smallest_chunk.compare_exchange_weak(current, end - begin)) {}
+  }, 30000);
+  EXPECT_LE(30000, smallest_chunk);
+
+  EXPECT_THROW(job_system->parallelFor(0, 1000, [](size_t begin, size_t) {
+    if (begin == 0) throw gmCore::RuntimeException("first chunk");
+  }), gmCore::RuntimeException);
+}
+
+TEST(gmCoreJobSystem, NestedTaskGroups) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(2);
+  job_system->initialize();
+
+  std::atomic<int> count = 0;
+
+  gmCore::JobSystem::TaskGroup outer(*job_system);
+  for (int idx = 0; idx < 16; ++idx)
+    outer.run([&] {
+      // Waiting inside a job must help out rather than block
+      gmCore::JobSystem::TaskGroup inner(*job_system);
+      for (int jdx = 0; jdx < 16; ++jdx)
+        inner.run([&] { ++count; });
+      inner.wait();
+    });
+  outer.wait();
+
+  EXPECT_EQ(256, count);
+}
+
+TEST(gmCoreJobSystem, WaitRunsOnlyGroupJobs) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(1);
+  job_system->initialize();
+
+  // Keep the only worker busy
+  std::promise<void> started;
+  std::promise<void> release;
+  job_system->submit([&started, blocker = release.get_future().share()] {
+    started.set_value();
+    blocker.wait();
+  });
+  started.get_future().wait();
+
+  auto unrelated = job_system->async([] { return std::this_thread::get_id(); });
+
+  std::thread::id group_thread;
+  gmCore::JobSystem::TaskGroup group(*job_system);
+  group.run([&group_thread] { group_thread = std::this_thread::get_id(); });
+  group.wait();
+
+  // The waiting thread ran its own job but not the unrelated one
+  EXPECT_EQ(std::this_thread::get_id(), group_thread);
+  EXPECT_EQ(std::future_status::timeout,
+            unrelated.wait_for(std::chrono::milliseconds(10)));
+
+  release.set_value();
+  EXPECT_NE(std::this_thread::get_id(), unrelated.get());
+}
+
+TEST(gmCoreJobSystem, Futures) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(2);
+  job_system->initialize();
+
+  auto answer = job_system->async([] { return 42; });
+  auto failure = job_system->async([]() -> int {
+    throw gmCore::RuntimeException("failure");
+  });
+
+  EXPECT_EQ(42, answer.get());
+  EXPECT_THROW(failure.get(), gmCore::RuntimeException);
+}
+
+TEST(gmCoreJobSystem, FrameBarrier) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(2);
+  job_system->setFrameBarrier(true);
+  job_system->initialize();
+
+  std::atomic<int> count = 0;
+  for (int idx = 0; idx < 10; ++idx)
+    job_system->submitFrameJob([&count] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      ++count;
+    });
+
+  gmCore::Updateable::updateAll();
+  EXPECT_EQ(10, count);
+}
+
+TEST(gmCoreJobSystem, Uninitialized) {
+
+  gmCore::JobSystem job_system;
+
+  int count = 0;
+  job_system.submit([&count] { ++count; });
+  job_system.parallelFor(0, 10, [&count](size_t begin, size_t end) {
+    count += int(end - begin);
+  });
+  EXPECT_EQ(11, count);
+}
+
+TEST(gmCoreJobSystem, ReleasedFromJob) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(2);
+  job_system->initialize();
+
+  std::promise<void> submitted;
+  std::promise<void> released;
+  std::future<void> done = released.get_future();
+
+  // The worker running this job releases the last reference
+  gmCore::JobSystem &system = *job_system;
+  system.submit([job_system = std::move(job_system),
+                 ready = submitted.get_future().share(),
+                 &released]() mutable {
+    ready.wait();
+    job_system.reset();
+    released.set_value();
+  });
+  submitted.set_value();
+
+  EXPECT_EQ(std::future_status::ready,
+            done.wait_for(std::chrono::seconds(10)));
+}
@@ -0,0 +1,251 @@
+#include <gmCore/SpscQueue.hh>
+#include <gmCore/MpscQueue.hh>
+#include <gmCore/TripleBuffer.hh>
+#include <gmCore/TimeTools.hh>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+TEST(gmCoreLockFree, SpscQueueBasics) {
+
+  gmCore::SpscQueue<std::string> queue(3);
+  EXPECT_EQ(queue.capacity(), 4);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.tryPop());
+
+  for (int idx = 0; idx < 4; ++idx)
+    EXPECT_TRUE(queue.tryPush(std::to_string(idx)));
+  EXPECT_FALSE(queue.tryPush("overflow"));
+  EXPECT_EQ(queue.size(), 4);
+
+  for (int idx = 0; idx < 4; ++idx) {
+    auto value = queue.tryPop();
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, std::to_string(idx));
+  }
+  EXPECT_FALSE(queue.tryPop());
+  EXPECT_TRUE(queue.tryPush("again"));
+}
+
+TEST(gmCoreLockFree, SpscQueueOrderAcrossThreads) {
+
+  const size_t N = 200000;
+  gmCore::SpscQueue<size_t> queue(64);
+
+  std::thread producer([&] {
+    for (size_t idx = 0; idx < N; )
+      if (queue.tryPush(idx)) ++idx;
+      else std::this_thread::yield();
+  });
+
+  size_t expected = 0;
+  bool in_order = true;
+  while (expected < N) {
+    size_t value;
+    if (!queue.tryPop(value)) { std::this_thread::yield(); continue; }
+    in_order = in_order && value == expected;
+    ++expected;
+  }
+  producer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(gmCoreLockFree, MpscQueueBasics) {
+
+  gmCore::MpscQueue<int> queue(2);
+  EXPECT_TRUE(queue.tryPush(1));
+  EXPECT_TRUE(queue.tryPush(2));
+  EXPECT_FALSE(queue.tryPush(3));
+
+  EXPECT_EQ(queue.tryPop(), 1);
+  EXPECT_TRUE(queue.tryPush(3));
+  EXPECT_EQ(queue.tryPop(), 2);
+  EXPECT_EQ(queue.tryPop(), 3);
+  EXPECT_FALSE(queue.tryPop());
+}
+
+TEST(gmCoreLockFree, MpscQueueManyProducers) {
+
+  const size_t PRODUCERS = 4;
+  const size_t N = 50000;
+  gmCore::MpscQueue<std::pair<size_t, size_t>> queue(128);
+
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer < PRODUCERS; ++producer)
+    producers.emplace_back([&queue, producer, N] {
+      for (size_t idx = 0; idx < N; )
+        if (queue.tryPush({ producer, idx })) ++idx;
+        else std::this_thread::yield();
+    });
+
+  // Each producer's values must arrive in order and none be lost
+  std::array<size_t, PRODUCERS> next = {};
+  bool in_order = true;
+  for (size_t count = 0; count < PRODUCERS * N; ) {
+    std::pair<size_t, size_t> value;
+    if (!queue.tryPop(value)) { std::this_thread::yield(); continue; }
+    in_order = in_order && value.second == next[value.first];
+    ++next[value.first];
+    ++count;
+  }
+  for (auto &thread : producers) thread.join();
+
+  EXPECT_TRUE(in_order);
+  for (auto count : next) EXPECT_EQ(count, N);
+  EXPECT_FALSE(queue.tryPop());
+}
+
+TEST(gmCoreLockFree, TripleBufferBasics) {
+
+  gmCore::TripleBuffer<int> buffer(-1);
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.getReadBuffer(), -1);
+
+  EXPECT_FALSE(buffer.write(1));
+  EXPECT_TRUE(buffer.write(2));
+  EXPECT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.getReadBuffer(), 2);
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.getReadBuffer(), 2);
+
+  buffer.getWriteBuffer() = 3;
+  EXPECT_FALSE(buffer.publish());
+  int value = 0;
+  EXPECT_TRUE(buffer.read(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(buffer.read(value));
+}
+
+TEST(gmCoreLockFree, TripleBufferConsistentAcrossThreads) {
+
+  // Every published value is internally consistent and values never
+  // go backwards
+  struct Data { size_t a, b, c; };
+  gmCore::TripleBuffer<Data> buffer(Data{ 0, 0, 0 });
+
+  const size_t N = 200000;
+  std::atomic<bool> done = false;
+  std::thread writer([&] {
+    for (size_t idx = 1; idx <= N; ++idx) {
+      Data &data = buffer.getWriteBuffer();
+      data.a = idx;
+      data.b = 2 * idx;
+      data.c = 3 * idx;
+      buffer.publish();
+    }
+    done = true;
+  });
+
+  bool consistent = true, monotonic = true;
+  size_t last = 0, reads = 0;
+  while (true) {
+    bool finished = done;
+    if (!buffer.update()) {
+      if (finished) break;
+      std::this_thread::yield();
+      continue;
+    }
+    const Data &data = buffer.getReadBuffer();
+    consistent = consistent && data.b == 2 * data.a && data.c == 3 * data.a;
+    monotonic = monotonic && data.a > last;
+    last = data.a;
+    ++reads;
+  }
+  writer.join();
+
+  EXPECT_TRUE(consistent);
+  EXPECT_TRUE(monotonic);
+  EXPECT_GT(reads, 0);
+  EXPECT_EQ(last, N);
+}
+
+TEST(gmCoreLockFree, DISABLED_Benchmark1MHandoffs) {
+
+  const size_t N = 1000000;
+  typedef gmCore::TimeTools::clock clock;
+
+  auto t0 = clock::now();
+  {
+    gmCore::SpscQueue<size_t> queue(1024);
+    std::thread producer([&] {
+      for (size_t idx = 0; idx < N; )
+        if (queue.tryPush(idx)) ++idx;
+        else std::this_thread::yield();
+    });
+    for (size_t count = 0; count < N; ) {
+      size_t value;
+      if (queue.tryPop(value)) ++count;
+      else std::this_thread::yield();
+    }
+    producer.join();
+  }
+
+  auto t1 = clock::now();
+  {
+    gmCore::MpscQueue<size_t> queue(1024);
+    std::thread producer([&] {
+      for (size_t idx = 0; idx < N; )
+        if (queue.tryPush(idx)) ++idx;
+        else std::this_thread::yield();
+    });
+    for (size_t count = 0; count < N; ) {
+      size_t value;
+      if (queue.tryPop(value)) ++count;
+      else std::this_thread::yield();
+    }
+    producer.join();
+  }
+
+  auto t2 = clock::now();
+  {
+    // The pattern these replace
+    std::mutex lock;
+    std::deque<size_t> queue;
+    std::thread producer([&] {
+      for (size_t idx = 0; idx < N; ++idx) {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(idx);
+      }
+    });
+    for (size_t count = 0; count < N; ) {
+      std::unique_lock<std::mutex> guard(lock);
+      if (queue.empty()) {
+        guard.unlock();
+        std::this_thread::yield();
+        continue;
+      }
+      queue.pop_front();
+      ++count;
+    }
+    producer.join();
+  }
+
+  auto t3 = clock::now();
+  {
+    gmCore::TripleBuffer<size_t> buffer(0);
+    std::thread writer([&] {
+      for (size_t idx = 1; idx <= N; ++idx) buffer.write(idx);
+    });
+    while (buffer.getReadBuffer() < N)
+      if (!buffer.update()) std::this_thread::yield();
+    writer.join();
+  }
+  auto t4 = clock::now();
+
+  std::cout << "Passing " << N << " values between threads: "
+            << gmCore::TimeTools::durationToSeconds(t1 - t0) << " s (SPSC), "
+            << gmCore::TimeTools::durationToSeconds(t2 - t1) << " s (MPSC), "
+            << gmCore::TimeTools::durationToSeconds(t3 - t2) << " s (mutex+deque), "
+            << gmCore::TimeTools::durationToSeconds(t4 - t3) << " s (triple buffer writes)"
+            << std::endl;
+}
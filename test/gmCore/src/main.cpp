@@ -3,8 +3,16 @@
 
 #define gramods_STRIP_PATH_FROM_FILE
 
+#include "fast_parser.cpp"
+#include "param_sidecar.cpp"
 #include "angle.cpp"
 #include "eigen.cpp"
+#include "pose_array.cpp"
+#include "job_system.cpp"
+#include "updateable.cpp"
+#include "profiler.cpp"
+#include "frame_arena.cpp"
+#include "lock_free.cpp"
 
 #include "base_config_functionality.cpp"
 #include "load_empty_lib_config_file.cpp"
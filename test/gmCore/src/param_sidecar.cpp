@@ -0,0 +1,279 @@
+#include <gmCore/config.hh>
+
+#ifdef gramods_ENABLE_Eigen3
+
+#include <gmCore/ParamSidecar.hh>
+#include <gmCore/MappedFile.hh>
+#include <gmCore/OFactory.hh>
+#include <gmCore/Configuration.hh>
+#include <gmCore/io_eigen.hh>
+#include <gmCore/Pose.hh>
+#include <gmCore/TimeTools.hh>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+
+struct SidecarTarget : gmCore::Object {
+  std::vector<std::string> keys;
+  std::vector<double> times;
+  std::vector<Eigen::Vector3f> positions;
+  std::vector<gmCore::Pose> path;
+  std::vector<int> counts;
+  std::vector<bool> flags;
+  int path_calls = 0;
+  void addKey(std::string v) { keys.push_back(v); }
+  void addCount(int v) { counts.push_back(v); }
+  void addFlag(bool v) { flags.push_back(v); }
+  void addTime(double v) { times.push_back(v); }
+  void addPosition(Eigen::Vector3f v) { positions.push_back(v); }
+  void setPath(std::vector<gmCore::Pose> v) { path = v; ++path_calls; }
+  GM_OFI_DECLARE;
+};
+
+GM_OFI_DEFINE(SidecarTarget);
+GM_OFI_PARAM2(SidecarTarget, key, std::string, addKey);
+GM_OFI_PARAM2(SidecarTarget, time, double, addTime);
+GM_OFI_PARAM2(SidecarTarget, position, Eigen::Vector3f, addPosition);
+GM_OFI_PARAM2(SidecarTarget, path, std::vector<gmCore::Pose>, setPath);
+GM_OFI_PARAM2(SidecarTarget, count, int, addCount);
+GM_OFI_PARAM2(SidecarTarget, flag, bool, addFlag);
+
+std::filesystem::path writeSidecar(std::string name, const std::string &data) {
+  auto path = std::filesystem::temp_directory_path() / ("gramods_test_" + name);
+  std::ofstream out(path, std::ios::binary);
+  out.write(data.data(), data.size());
+  return path;
+}
+
+template<class T>
+std::filesystem::path writeSidecar(std::string name, const std::vector<T> &data) {
+  return writeSidecar(name, std::string(reinterpret_cast<const char *>(data.data()),
+                                        data.size() * sizeof(T)));
+}
+}
+
+TEST(gmCoreParamSidecar, MappedFile) {
+
+  auto path = writeSidecar("mapped.txt", "hello\nworld");
+  gmCore::MappedFile file(path);
+  EXPECT_EQ("hello\nworld", file.view());
+  EXPECT_EQ(path, file.getPath());
+
+  auto empty_path = writeSidecar("empty.txt", "");
+  gmCore::MappedFile empty(empty_path);
+  EXPECT_EQ(0, empty.size());
+  EXPECT_TRUE(empty.view().empty());
+
+  EXPECT_THROW(gmCore::MappedFile("/nonexisting/gramods/file"),
+               gmCore::InvalidArgument);
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(empty_path);
+}
+
+TEST(gmCoreParamSidecar, Text) {
+
+  typedef gmCore::ParamSidecar::Format Format;
+  EXPECT_EQ(Format::Text, gmCore::ParamSidecar::parseFormat("", "a.CSV"));
+  EXPECT_EQ(Format::Float32, gmCore::ParamSidecar::parseFormat("", "a.bin"));
+  EXPECT_EQ(Format::Float64, gmCore::ParamSidecar::parseFormat("Float64", "a.csv"));
+  EXPECT_THROW(gmCore::ParamSidecar::parseFormat("int8", "a.bin"),
+               gmCore::InvalidArgument);
+
+  auto key_path = writeSidecar("keys.csv", "# key\r\nhead\r\n\r\nleft hand\r\n");
+  auto pos_path = writeSidecar("positions.csv",
+                               "# x, y, z\n1, 2, 3\n  4 5 6\n7;8;9\n");
+  auto path_path = writeSidecar("path.csv", "1,2,3,1,0,0,0\n4,5,6,0,1,0,0\n");
+  auto bad_path = writeSidecar("bad.csv", "1, 2, 3\n4, 5\n");
+
+  SidecarTarget obj;
+  auto &ofi = SidecarTarget::_gm_ofi;
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "key", gmCore::ParamSidecar(key_path, Format::Text)));
+  ASSERT_EQ(2, obj.keys.size());
+  EXPECT_EQ("head", obj.keys[0]);
+  EXPECT_EQ("left hand", obj.keys[1]);
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "position", gmCore::ParamSidecar(pos_path, Format::Text)));
+  ASSERT_EQ(3, obj.positions.size());
+  EXPECT_EQ(Eigen::Vector3f(4, 5, 6), obj.positions[1]);
+  EXPECT_EQ(Eigen::Vector3f(7, 8, 9), obj.positions[2]);
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "path", gmCore::ParamSidecar(path_path, Format::Text)));
+  EXPECT_EQ(1, obj.path_calls);
+  ASSERT_EQ(2, obj.path.size());
+  EXPECT_EQ(Eigen::Vector3f(4, 5, 6), obj.path[1].position);
+  EXPECT_EQ(1.f, obj.path[1].orientation.x());
+
+  EXPECT_FALSE(ofi.setParamValuesFromSidecar(
+      &obj, "nothing", gmCore::ParamSidecar(pos_path, Format::Text)));
+  EXPECT_THROW(ofi.setParamValuesFromSidecar(
+                   &obj, "position", gmCore::ParamSidecar(bad_path, Format::Text)),
+               gmCore::InvalidArgument);
+
+  for (auto path : { key_path, pos_path, path_path, bad_path })
+    std::filesystem::remove(path);
+}
+
+TEST(gmCoreParamSidecar, TextAsInline) {
+
+  typedef gmCore::ParamSidecar::Format Format;
+
+  // Lines that are not plain numbers are parsed as inline values
+  auto count_path = writeSidecar("counts.csv", "0x10\n7\n010\n");
+  auto flag_path = writeSidecar("flags.txt", "true\noff\n1\n");
+  auto bad_path = writeSidecar("bad_counts.csv", "7\nseven\n");
+
+  SidecarTarget obj;
+  auto &ofi = SidecarTarget::_gm_ofi;
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "count", gmCore::ParamSidecar(count_path, Format::Text)));
+  EXPECT_EQ(std::vector<int>({ 16, 7, 8 }), obj.counts);
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "flag", gmCore::ParamSidecar(flag_path, Format::Text)));
+  EXPECT_EQ(std::vector<bool>({ true, false, true }), obj.flags);
+
+  EXPECT_THROW(ofi.setParamValuesFromSidecar(
+                   &obj, "count", gmCore::ParamSidecar(bad_path, Format::Text)),
+               gmCore::InvalidArgument);
+
+  for (auto path : { count_path, flag_path, bad_path })
+    std::filesystem::remove(path);
+}
+
+TEST(gmCoreParamSidecar, Binary) {
+
+  typedef gmCore::ParamSidecar::Format Format;
+
+  auto time_path = writeSidecar("times.f64", std::vector<double>{ 0.5, 1.5, 2.5 });
+  auto pos_path = writeSidecar("positions.bin", std::vector<float>{ 1, 2, 3, 4, 5, 6 });
+  auto bad_path = writeSidecar("bad.bin", std::vector<float>{ 1, 2, 3, 4 });
+
+  SidecarTarget obj;
+  auto &ofi = SidecarTarget::_gm_ofi;
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "time", gmCore::ParamSidecar(time_path, Format::Float64)));
+  EXPECT_EQ(std::vector<double>({ 0.5, 1.5, 2.5 }), obj.times);
+
+  EXPECT_TRUE(ofi.setParamValuesFromSidecar(
+      &obj, "position", gmCore::ParamSidecar(pos_path, Format::Float32)));
+  ASSERT_EQ(2, obj.positions.size());
+  EXPECT_EQ(Eigen::Vector3f(4, 5, 6), obj.positions[1]);
+
+  EXPECT_THROW(ofi.setParamValuesFromSidecar(
+                   &obj, "position", gmCore::ParamSidecar(bad_path, Format::Float32)),
+               gmCore::InvalidArgument);
+  // Strings cannot be read from binary data
+  EXPECT_THROW(ofi.setParamValuesFromSidecar(
+                   &obj, "key", gmCore::ParamSidecar(pos_path, Format::Float32)),
+               gmCore::InvalidArgument);
+
+  for (auto path : { time_path, pos_path, bad_path })
+    std::filesystem::remove(path);
+}
+
+#ifdef gramods_ENABLE_TinyXML2
+TEST(gmCoreParamSidecar, Configuration) {
+
+  auto pos_path = writeSidecar("config_positions.bin", std::vector<float>{ 1, 2, 3, 4, 5, 6 });
+  auto time_path = writeSidecar("config_times.csv", "0.5\n1.5\n");
+
+  std::string xml = GM_STR("<config><SidecarTarget>"
+                           << "<param name=\"position\" value=\"0 0 0\"/>"
+                           << "<param name=\"position\" file=\"" << pos_path.string() << "\"/>"
+                           << "<param name=\"time\" file=\"" << time_path.string() << "\"/>"
+                           << "</SidecarTarget></config>");
+
+  gmCore::Configuration config(xml);
+
+  std::shared_ptr<SidecarTarget> obj;
+  ASSERT_TRUE(config.getObject(obj));
+  ASSERT_EQ(3, obj->positions.size());
+  EXPECT_EQ(Eigen::Vector3f(0, 0, 0), obj->positions[0]);
+  EXPECT_EQ(Eigen::Vector3f(4, 5, 6), obj->positions[2]);
+  EXPECT_EQ(std::vector<double>({ 0.5, 1.5 }), obj->times);
+
+  // Parameters read through the configuration resolve the sidecar
+  gmCore::Configuration params(GM_STR("<config>"
+                                      << "<param name=\"position\" file=\"" << pos_path.string() << "\"/>"
+                                      << "<param name=\"time\" file=\"" << time_path.string() << "\"/>"
+                                      << "</config>"));
+  Eigen::Vector3f position;
+  ASSERT_TRUE(params.getParam("position", position));
+  EXPECT_EQ(Eigen::Vector3f(1, 2, 3), position);
+  std::vector<double> times;
+  EXPECT_EQ(2, params.getAllParams("time", times));
+  EXPECT_EQ(std::vector<double>({ 0.5, 1.5 }), times);
+  std::string time;
+  ASSERT_TRUE(params.getParam("time", time));
+  EXPECT_EQ("0.5", time);
+
+  std::filesystem::remove(pos_path);
+  std::filesystem::remove(time_path);
+}
+#endif
+
+TEST(gmCoreParamSidecar, DISABLED_Benchmark100kPositions) {
+
+  const size_t N = 100000;
+
+  std::vector<float> data;
+  std::vector<Eigen::Vector3f> positions;
+  std::vector<std::string> strings;
+  for (size_t idx = 0; idx < N; ++idx) {
+    Eigen::Vector3f p(0.001f * float(idx), -1.f, 17.f);
+    data.insert(data.end(), { p.x(), p.y(), p.z() });
+    positions.push_back(p);
+    strings.push_back(GM_STR(p.x() << " " << p.y() << " " << p.z()));
+  }
+  std::string csv;
+  for (const auto &s : strings) csv += s + "\n";
+
+  auto bin_path = writeSidecar("bench.bin", data);
+  auto csv_path = writeSidecar("bench.csv", csv);
+
+  typedef gmCore::TimeTools::clock clock;
+  auto &ofi = SidecarTarget::_gm_ofi;
+  SidecarTarget obj_strings, obj_csv, obj_bin;
+
+  auto t0 = clock::now();
+  for (const auto &s : strings)
+    ofi.setParamValueFromString(&obj_strings, "position", s);
+  auto t1 = clock::now();
+  ofi.setParamValuesFromSidecar(
+      &obj_csv, "position",
+      gmCore::ParamSidecar(csv_path, gmCore::ParamSidecar::Format::Text));
+  auto t2 = clock::now();
+  ofi.setParamValuesFromSidecar(
+      &obj_bin, "position",
+      gmCore::ParamSidecar(bin_path, gmCore::ParamSidecar::Format::Float32));
+  auto t3 = clock::now();
+
+  ASSERT_EQ(N, obj_csv.positions.size());
+  ASSERT_EQ(N, obj_bin.positions.size());
+  EXPECT_EQ(obj_strings.positions, obj_csv.positions);
+  EXPECT_EQ(positions, obj_bin.positions);
+
+  std::cout << "Setting " << N << " positions: "
+            << gmCore::TimeTools::durationToSeconds(t1 - t0) << " s (param values), "
+            << gmCore::TimeTools::durationToSeconds(t2 - t1) << " s (CSV sidecar), "
+            << gmCore::TimeTools::durationToSeconds(t3 - t2) << " s (binary sidecar)"
+            << std::endl;
+
+  std::filesystem::remove(bin_path);
+  std::filesystem::remove(csv_path);
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include <gmCore/config.hh>
+
+#ifdef gramods_ENABLE_Eigen3
+
+#include <gmCore/PoseArray.hh>
+
+#include <random>
+
+using namespace gramods;
+
+namespace {
+std::vector<gmCore::Pose> randomPoses(size_t N, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<gmCore::Pose> poses;
+  for (size_t idx = 0; idx < N; ++idx)
+    poses.push_back({ Eigen::Vector3f(dist(rng), dist(rng), dist(rng)) * 3.f,
+                      Eigen::Quaternionf(dist(rng), dist(rng), dist(rng), dist(rng))
+                      .normalized() });
+  return poses;
+}
+
+void expectNear(const gmCore::Pose &a, const gmCore::Pose &b, float epsilon = 1e-5f) {
+  EXPECT_LE((a.position - b.position).norm(), epsilon)
+    << a.position.transpose() << " != " << b.position.transpose();
+  EXPECT_GE(std::abs(a.orientation.dot(b.orientation)), 1.f - epsilon)
+    << a.orientation << " != " << b.orientation;
+}
+
+gmCore::Pose multiply(const gmCore::Pose &a, const gmCore::Pose &b) {
+  return { a.position + a.orientation * b.position, a.orientation * b.orientation };
+}
+}
+
+TEST(gmCorePoseArray, Storage) {
+
+  auto poses = randomPoses(10, 1);
+  gmCore::PoseArray array(poses);
+  EXPECT_EQ(array.size(), 10);
+  for (size_t idx = 0; idx < poses.size(); ++idx)
+    expectNear(array.get(idx), poses[idx], 1e-6f);
+
+  array.resize(12);
+  expectNear(array.get(11), gmCore::Pose(), 1e-6f);
+  array.set(11, poses[0]);
+  expectNear(array.toPoses()[11], poses[0], 1e-6f);
+
+  array.clear();
+  EXPECT_TRUE(array.empty());
+}
+
+TEST(gmCorePoseArray, Compose) {
+
+  // Larger than one chunk and not a multiple of it
+  auto a = randomPoses(150, 2);
+  auto b = randomPoses(150, 3);
+  gmCore::PoseArray A(a), B(b), out;
+
+  gmCore::PoseArray::compose(A, B, out);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    expectNear(out.get(idx), multiply(a[idx], b[idx]));
+
+  gmCore::PoseArray::compose(a[0], B, out);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    expectNear(out.get(idx), multiply(a[0], b[idx]));
+
+  // In place
+  gmCore::PoseArray::compose(A, b[0], A);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    expectNear(A.get(idx), multiply(a[idx], b[0]));
+}
+
+TEST(gmCorePoseArray, ComposeAffine) {
+
+  auto b = randomPoses(70, 4);
+  gmCore::PoseArray B(b), out;
+
+  Eigen::Quaternionf R(Eigen::AngleAxisf(0.3f, Eigen::Vector3f(1, 2, 3).normalized()));
+  Eigen::Affine3f A = Eigen::Translation3f(1.f, -2.f, 3.f) * R * Eigen::Scaling(2.f);
+  gmCore::Pose c = randomPoses(1, 5)[0];
+
+  gmCore::PoseArray::compose(A, R, B, c, out);
+  for (size_t idx = 0; idx < b.size(); ++idx) {
+    gmCore::Pose bc = multiply(b[idx], c);
+    expectNear(out.get(idx), { A * bc.position, R * bc.orientation }, 1e-4f);
+  }
+}
+
+TEST(gmCorePoseArray, InverseAndPoints) {
+
+  auto a = randomPoses(100, 6);
+  gmCore::PoseArray A(a), inv, identity;
+
+  gmCore::PoseArray::inverse(A, inv);
+  gmCore::PoseArray::compose(A, inv, identity);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    expectNear(identity.get(idx), gmCore::Pose());
+
+  Eigen::Vector3f point(0.1f, 0.2f, -0.3f);
+  Eigen::Matrix3Xf out;
+  gmCore::PoseArray::transformPoint(A, point, out);
+  ASSERT_EQ(out.cols(), 100);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    EXPECT_LE((out.col(idx) - a[idx].asMatrix() * point).norm(), 1e-5f);
+
+  Eigen::Matrix3Xf points = Eigen::Matrix3Xf::Random(3, 100);
+  gmCore::PoseArray::transformPoints(A, points, out);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    EXPECT_LE((out.col(idx) - a[idx].asMatrix() * points.col(idx)).norm(), 1e-5f);
+}
+
+TEST(gmCorePoseArray, Interpolation) {
+
+  auto a = randomPoses(100, 7);
+  auto b = randomPoses(100, 8);
+  // Nearly parallel orientations
+  b[0].orientation = a[0].orientation;
+  b[1].orientation = Eigen::Quaternionf(-a[1].orientation.coeffs());
+
+  gmCore::PoseArray A(a), B(b), out;
+
+  for (float t : { 0.f, 0.25f, 0.5f, 1.f }) {
+    gmCore::PoseArray::slerp(A, B, t, out);
+    for (size_t idx = 0; idx < a.size(); ++idx)
+      expectNear(out.get(idx),
+                 { a[idx].position + t * (b[idx].position - a[idx].position),
+                   a[idx].orientation.slerp(t, b[idx].orientation) });
+
+    gmCore::PoseArray::lerp(A, B, t, out);
+    for (size_t idx = 0; idx < a.size(); ++idx)
+      EXPECT_NEAR(out.get(idx).orientation.norm(), 1.f, 1e-5f);
+  }
+
+  gmCore::PoseArray::lerp(A, B, 1.f, out);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    expectNear(out.get(idx), b[idx]);
+}
+
+TEST(gmCorePoseArray, Matrices) {
+
+  auto a = randomPoses(100, 9);
+  std::vector<Eigen::Matrix4f> matrices;
+  gmCore::PoseArray::toMatrices(gmCore::PoseArray(a), matrices);
+  ASSERT_EQ(matrices.size(), 100);
+  for (size_t idx = 0; idx < a.size(); ++idx)
+    EXPECT_LE((matrices[idx] - a[idx].asMatrix().matrix()).norm(), 1e-5f);
+}
+
+#endif
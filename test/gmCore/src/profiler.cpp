@@ -0,0 +1,123 @@
+#include <gmCore/Profiler.hh>
+#include <gmCore/Updateable.hh>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef gramods_ENABLE_nlohmann_json
+#include <nlohmann/json.hpp>
+#endif
+
+using namespace gramods;
+
+namespace {
+void profiledFunction() {
+  GM_PROFILE_SCOPE("profiledFunction");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+size_t countZones(const std::string &trace, const std::string &name) {
+  size_t count = 0;
+  std::string pattern = "\"name\":\"" + name + "\"";
+  for (size_t pos = trace.find(pattern); pos != std::string::npos;
+       pos = trace.find(pattern, pos + 1))
+    ++count;
+  return count;
+}
+}
+
+TEST(gmCoreProfiler, Inactive) {
+  ASSERT_FALSE(gmCore::Profiler::isActive());
+  profiledFunction();
+
+  gmCore::Profiler profiler;
+  std::stringstream ss;
+  profiler.writeTrace(ss);
+  EXPECT_EQ(0, countZones(ss.str(), "profiledFunction"));
+}
+
+TEST(gmCoreProfiler, ChromeTrace) {
+
+  auto profiler = std::make_shared<gmCore::Profiler>();
+  profiler->initialize();
+  EXPECT_TRUE(gmCore::Profiler::isActive());
+
+  profiledFunction();
+  std::thread thread([] {
+    for (int idx = 0; idx < 3; ++idx) profiledFunction();
+  });
+  thread.join();
+
+  gmCore::Updateable::updateAll();
+
+  std::stringstream ss;
+  profiler->writeTrace(ss);
+
+  std::string trace = ss.str();
+  EXPECT_EQ(4, countZones(trace, "profiledFunction"));
+  EXPECT_LE(1, countZones(trace, "Updateable::updateAll"));
+
+#ifdef gramods_ENABLE_nlohmann_json
+  auto json = nlohmann::json::parse(trace);
+  ASSERT_TRUE(json.contains("traceEvents"));
+  size_t zone_count = 0;
+  for (auto &event : json["traceEvents"])
+    if (event["name"] == "profiledFunction") {
+      ++zone_count;
+      EXPECT_EQ("X", event["ph"]);
+      EXPECT_LE(1000.0, event["dur"].get<double>());
+    }
+  EXPECT_EQ(4, zone_count);
+#endif
+
+  profiler->writeSummary();
+  profiler.reset();
+  EXPECT_FALSE(gmCore::Profiler::isActive());
+}
+
+TEST(gmCoreProfiler, RingBuffer) {
+
+  auto profiler = std::make_shared<gmCore::Profiler>();
+  profiler->setBufferSize(8);
+  profiler->initialize();
+
+  std::thread thread([] {
+    for (int idx = 0; idx < 100; ++idx) {
+      GM_PROFILE_SCOPE("ringBufferZone");
+    }
+  });
+  thread.join();
+
+  std::stringstream ss;
+  profiler->writeTrace(ss);
+  // The zone currently being written is never read
+  EXPECT_EQ(7, countZones(ss.str(), "ringBufferZone"));
+
+  profiler->setBufferSize(65536);
+}
+
+TEST(gmCoreProfiler, MultipleProfilers) {
+
+  auto first = std::make_shared<gmCore::Profiler>();
+  auto second = std::make_shared<gmCore::Profiler>();
+  first->initialize();
+  second->initialize();
+
+  first.reset();
+  EXPECT_TRUE(gmCore::Profiler::isActive());
+
+  // Zones of exited threads are kept after their buffers are freed
+  for (int idx = 0; idx < 4; ++idx) {
+    std::thread thread([] { profiledFunction(); });
+    thread.join();
+  }
+
+  std::stringstream ss;
+  second->writeTrace(ss);
+  EXPECT_LE(4, countZones(ss.str(), "profiledFunction"));
+
+  second.reset();
+  EXPECT_FALSE(gmCore::Profiler::isActive());
+}
@@ -0,0 +1,117 @@
+#include <gmCore/Updateable.hh>
+#include <gmCore/JobSystem.hh>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+struct RecordingUpdateable : gmCore::Updateable {
+
+  RecordingUpdateable(int priority, int id, std::vector<int> &log, std::mutex &lock)
+    : gmCore::Updateable(priority), id(id), log(log), lock(lock) {}
+
+  void update(clock::time_point, size_t) override {
+    if (meet) {
+      // Wait for the partner, to verify that both run concurrently
+      ++*meet;
+      auto start = clock::now();
+      while (*meet < 2 && clock::now() - start < std::chrono::seconds(2))
+        std::this_thread::yield();
+      met = *meet >= 2;
+    }
+    if (sleep.count() > 0) std::this_thread::sleep_for(sleep);
+    for (auto other : destroy) other->reset();
+    std::lock_guard<std::mutex> guard(lock);
+    log.push_back(id);
+  }
+
+  int id;
+  std::vector<int> &log;
+  std::mutex &lock;
+
+  std::atomic<int> *meet = nullptr;
+  bool met = false;
+  std::chrono::milliseconds sleep = std::chrono::milliseconds(0);
+  std::vector<std::unique_ptr<RecordingUpdateable>*> destroy;
+};
+}
+
+TEST(gmCoreUpdateable, TiersAndDependencies) {
+
+  std::vector<int> log;
+  std::mutex lock;
+
+  RecordingUpdateable a(0, 1, log, lock);
+  RecordingUpdateable b(10, 2, log, lock);
+  RecordingUpdateable c(0, 3, log, lock);
+  RecordingUpdateable d(0, 4, log, lock);
+
+  // Instantiation order within tier unless dependencies say otherwise
+  a.runsAfter(&d);
+
+  gmCore::Updateable::updateAll();
+  EXPECT_EQ((std::vector<int>{ 2, 3, 4, 1 }), log);
+
+  // Cycles fall back to instantiation order
+  d.runsAfter(&a);
+  log.clear();
+  gmCore::Updateable::updateAll();
+  EXPECT_EQ((std::vector<int>{ 2, 3, 1, 4 }), log);
+}
+
+TEST(gmCoreUpdateable, ParallelTiers) {
+
+  auto job_system = std::make_shared<gmCore::JobSystem>();
+  job_system->setWorkerCount(2);
+  job_system->initialize();
+  gmCore::Updateable::setJobSystem(job_system);
+
+  std::vector<int> log;
+  std::mutex lock;
+  std::atomic<int> meet = 0;
+
+  RecordingUpdateable a(5, 1, log, lock);
+  RecordingUpdateable b(5, 2, log, lock);
+  RecordingUpdateable c(0, 3, log, lock);
+  a.meet = &meet;
+  b.meet = &meet;
+  c.sleep = std::chrono::milliseconds(10);
+
+  gmCore::Updateable::updateAll();
+
+  EXPECT_TRUE(a.met);
+  EXPECT_TRUE(b.met);
+  ASSERT_EQ(3, log.size());
+  EXPECT_EQ(3, log[2]);
+
+  EXPECT_LE(std::chrono::milliseconds(10), c.getUpdateDuration());
+  EXPECT_LE(c.getUpdateDuration(), gmCore::Updateable::getUpdateAllDuration());
+
+  gmCore::Updateable::setJobSystem(nullptr);
+}
+
+TEST(gmCoreUpdateable, DestroyedDuringUpdate) {
+
+  std::vector<int> log;
+  std::mutex lock;
+
+  RecordingUpdateable a(10, 1, log, lock);
+  // Same wave and a later tier than the updateable destroying them
+  auto b = std::make_unique<RecordingUpdateable>(10, 2, log, lock);
+  auto c = std::make_unique<RecordingUpdateable>(0, 3, log, lock);
+  a.destroy = { &b, &c };
+
+  gmCore::Updateable::updateAll();
+  EXPECT_EQ((std::vector<int>{ 1 }), log);
+
+  a.destroy.clear();
+  log.clear();
+  gmCore::Updateable::updateAll();
+  EXPECT_EQ((std::vector<int>{ 1 }), log);
+}
@@ -2,6 +2,7 @@
 #include <gmCore/MathConstants.hh>
 #include <gmGraphics/AABB.hh>
 #include <gmGraphics/PoseTransform.hh>
+#include <gmGraphics/Group.hh>
 #include <gmGraphics/IntersectionVisitor.hh>
 
 using namespace gramods;
@@ -272,3 +273,57 @@ TEST(gmGraphics, IntersectionVisitor_PoseTransform_AABB) {
              Eigen::Vector3f(6.f, 7.f, 4.f));
 
 }
+
+TEST(gmGraphics, IntersectionVisitor_Flat) {
+
+  auto N0 = std::make_shared<AabbNode>();
+  N0->aabb += Eigen::Vector3f(6.f, 6.f, 6.f);
+  N0->initialize();
+
+  auto T0 = std::make_shared<gmGraphics::PoseTransform>();
+  T0->setPosition({0.f, 2.f, 0.f});
+  T0->addNode(N0);
+  T0->initialize();
+
+  auto T1 = std::make_shared<gmGraphics::PoseTransform>();
+  T1->setPosition({0.f, 0.f, 10.f});
+  T1->initialize();
+
+  auto G0 = std::make_shared<gmGraphics::Group>();
+  G0->addNode(T0);
+  G0->addNode(T1);
+  G0->initialize();
+
+  auto check = [&](Line line) -> size_t {
+    gmGraphics::IntersectionVisitor classic(line);
+    G0->accept(&classic);
+    gmGraphics::IntersectionVisitor flat(line);
+    G0->acceptFlat(&flat);
+
+    EXPECT_EQ(classic.intersections.size(), flat.intersections.size());
+    for (size_t idx = 0;
+         idx < std::min(classic.intersections.size(), flat.intersections.size());
+         ++idx) {
+      auto &a = classic.intersections[idx];
+      auto &b = flat.intersections[idx];
+      EXPECT_LE((a.local_position - b.local_position).norm(), 1e-6f);
+      EXPECT_LE((a.position - b.position).norm(), 1e-6f);
+      EXPECT_TRUE(std::equal(a.node_path.begin(), a.node_path.end(),
+                             b.node_path.begin(), b.node_path.end()));
+    }
+    return flat.intersections.size();
+  };
+
+  EXPECT_EQ(check(Line::lineSegment({0.f, 7.f, 4.f}, {8.f, 7.f, 4.f})), 2);
+  EXPECT_EQ(check(Line::lineSegment({0.f, 7.f, 14.f}, {8.f, 7.f, 14.f})), 0);
+
+  // Transforms are read during traversal
+  T0->setPosition({0.f, 0.f, 0.f});
+  EXPECT_EQ(check(Line::lineSegment({0.f, 5.f, 4.f}, {8.f, 5.f, 4.f})), 2);
+
+  // Structural changes invalidate the flattened graph
+  T1->addNode(N0);
+  EXPECT_EQ(check(Line::lineSegment({0.f, 5.f, 14.f}, {8.f, 5.f, 14.f})), 2);
+  T0->removeNode(N0);
+  EXPECT_EQ(check(Line::lineSegment({0.f, 5.f, 4.f}, {8.f, 5.f, 4.f})), 0);
+}
@@ -108,4 +108,34 @@ TEST(gmMiscPolyFit, Jacobian) {
   EXPECT_LE(max_err, 1e-10);
 }
 
+TEST(gmMiscPolyFit, Batch) {
+
+  gmMisc::PolyFit poly(2, 3, 2);
+
+  for (double idx_b = 0; idx_b < 3.f; idx_b += 0.1f)
+    for (double idx_a = 0; idx_a < 3.f; idx_a += 0.1f)
+      poly.addSample({idx_a, idx_b},
+                     {X(idx_a, idx_b), Y(idx_a, idx_b), Z(idx_a, idx_b)});
+
+  std::vector<double> in_values;
+  for (double idx_b = 0; idx_b < 3.f; idx_b += 0.0667f)
+    for (double idx_a = 0; idx_a < 3.f; idx_a += 0.0667f) {
+      in_values.push_back(idx_a);
+      in_values.push_back(idx_b);
+    }
+
+  size_t count = in_values.size() / 2;
+  std::vector<double> out_values(3 * count);
+  poly.getValues(in_values.data(), out_values.data(), count);
+
+  double max_err = 0.0;
+  for (size_t idx = 0; idx < count; ++idx) {
+    auto res = poly.getValue({in_values[2 * idx], in_values[2 * idx + 1]});
+    for (size_t odim = 0; odim < 3; ++odim)
+      max_err = std::max(max_err, std::fabs(res[odim] - out_values[3 * idx + odim]));
+  }
+
+  EXPECT_LE(max_err, 1e-12);
+}
+
 #endif
@@ -0,0 +1,135 @@
+#include <gmTrack/ArucoMultiCameraPoseTracker.hh>
+
+#ifdef gramods_ENABLE_OpenCV_objdetect
+
+#include <gmTrack/ArucoGridBoard.hh>
+#include <gmTrack/ArucoPoseTracker.hh>
+#include <gmTrack/OpenCvVideoCapture.hh>
+
+#include <gmCore/JobSystem.hh>
+#include <gmCore/TimeTools.hh>
+#include <gmCore/Updateable.hh>
+
+#include <opencv2/videoio.hpp>
+
+#include <filesystem>
+#include <thread>
+
+using namespace gramods;
+
+namespace {
+
+  std::shared_ptr<gmTrack::ArucoGridBoard> makeBenchmarkBoard() {
+    auto board = std::make_shared<gmTrack::ArucoGridBoard>();
+    board->setDictionary("4X4_100");
+    board->setColumns(3);
+    board->setRows(5);
+    board->setMarkerSize(0.04f);
+    board->setMarkerSeparation(0.01f);
+    board->initialize();
+    return board;
+  }
+
+  /**
+     Writes a video of a board moving across the image, and camera
+     parameters matching it.
+  */
+  bool writeBenchmarkVideo(std::filesystem::path video_file,
+                           std::filesystem::path camera_file,
+                           size_t frames) {
+
+    const cv::Size size(1280, 720);
+
+    cv::Mat board_image;
+    makeBenchmarkBoard()->getBoard()->generateImage(
+        cv::Size(300, 500), board_image, 20, 1);
+    cv::cvtColor(board_image, board_image, cv::COLOR_GRAY2BGR);
+
+    cv::VideoWriter writer(video_file.string(),
+                           cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                           30, size);
+    if (!writer.isOpened()) return false;
+
+    for (size_t idx = 0; idx < frames; ++idx) {
+      cv::Mat frame(size, CV_8UC3, cv::Scalar(255, 255, 255));
+      board_image.copyTo(frame(cv::Rect(cv::Point(200 + 10 * int(idx), 100),
+                                        board_image.size())));
+      writer << frame;
+    }
+
+    cv::FileStorage fs(camera_file.string(), cv::FileStorage::WRITE);
+    fs << "image_width" << size.width;
+    fs << "image_height" << size.height;
+    fs << "camera_matrix"
+       << (cv::Mat_<double>(3, 3) << 1000, 0, 640, 0, 1000, 360, 0, 0, 1);
+    fs << "distortion_coefficients" << cv::Mat::zeros(1, 5, CV_64F);
+
+    return true;
+  }
+}
+
+TEST(gmTrackAruco, DISABLED_BenchmarkMultiCamera) {
+
+  const size_t N_FRAMES = 60;
+  const size_t N_CAMERAS = 4;
+
+  auto video_file = std::filesystem::temp_directory_path() / "gramods_test_aruco.avi";
+  auto camera_file = std::filesystem::temp_directory_path() / "gramods_test_aruco.yaml";
+  if (!writeBenchmarkVideo(video_file, camera_file, N_FRAMES))
+    GTEST_SKIP() << "Could not write test video";
+
+  const size_t max_workers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+  for (size_t workers : { size_t(1), max_workers }) {
+
+    auto job_system = std::make_shared<gmCore::JobSystem>();
+    job_system->setWorkerCount(workers);
+    job_system->initialize();
+    gmCore::Updateable::setJobSystem(job_system);
+
+    // Detect in the update, so that every frame of every camera is
+    // processed and the updates of the cameras run concurrently
+    auto tracker = std::make_shared<gmTrack::ArucoMultiCameraPoseTracker>();
+    for (size_t idx = 0; idx < N_CAMERAS; ++idx) {
+
+      auto capture = std::make_shared<gmTrack::OpenCvVideoCapture>();
+      capture->setVideoFile(video_file);
+      capture->initialize();
+
+      auto camera = std::make_shared<gmTrack::ArucoPoseTracker>();
+      camera->setKey("/board");
+      camera->setThreaded(false);
+      camera->setCameraConfigurationFile(camera_file);
+      camera->setVideoSource(capture);
+      camera->addArucoBoard(makeBenchmarkBoard());
+      camera->initialize();
+
+      tracker->addPoseTracker(camera);
+    }
+    tracker->initialize();
+
+    size_t found = 0;
+    auto t0 = gmCore::TimeTools::clock::now();
+    for (size_t idx = 0; idx < N_FRAMES; ++idx) {
+      gmCore::Updateable::updateAll();
+      auto state = tracker->get();
+      if (state && state->count("/board/0")) ++found;
+    }
+    auto t1 = gmCore::TimeTools::clock::now();
+
+    gmCore::Updateable::setJobSystem(nullptr);
+
+    EXPECT_GE(found, N_FRAMES / 2);
+
+    std::cout << "Tracking " << N_CAMERAS << " cameras with " << workers
+              << " workers: "
+              << double(N_FRAMES * N_CAMERAS) /
+                     gmCore::TimeTools::durationToSeconds(t1 - t0)
+              << " images/s" << std::endl;
+  }
+
+  std::filesystem::remove(video_file);
+  std::filesystem::remove(camera_file);
+}
+
+#endif
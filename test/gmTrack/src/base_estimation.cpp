@@ -277,3 +277,210 @@ TEST(gmTrackBaseEstimation, RandomTesting) {
     if (has_reg) EXPECT_LT((M_actual - M_raw).norm(), 1e-5);
   }
 }
+
+TEST(gmTrackBaseEstimation, RobustWithOutliers) {
+
+  gmCore::Console::removeAllSinks();
+  std::shared_ptr<gmCore::NullMessageSink> nullsink =
+    std::make_shared<gmCore::NullMessageSink>();
+  nullsink->initialize();
+
+  std::default_random_engine random_engine;
+  std::uniform_real_distribution<float> real_random =
+      std::uniform_real_distribution<float>(-1.f, 1.f);
+
+  Eigen::Affine3f M = Eigen::Affine3f::Identity();
+  M.translate(Eigen::Vector3f(1.f, 2.f, 1.5f))
+      .scale(0.5f)
+      .rotate(Eigen::AngleAxis<float>(1.f, Eigen::Vector3f(1, 2, 3).normalized()));
+  Eigen::Matrix4f M_actual = M.matrix();
+
+  const size_t position_count = 40;
+  const size_t outlier_count = 10;
+
+  gmTrack::TrackerRegistrationEstimator registrator;
+  registrator.setRobust(true);
+  registrator.setRansacThreshold(0.01f);
+
+  for (size_t idx = 0; idx < position_count; ++idx) {
+    Eigen::Vector3f pt(real_random(random_engine),
+                       real_random(random_engine),
+                       real_random(random_engine));
+    Eigen::Vector3f actual = (M_actual * pt.homogeneous()).hnormalized();
+    if (idx % (position_count / outlier_count) == 0)
+      actual += Eigen::Vector3f(0.5f, -0.3f, 0.2f);
+    registrator.addTrackerPosition(pt);
+    registrator.addActualPosition(actual);
+  }
+  registrator.performRegistration();
+
+  EXPECT_TRUE(registrator.waitForRegistration());
+
+  Eigen::Matrix4f M_raw;
+  ASSERT_TRUE(registrator.getRegistration(&M_raw, nullptr));
+  EXPECT_LT((M_actual - M_raw).norm(), 1e-4);
+
+  EXPECT_EQ(registrator.getInlierCount(), position_count - outlier_count);
+
+  auto residuals = registrator.getResiduals();
+  ASSERT_EQ(residuals.size(), position_count);
+  for (size_t idx = 0; idx < position_count; ++idx) {
+    if (idx % (position_count / outlier_count) == 0) {
+      EXPECT_GT(residuals[idx], 0.1f);
+    } else {
+      EXPECT_LT(residuals[idx], 1e-4f);
+    }
+  }
+}
+
+TEST(gmTrackBaseEstimation, RobustFromSamples) {
+
+  gmCore::Console::removeAllSinks();
+  std::shared_ptr<gmCore::NullMessageSink> nullsink =
+    std::make_shared<gmCore::NullMessageSink>();
+  nullsink->initialize();
+
+  Eigen::Affine3f M = Eigen::Affine3f::Identity();
+  M.translate(Eigen::Vector3f(-1.f, 0.5f, 2.f))
+      .scale(2.f)
+      .rotate(Eigen::AngleAxis<float>(0.7f, Eigen::Vector3f(3, 1, 2).normalized()));
+  Eigen::Matrix4f M_actual = M.matrix();
+
+  const auto MAIN_BUTTON = gmTrack::StdKey::MAIN_BUTTON;
+  const std::vector<Eigen::Vector3f> tracker_points = {
+    { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f },
+    { 0.f, 0.f, 1.f }, { 1.f, 1.f, 0.f }, { 0.5f, 0.2f, 0.9f } };
+  const size_t samples_per_point = 8;
+
+  auto ts_buttons_tracker = std::make_shared<gmTrack::BinaryTimeSampleTracker>();
+  auto ts_pose_tracker = std::make_shared<gmTrack::PoseTimeSampleTracker>();
+  Eigen::Quaternionf orientation = Eigen::Quaternionf::Identity();
+
+  gmTrack::TrackerRegistrationEstimator registrator;
+  registrator.setRobust(true);
+  registrator.setRansacThreshold(0.01f);
+
+  // The last sample of every other point is taken while moving
+  size_t outlier_count = 0;
+  ts_buttons_tracker->addKeyValue(MAIN_BUTTON, false);
+  ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                               {.position = tracker_points[0], .orientation = orientation});
+  for (size_t idx = 0; idx < tracker_points.size(); ++idx) {
+    registrator.addActualPosition((M_actual * tracker_points[idx].homogeneous()).hnormalized());
+    for (size_t jdx = 0; jdx < samples_per_point; ++jdx) {
+      Eigen::Vector3f p = tracker_points[idx];
+      if (idx % 2 == 0 && jdx == samples_per_point - 1) {
+        p += Eigen::Vector3f(0.f, 0.1f, 0.05f);
+        ++outlier_count;
+      }
+      ts_buttons_tracker->addKeyValue(MAIN_BUTTON, true);
+      ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                                   {.position = p, .orientation = orientation});
+    }
+    ts_buttons_tracker->addKeyValue(MAIN_BUTTON, false);
+    ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                                 {.position = tracker_points[idx], .orientation = orientation});
+  }
+
+  ts_buttons_tracker->initialize();
+  ts_pose_tracker->initialize();
+
+  auto tracker_set = std::make_shared<gmTrack::TrackerSet>();
+  tracker_set->setPoseTracker(ts_pose_tracker);
+  tracker_set->setBinaryTracker(ts_buttons_tracker);
+  tracker_set->initialize();
+
+  registrator.setTrackerSet(tracker_set);
+  registrator.setSamplesPerSecond(1e6f);
+  registrator.initialize();
+
+  for (size_t idx = 0; idx < tracker_points.size() * (samples_per_point + 1) + 2; ++idx)
+    gmCore::Updateable::updateAll();
+
+  ASSERT_TRUE(registrator.waitForRegistration());
+
+  Eigen::Matrix4f M_raw;
+  ASSERT_TRUE(registrator.getRegistration(&M_raw, nullptr));
+  EXPECT_LT((M_actual - M_raw).norm(), 1e-4);
+
+  // Residuals are given per individual sample
+  const size_t sample_count = tracker_points.size() * samples_per_point;
+  EXPECT_EQ(registrator.getResiduals().size(), sample_count);
+  EXPECT_EQ(registrator.getInlierCount(), sample_count - outlier_count);
+}
+
+TEST(gmTrackBaseEstimation, StreamingSampleStatistics) {
+
+  gmCore::Console::removeAllSinks();
+  std::shared_ptr<gmCore::NullMessageSink> nullsink =
+    std::make_shared<gmCore::NullMessageSink>();
+  nullsink->initialize();
+
+  const auto MAIN_BUTTON = gmTrack::StdKey::MAIN_BUTTON;
+  const size_t sample_count = 40;
+
+  Eigen::Vector3f position(1.f, 2.f, 3.f);
+  Eigen::Quaternionf orientation(Eigen::AngleAxisf(0.5f, Eigen::Vector3f::UnitY()));
+
+  // An outlier first, e.g. from pressing the button, must not bias
+  // the averages that later samples are checked against
+  for (size_t outlier_idx : { 0, 20 }) {
+
+    auto ts_buttons_tracker = std::make_shared<gmTrack::BinaryTimeSampleTracker>();
+    auto ts_pose_tracker = std::make_shared<gmTrack::PoseTimeSampleTracker>();
+
+    std::default_random_engine random_engine;
+    std::normal_distribution<float> noise(0.f, 0.001f);
+
+    ts_buttons_tracker->addKeyValue(MAIN_BUTTON, false);
+    ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                                 {.position = position, .orientation = orientation});
+    for (size_t idx = 0; idx < sample_count; ++idx) {
+      Eigen::Vector3f p = position + Eigen::Vector3f(noise(random_engine),
+                                                     noise(random_engine),
+                                                     noise(random_engine));
+      if (idx == outlier_idx) p += Eigen::Vector3f(0.2f, 0.f, 0.f);
+      ts_buttons_tracker->addKeyValue(MAIN_BUTTON, true);
+      ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                                   {.position = p, .orientation = orientation});
+    }
+    ts_buttons_tracker->addKeyValue(MAIN_BUTTON, false);
+    ts_pose_tracker->addKeyValue(gmTrack::StdKey::PRIMARY_WAND,
+                                 {.position = position, .orientation = orientation});
+
+    ts_buttons_tracker->initialize();
+    ts_pose_tracker->initialize();
+
+    auto tracker_set = std::make_shared<gmTrack::TrackerSet>();
+    tracker_set->setPoseTracker(ts_pose_tracker);
+    tracker_set->setBinaryTracker(ts_buttons_tracker);
+    tracker_set->initialize();
+
+    auto collector = std::make_shared<gmTrack::PoseSampleCollector>();
+    collector->setTrackerSet(tracker_set);
+    collector->setSamplesPerSecond(1e6f);
+    collector->setInlierThreshold(0.01f);
+    collector->initialize();
+
+    for (size_t idx = 0; idx < sample_count + 2; ++idx) {
+      gmCore::Updateable::updateAll();
+      if (idx > 0 && idx <= sample_count) {
+        EXPECT_TRUE(collector->isCollecting());
+        EXPECT_EQ(collector->getSampleCount() + collector->getRejectedSampleCount(), idx);
+      }
+    }
+
+    EXPECT_FALSE(collector->isCollecting());
+    EXPECT_EQ(collector->getSampleCount(), sample_count - 1) << outlier_idx;
+    EXPECT_EQ(collector->getRejectedSampleCount(), 1) << outlier_idx;
+    EXPECT_LT(collector->getPositionDeviation(), 0.005f) << outlier_idx;
+    EXPECT_LT(collector->getOrientationDeviation(), 1e-3f) << outlier_idx;
+
+    auto &positions = collector->getTrackerPositions();
+    auto &orientations = collector->getTrackerOrientations();
+    ASSERT_EQ(positions.size(), 1);
+    ASSERT_EQ(orientations.size(), 1);
+    EXPECT_LT((positions[0] - position).norm(), 0.001f) << outlier_idx;
+    EXPECT_LT(orientations[0].angularDistance(orientation), 1e-4f) << outlier_idx;
+  }
+}
@@ -0,0 +1,202 @@
+#include <gmTrack/FilteredPoseTracker.hh>
+
+#include "scripted_tracker.hh"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+
+  /**
+     Feeds poses at 240 Hz through a filter, with positional and
+     angular noise of the specified standard deviations, and returns
+     the root mean square errors of the raw and filtered positions
+     and orientations over the last half of the samples.
+  */
+  template<class POSE_AT>
+  std::array<double, 4> filterSamples(gmTrack::FilteredPoseTracker &filter,
+                                      ScriptedPoseTracker &source,
+                                      POSE_AT poseAt, size_t count,
+                                      float position_noise, float angle_noise) {
+
+    typedef gmTrack::PoseTracker::clock clock;
+    auto t0 = clock::now();
+
+    std::mt19937 random(1);
+    std::normal_distribution<float> normal;
+
+    std::array<double, 4> error = {};
+    for (size_t idx = 0; idx < count; ++idx) {
+      double t = idx / 240.0;
+      gmCore::Pose truth = poseAt(t);
+
+      gmCore::Pose noisy = truth;
+      noisy.position += position_noise *
+          Eigen::Vector3f(normal(random), normal(random), normal(random));
+      Eigen::Vector3f axis(normal(random), normal(random), normal(random));
+      noisy.orientation = Eigen::AngleAxisf(angle_noise * axis.norm(), axis.normalized()) *
+                          noisy.orientation;
+
+      source.state = gmTrack::PoseTracker::State{
+          { "head",
+            { t0 + std::chrono::duration_cast<clock::duration>(
+                       std::chrono::duration<double>(t)),
+              noisy } } };
+
+      auto state = filter.get();
+      EXPECT_TRUE(state);
+      if (!state) break;
+
+      if (idx < count / 2) continue;
+      const gmCore::Pose &pose = state->at("head").value;
+      error[0] += (noisy.position - truth.position).squaredNorm();
+      error[1] += (pose.position - truth.position).squaredNorm();
+      error[2] += std::pow(noisy.orientation.angularDistance(truth.orientation), 2);
+      error[3] += std::pow(pose.orientation.angularDistance(truth.orientation), 2);
+    }
+
+    for (auto &e : error) e = std::sqrt(e / double(count - count / 2));
+    return error;
+  }
+}
+
+TEST(gmTrackFilteredPoseTracker, ReducesJitter) {
+
+  auto still = [](double) {
+    return gmCore::Pose(Eigen::Vector3f(0.f, 1.7f, 0.f),
+                        Eigen::Quaternionf(Eigen::AngleAxisf(0.5f, Eigen::Vector3f::UnitY())));
+  };
+
+  for (std::string name : { "oneEuro", "kalman" }) {
+
+    auto source = std::make_shared<ScriptedPoseTracker>();
+    gmTrack::FilteredPoseTracker filter;
+    filter.setPoseTracker(source);
+    filter.setFilter(name);
+
+    auto error = filterSamples(filter, *source, still, 480, 0.001f, 0.005f);
+    EXPECT_LT(error[1], 0.5 * error[0]) << name;
+    EXPECT_LT(error[3], 0.5 * error[2]) << name;
+
+    EXPECT_GT(filter.getLatency(), 0.0) << name;
+    EXPECT_LT(filter.getLatency(), 1.0) << name;
+  }
+}
+
+TEST(gmTrackFilteredPoseTracker, FollowsMotion) {
+
+  // Moving 1 m/s along x and turning 1 rad/s about y
+  auto moving = [](double t) {
+    return gmCore::Pose(Eigen::Vector3f(float(t), 1.7f, 0.f),
+                        Eigen::Quaternionf(Eigen::AngleAxisf(float(t), Eigen::Vector3f::UnitY())));
+  };
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+
+  gmTrack::FilteredPoseTracker one_euro;
+  one_euro.setPoseTracker(source);
+  one_euro.setBeta(10);
+
+  // The lag behind steady motion is the reported latency
+  auto error = filterSamples(one_euro, *source, moving, 480, 0.f, 0.f);
+  EXPECT_NEAR(error[1], one_euro.getLatency(), 0.1 * one_euro.getLatency());
+  EXPECT_LT(error[1], 0.02);
+
+  gmTrack::FilteredPoseTracker kalman;
+  kalman.setPoseTracker(source);
+  kalman.setFilter("kalman");
+
+  // Steady motion is followed without lag
+  error = filterSamples(kalman, *source, moving, 480, 0.f, 0.f);
+  EXPECT_LT(error[1], 1e-4);
+  EXPECT_LT(error[3], 1e-4);
+}
+
+TEST(gmTrackFilteredPoseTracker, UnchangedSamples) {
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  auto t0 = gmTrack::PoseTracker::clock::now();
+
+  gmTrack::FilteredPoseTracker filter;
+  filter.setPoseTracker(source);
+  filter.setFilter("kalman");
+
+  gmTrack::PoseTracker::FlatState flat_state;
+  for (size_t idx = 0; idx < 10; ++idx) {
+    source->state = gmTrack::PoseTracker::State{
+        { "a", { t0 + std::chrono::milliseconds(idx), gmCore::Pose() } },
+        { "b", { t0, gmCore::Pose(Eigen::Vector3f(float(idx), 0.f, 0.f),
+                                  Eigen::Quaternionf::Identity()) } } };
+    ASSERT_TRUE(filter.getFlat(flat_state));
+  }
+
+  ASSERT_EQ(flat_state.size(), 2);
+
+  // Key b has kept its first sample, since its time did not change
+  for (const auto &ks : flat_state) {
+    if (ks.key == gmTrack::TrackerKey::getId("b")) {
+      EXPECT_EQ(ks.sample.value.position.x(), 0.f);
+    }
+  }
+
+  auto state = filter.get();
+  ASSERT_TRUE(state);
+  EXPECT_TRUE(state->contains("a"));
+  EXPECT_EQ(state->at("b").value.position.x(), 0.f);
+
+  // Keys that are no longer reported do not add to the latency
+  EXPECT_GT(filter.getLatency(), 0.0);
+  source->state = gmTrack::PoseTracker::State{ { "c", { t0, gmCore::Pose() } } };
+  ASSERT_TRUE(filter.getFlat(flat_state));
+  EXPECT_EQ(filter.getLatency(), 0.0);
+
+  EXPECT_THROW(filter.setFilter("median"), gmCore::InvalidArgument);
+}
+
+TEST(gmTrackFilteredPoseTracker, ConcurrentReads) {
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  auto t0 = gmTrack::PoseTracker::clock::now();
+
+  // Unchanged samples, so every read returns the source poses
+  gmTrack::PoseTracker::State expected;
+  for (size_t idx = 0; idx < 64; ++idx)
+    expected.emplace("filtered" + std::to_string(idx),
+                     gmTrack::PoseTracker::Sample{
+                       t0, gmCore::Pose(Eigen::Vector3f(float(idx), 0.f, 0.f),
+                                        Eigen::Quaternionf::Identity()) });
+  source->state = expected;
+
+  auto filter = std::make_shared<gmTrack::FilteredPoseTracker>();
+  filter->setPoseTracker(source);
+
+  std::atomic<size_t> mismatch_count = 0;
+  auto read = [&] {
+    gmTrack::PoseTracker::FlatState flat_state;
+    for (size_t idx = 0; idx < 200; ++idx) {
+
+      auto state = filter->get();
+      if (!state || state->size() != expected.size()) {
+        ++mismatch_count;
+      } else {
+        for (const auto &[key, sample] : *state)
+          if (sample.value.position != expected.at(key).value.position)
+            ++mismatch_count;
+      }
+
+      if (!filter->getFlat(flat_state) || flat_state.size() != expected.size())
+        ++mismatch_count;
+      filter->getLatency();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx < 4; ++idx) threads.emplace_back(read);
+  for (auto &thread : threads) thread.join();
+
+  EXPECT_EQ(mismatch_count, 0);
+}
@@ -0,0 +1,151 @@
+#include <gmTrack/FusedPoseTracker.hh>
+
+#include "scripted_tracker.hh"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+namespace {
+
+  gmTrack::PoseTracker::State makeState(gmTrack::PoseTracker::clock::time_point time,
+                                        Eigen::Vector3f position,
+                                        float angle) {
+    return gmTrack::PoseTracker::State{
+        { "head",
+          { time,
+            gmCore::Pose(position, Eigen::Quaternionf(
+                                       Eigen::AngleAxisf(angle, Eigen::Vector3f::UnitY()))) } } };
+  }
+}
+
+TEST(gmTrackFusedPoseTracker, WeightsByConfidence) {
+
+  auto t0 = gmTrack::PoseTracker::clock::now();
+
+  auto optical = std::make_shared<ScriptedPoseTracker>();
+  auto inertial = std::make_shared<ScriptedPoseTracker>();
+
+  gmTrack::FusedPoseTracker fused;
+  fused.addPoseTracker(optical);
+  fused.addPoseTracker(inertial);
+  fused.addConfidence(3.f);
+
+  optical->state = makeState(t0, Eigen::Vector3f(0.f, 0.f, 0.f), 0.1f);
+  inertial->state = makeState(t0, Eigen::Vector3f(4.f, 0.f, 0.f), 0.5f);
+
+  auto state = fused.get();
+  ASSERT_TRUE(state);
+  const auto &sample = state->at("head");
+  EXPECT_EQ(sample.time, t0);
+  EXPECT_NEAR(sample.value.position.x(), 1.f, 1e-5f);
+
+  Eigen::AngleAxisf aa(sample.value.orientation);
+  EXPECT_NEAR(aa.angle(), 0.2f, 1e-3f);
+
+  // Equal orientations of opposite sign are the same rotation
+  auto t1 = t0 + std::chrono::milliseconds(1);
+  optical->state = makeState(t1, Eigen::Vector3f::Zero(), 0.3f);
+  inertial->state = makeState(t1, Eigen::Vector3f::Zero(), 0.3f);
+  inertial->state->at("head").value.orientation.coeffs() *= -1;
+
+  state = fused.get();
+  ASSERT_TRUE(state);
+  EXPECT_NEAR(state->at("head").value.orientation.angularDistance(
+                  Eigen::Quaternionf(Eigen::AngleAxisf(0.3f, Eigen::Vector3f::UnitY()))),
+              0.f, 1e-3f);
+}
+
+TEST(gmTrackFusedPoseTracker, AlignsAndDropsStaleSamples) {
+
+  typedef gmTrack::PoseTracker::clock clock;
+  auto t0 = clock::now();
+  auto at = [t0](double t) {
+    return t0 + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(t));
+  };
+
+  auto fast = std::make_shared<ScriptedPoseTracker>();
+  auto slow = std::make_shared<ScriptedPoseTracker>();
+
+  gmTrack::FusedPoseTracker fused;
+  fused.addPoseTracker(fast);
+  fused.addPoseTracker(slow);
+  fused.setMaxAge(0.05);
+
+  // Both sources track motion at 1 m/s, the slow source at a quarter
+  // of the rate, so that its samples are extrapolated to the time of
+  // the latest sample of the fast source
+  std::optional<gmTrack::PoseTracker::State> state;
+  for (int idx = 0; idx < 120; ++idx) {
+    double t = idx / 240.0;
+    double t_slow = (idx / 4) / 60.0;
+    fast->state = makeState(at(t), Eigen::Vector3f(float(t), 0.f, 0.f), 0.f);
+    slow->state = makeState(at(t_slow), Eigen::Vector3f(float(t_slow), 0.f, 0.f), 0.f);
+    state = fused.get();
+    ASSERT_TRUE(state);
+    if (idx < 80) continue; // Let the velocity estimates settle
+    EXPECT_NEAR(state->at("head").value.position.x(), float(t), 1e-4f) << idx;
+  }
+
+  // A source that stops reporting loses its influence
+  slow->state = makeState(at(0.0), Eigen::Vector3f(100.f, 0.f, 0.f), 0.f);
+  fast->state = makeState(at(1.0), Eigen::Vector3f(1.f, 0.f, 0.f), 0.f);
+  state = fused.get();
+  ASSERT_TRUE(state);
+  EXPECT_NEAR(state->at("head").value.position.x(), 1.f, 1e-5f);
+
+  gmTrack::PoseTracker::FlatState flat_state;
+  ASSERT_TRUE(fused.getFlat(flat_state));
+  ASSERT_EQ(flat_state.size(), 1);
+  EXPECT_EQ(flat_state[0].key, gmTrack::TrackerKey::getId("head"));
+  EXPECT_EQ(flat_state[0].sample.value.position, state->at("head").value.position);
+}
+
+TEST(gmTrackFusedPoseTracker, ConcurrentReads) {
+
+  auto t0 = gmTrack::PoseTracker::clock::now();
+
+  // Both sources report the same unchanged poses
+  gmTrack::PoseTracker::State expected;
+  for (size_t idx = 0; idx < 64; ++idx)
+    expected.emplace("fused" + std::to_string(idx),
+                     gmTrack::PoseTracker::Sample{
+                       t0, gmCore::Pose(Eigen::Vector3f(float(idx), 0.f, 0.f),
+                                        Eigen::Quaternionf::Identity()) });
+
+  auto first = std::make_shared<ScriptedPoseTracker>();
+  auto second = std::make_shared<ScriptedPoseTracker>();
+  first->state = expected;
+  second->state = expected;
+
+  auto fused = std::make_shared<gmTrack::FusedPoseTracker>();
+  fused->addPoseTracker(first);
+  fused->addPoseTracker(second);
+
+  std::atomic<size_t> mismatch_count = 0;
+  auto read = [&] {
+    gmTrack::PoseTracker::FlatState flat_state;
+    for (size_t idx = 0; idx < 200; ++idx) {
+
+      auto state = fused->get();
+      if (!state || state->size() != expected.size()) {
+        ++mismatch_count;
+      } else {
+        for (const auto &[key, sample] : *state)
+          if (!sample.value.position.isApprox(expected.at(key).value.position))
+            ++mismatch_count;
+      }
+
+      if (!fused->getFlat(flat_state) || flat_state.size() != expected.size())
+        ++mismatch_count;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx < 4; ++idx) threads.emplace_back(read);
+  for (auto &thread : threads) thread.join();
+
+  EXPECT_EQ(mismatch_count, 0);
+}
@@ -5,7 +5,14 @@
 #include "vrpn.cpp"
 #include "registered_tracker.cpp"
 #include "base_estimation.cpp"
+#include "time_sample_tracker.cpp"
+#include "pose_history_tracker.cpp"
+#include "predictive_pose_tracker.cpp"
+#include "filtered_pose_tracker.cpp"
+#include "fused_pose_tracker.cpp"
+#include "tracker_chain.cpp"
 #include "projection_texture.cpp"
+#include "aruco.cpp"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,118 @@
+#include <gmTrack/PoseHistoryTracker.hh>
+
+#include <gmCore/PreConditionViolation.hh>
+#include <gmCore/Updateable.hh>
+
+#include "scripted_tracker.hh"
+
+#include <atomic>
+#include <thread>
+
+using namespace gramods;
+
+TEST(gmTrackPoseHistoryTracker, Interpolation) {
+
+  typedef gmTrack::PoseTracker::clock clock;
+  auto t0 = clock::now();
+  auto at = [t0](double s) {
+    return t0 + std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(s));
+  };
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  auto history = std::make_shared<gmTrack::PoseHistoryTracker>();
+  history->setPoseTracker(source);
+  history->setCapacity(4);
+  history->setMaxExtrapolation(0.5);
+
+  gmCore::Pose pose;
+  EXPECT_FALSE(history->getAt("a", t0, pose));
+
+  // Samples at 0, 1, ..., 5 s moving 1 m/s along x and turning about z
+  for (int idx = 0; idx < 6; ++idx) {
+    source->state = gmTrack::PoseTracker::State{
+        { "a",
+          { at(idx),
+            gmCore::Pose(Eigen::Vector3f(float(idx), 0, 0),
+                         Eigen::Quaternionf(Eigen::AngleAxisf(
+                             0.1f * idx, Eigen::Vector3f::UnitZ()))) } } };
+    gmCore::Updateable::updateAll(at(idx));
+    // Repeated states are not added
+    gmCore::Updateable::updateAll(at(idx + 0.5));
+  }
+
+  EXPECT_THROW(history->setCapacity(8), gmCore::PreConditionViolation);
+
+  ASSERT_TRUE(history->getAt("a", at(3.25), pose));
+  EXPECT_NEAR(3.25f, pose.position.x(), 1e-4f);
+  EXPECT_NEAR(0.325f, Eigen::AngleAxisf(pose.orientation).angle(), 1e-4f);
+
+  // Older samples have been overwritten
+  EXPECT_TRUE(history->getAt("a", at(2.0), pose));
+  EXPECT_FALSE(history->getAt("a", at(1.5), pose));
+  EXPECT_FALSE(history->getAt("b", at(3.0), pose));
+
+  // Extrapolation is bounded
+  ASSERT_TRUE(history->getAt("a", at(5.25), pose));
+  EXPECT_NEAR(5.25f, pose.position.x(), 1e-4f);
+  ASSERT_TRUE(history->getAt("a", at(10.0), pose));
+  EXPECT_NEAR(5.5f, pose.position.x(), 1e-4f);
+
+  auto state = history->getAt(at(4.5));
+  ASSERT_TRUE(state);
+  EXPECT_NEAR(4.5f, state->at("a").value.position.x(), 1e-4f);
+
+  state = history->get();
+  ASSERT_TRUE(state);
+  EXPECT_EQ(at(5), state->at("a").time);
+}
+
+TEST(gmTrackPoseHistoryTracker, ConcurrentReaders) {
+
+  typedef gmTrack::PoseTracker::clock clock;
+  auto t0 = clock::now();
+  auto at = [t0](int ms) { return t0 + std::chrono::milliseconds(ms); };
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  auto history = std::make_shared<gmTrack::PoseHistoryTracker>();
+  history->setPoseTracker(source);
+  history->setCapacity(16);
+
+  std::atomic<bool> done = false;
+  std::atomic<size_t> reads = 0, errors = 0;
+
+  std::vector<std::thread> readers;
+  for (int idx = 0; idx < 2; ++idx)
+    readers.emplace_back([&] {
+      gmCore::Pose pose;
+      while (!done) {
+        auto state = history->get();
+        if (!state || state->empty()) {
+          std::this_thread::yield();
+          continue;
+        }
+        // Position x is the sample time in ms, so interpolation is exact
+        auto time = state->at("a").time - std::chrono::milliseconds(3);
+        if (history->getAt("a", time, pose)) {
+          double ms = std::chrono::duration<double, std::milli>(time - t0).count();
+          if (std::abs(pose.position.x() - ms) > 1e-2) ++errors;
+          ++reads;
+        }
+        std::this_thread::yield();
+      }
+    });
+
+  for (int ms = 0; ms < 2000; ++ms) {
+    source->state = gmTrack::PoseTracker::State{
+        { "a", { at(ms), gmCore::Pose(Eigen::Vector3f(float(ms), 0, 0),
+                                      Eigen::Quaternionf::Identity()) } } };
+    gmCore::Updateable::updateAll(at(ms));
+    if (ms % 16 == 0) std::this_thread::yield();
+  }
+
+  done = true;
+  for (auto &reader : readers) reader.join();
+
+  EXPECT_EQ(0, errors);
+  EXPECT_LT(0, reads);
+}
@@ -0,0 +1,116 @@
+#include <gmTrack/PredictivePoseTracker.hh>
+
+#include "scripted_tracker.hh"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace gramods;
+
+TEST(gmTrackPredictivePoseTracker, ConstantMotion) {
+
+  typedef gmTrack::PoseTracker::clock clock;
+  auto t0 = clock::now();
+
+  // Moving 1 m/s along x and turning 1 rad/s about y
+  auto poseAt = [](double t) {
+    return gmCore::Pose(Eigen::Vector3f(float(t), 1.f, 0.f),
+                        Eigen::Quaternionf(Eigen::AngleAxisf(float(t), Eigen::Vector3f::UnitY())));
+  };
+
+  for (size_t order : { 1, 2 }) {
+
+    auto source = std::make_shared<ScriptedPoseTracker>();
+    auto predictor = std::make_shared<gmTrack::PredictivePoseTracker>();
+    predictor->setPoseTracker(source);
+    predictor->setLatency(0.04);
+    predictor->setOrder(order);
+
+    std::optional<gmTrack::PoseTracker::State> state;
+    for (int idx = 0; idx <= 20; ++idx) {
+      double t = idx / 100.0;
+      source->state = gmTrack::PoseTracker::State{
+          { "head",
+            { t0 + std::chrono::duration_cast<clock::duration>(
+                       std::chrono::duration<double>(t)),
+              poseAt(t) } } };
+      state = predictor->get();
+    }
+
+    ASSERT_TRUE(state);
+    gmCore::Pose expected = poseAt(0.24);
+    gmCore::Pose pose = state->at("head").value;
+    EXPECT_NEAR(0, (pose.position - expected.position).norm(), 1e-4f) << order;
+    EXPECT_NEAR(0, pose.orientation.angularDistance(expected.orientation), 1e-4f) << order;
+  }
+}
+
+TEST(gmTrackPredictivePoseTracker, ConstantAcceleration) {
+
+  typedef gmTrack::PoseTracker::clock clock;
+  auto t0 = clock::now();
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  auto predictor = std::make_shared<gmTrack::PredictivePoseTracker>();
+  predictor->setPoseTracker(source);
+  predictor->setLatency(0.05);
+  predictor->setOrder(2);
+
+  auto positionAt = [](double t) {
+    return Eigen::Vector3f(0.f, float(5 * t * t), 0.f);
+  };
+
+  std::optional<gmTrack::PoseTracker::State> state;
+  for (int idx = 0; idx <= 10; ++idx) {
+    double t = idx / 100.0;
+    source->state = gmTrack::PoseTracker::State{
+        { "hand",
+          { t0 + std::chrono::duration_cast<clock::duration>(
+                     std::chrono::duration<double>(t)),
+            gmCore::Pose(positionAt(t), Eigen::Quaternionf::Identity()) } } };
+    state = predictor->get();
+  }
+
+  ASSERT_TRUE(state);
+  EXPECT_NEAR(positionAt(0.15).y(), state->at("hand").value.position.y(), 1e-4f);
+}
+
+TEST(gmTrackPredictivePoseTracker, ConcurrentReads) {
+
+  auto t0 = gmTrack::PoseTracker::clock::now();
+
+  // Unchanged samples, so every read returns the source poses
+  gmTrack::PoseTracker::State expected;
+  for (size_t idx = 0; idx < 64; ++idx)
+    expected.emplace("predicted" + std::to_string(idx),
+                     gmTrack::PoseTracker::Sample{
+                       t0, gmCore::Pose(Eigen::Vector3f(float(idx), 0.f, 0.f),
+                                        Eigen::Quaternionf::Identity()) });
+
+  auto source = std::make_shared<ScriptedPoseTracker>();
+  source->state = expected;
+
+  auto predictor = std::make_shared<gmTrack::PredictivePoseTracker>();
+  predictor->setPoseTracker(source);
+
+  std::atomic<size_t> mismatch_count = 0;
+  auto read = [&] {
+    for (size_t idx = 0; idx < 200; ++idx) {
+      auto state = predictor->get();
+      if (!state || state->size() != expected.size()) {
+        ++mismatch_count;
+      } else {
+        for (const auto &[key, sample] : *state)
+          if (!sample.value.position.isApprox(expected.at(key).value.position))
+            ++mismatch_count;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t idx = 0; idx < 4; ++idx) threads.emplace_back(read);
+  for (auto &thread : threads) thread.join();
+
+  EXPECT_EQ(mismatch_count, 0);
+}
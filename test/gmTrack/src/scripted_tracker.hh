@@ -0,0 +1,20 @@
+#ifndef GRAMODS_TEST_TRACK_SCRIPTEDTRACKER
+#define GRAMODS_TEST_TRACK_SCRIPTEDTRACKER
+
+#include <gmTrack/TrackerBase.hh>
+
+/**
+   Tracker that reports the state that the test has set, or no state
+   if none has been set.
+*/
+template<class TYPE>
+struct ScriptedTracker : gramods::gmTrack::TrackerBase<TYPE> {
+  typedef typename gramods::gmTrack::TrackerBase<TYPE>::State State;
+  std::optional<State> state;
+  std::optional<State> get() override { return state; }
+};
+
+typedef ScriptedTracker<gramods::gmCore::Pose> ScriptedPoseTracker;
+typedef ScriptedTracker<float> ScriptedFloatTracker;
+
+#endif
@@ -0,0 +1,276 @@
+#include <gmTrack/FloatTimeSampleTracker.hh>
+#include <gmTrack/FloatRecordedTracker.hh>
+#include <gmTrack/PoseTimeSampleTracker.hh>
+#include <gmTrack/TimeSampleFile.hh>
+#include <gmTrack/TrackerRecorder.hh>
+
+#include "scripted_tracker.hh"
+
+#include <gmCore/Updateable.hh>
+#include <gmCore/TimeTools.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+
+using namespace gramods;
+
+namespace {
+  typedef gmCore::Updateable::clock clock;
+
+  clock::time_point atSeconds(clock::time_point t0, double seconds) {
+    return t0 + std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(seconds));
+  }
+}
+
+TEST(gmTrackTimeSampleTracker, Columns) {
+
+  auto tracker = std::make_shared<gmTrack::FloatTimeSampleTracker>();
+
+  // keyA, sample1, time1, sample2, time2, ...
+  tracker->addKey("a");
+  for (int idx = 0; idx < 4; ++idx) {
+    tracker->addValue(float(10 * idx));
+    tracker->addTime(double(idx));
+  }
+
+  auto t0 = clock::now();
+  gmCore::Updateable::updateAll(t0);
+
+  auto state = tracker->get();
+  ASSERT_TRUE(state);
+  EXPECT_FLOAT_EQ(0.f, state->at("a").value);
+
+  gmCore::Updateable::updateAll(atSeconds(t0, 2.5));
+  EXPECT_FLOAT_EQ(25.f, tracker->get()->at("a").value);
+  EXPECT_EQ(atSeconds(t0, 2.5), tracker->get()->at("a").time);
+
+  // Playback restarts after the last sample
+  gmCore::Updateable::updateAll(atSeconds(t0, 3.5));
+  EXPECT_FLOAT_EQ(5.f, tracker->get()->at("a").value);
+
+  gmCore::Updateable::updateAll(atSeconds(t0, 1.25));
+  EXPECT_FLOAT_EQ(12.5f, tracker->get()->at("a").value);
+}
+
+TEST(gmTrackTimeSampleTracker, SparseKeys) {
+
+  auto tracker = std::make_shared<gmTrack::FloatTimeSampleTracker>();
+
+  // keyA, sample1, keyB, sample1, time1, ...
+  tracker->addKeyValue("a", 0.f);
+  tracker->addKeyValue("b", 0.f);
+  tracker->addTime(0.0);
+  tracker->addKeyValue("a", 10.f);
+  tracker->addKeyValue("c", 10.f);
+  tracker->addTime(1.0);
+  tracker->addKeyValue("a", 20.f);
+  tracker->addKeyValue("c", 20.f);
+  tracker->addTime(2.0);
+
+  auto t0 = clock::now();
+  gmCore::Updateable::updateAll(t0);
+  gmCore::Updateable::updateAll(atSeconds(t0, 0.5));
+
+  auto state = tracker->get();
+  ASSERT_TRUE(state);
+  EXPECT_FLOAT_EQ(5.f, state->at("a").value);
+  // Not interpolated towards a sample without the key
+  EXPECT_FLOAT_EQ(0.f, state->at("b").value);
+  EXPECT_FALSE(state->contains("c"));
+
+  gmCore::Updateable::updateAll(atSeconds(t0, 1.5));
+  state = tracker->get();
+  EXPECT_FLOAT_EQ(15.f, state->at("c").value);
+  EXPECT_FALSE(state->contains("b"));
+}
+
+TEST(gmTrackTimeSampleTracker, SampleFile) {
+
+  auto path = std::filesystem::temp_directory_path() / "gramods_test_samples.gmts";
+
+  {
+    // Small chunks, so that "hand" is added mid chunk
+    gmTrack::TimeSampleFile::Writer writer(path, 7, 4);
+    for (int idx = 0; idx < 10; ++idx) {
+      gmCore::Pose head(Eigen::Vector3f(float(idx), 0, 0),
+                        Eigen::Quaternionf::Identity());
+      writer.addValue("head", head);
+      if (idx >= 5)
+        writer.addValue("hand", gmCore::Pose(head.position + Eigen::Vector3f::UnitY(),
+                                             head.orientation));
+      writer.commit(0.1 * idx);
+    }
+    EXPECT_THROW(writer.commit(0.0), gmCore::InvalidArgument);
+  }
+
+  gmTrack::TimeSampleFile file(path);
+  EXPECT_EQ(10, file.size());
+  EXPECT_EQ(std::vector<std::string>({ "head", "hand" }), file.getKeys());
+  EXPECT_DOUBLE_EQ(0.3, file.getTime(3));
+  EXPECT_DOUBLE_EQ(0.9, file.getTime(9));
+
+  gmCore::Pose pose;
+  EXPECT_FALSE(file.getValue(4, 1, pose));
+  EXPECT_TRUE(file.getValue(6, 1, pose));
+  EXPECT_FLOAT_EQ(1.f, pose.position.y());
+
+  auto tracker = std::make_shared<gmTrack::PoseTimeSampleTracker>();
+  tracker->setSampleFile(path);
+
+  auto t0 = clock::now();
+  gmCore::Updateable::updateAll(t0);
+  gmCore::Updateable::updateAll(atSeconds(t0, 0.25));
+
+  auto state = tracker->get();
+  ASSERT_TRUE(state);
+  EXPECT_NEAR(2.5f, state->at("head").value.position.x(), 1e-4f);
+  EXPECT_FALSE(state->contains("hand"));
+
+  gmCore::Updateable::updateAll(atSeconds(t0, 0.75));
+  state = tracker->get();
+  EXPECT_NEAR(7.5f, state->at("head").value.position.x(), 1e-4f);
+  EXPECT_NEAR(7.5f, state->at("hand").value.position.x(), 1e-4f);
+  EXPECT_NEAR(1.f, state->at("hand").value.position.y(), 1e-4f);
+
+  auto float_tracker = std::make_shared<gmTrack::FloatTimeSampleTracker>();
+  EXPECT_THROW(float_tracker->setSampleFile(path), gmCore::InvalidArgument);
+
+  tracker.reset();
+  std::filesystem::remove(path);
+}
+
+TEST(gmTrackTimeSampleTracker, RecordAndReplay) {
+
+  auto path = std::filesystem::temp_directory_path() / "gramods_test_recording.gmts";
+
+  auto source = std::make_shared<gmTrack::FloatTimeSampleTracker>();
+  source->addKey("a");
+  for (int idx = 0; idx < 3; ++idx) {
+    source->addValue(float(10 * idx));
+    source->addTime(double(idx));
+  }
+  source->setLoop(false);
+
+  auto t0 = clock::now();
+  {
+    auto recorder = std::make_shared<gmTrack::TrackerRecorder>();
+    recorder->setFloatTracker(source);
+    recorder->setFile(path);
+    recorder->setQueueSize(64);
+    recorder->initialize();
+
+    // One record per update of the source, at 10 Hz
+    for (int frame = 0; frame <= 20; ++frame)
+      gmCore::Updateable::updateAll(atSeconds(t0, 0.1 * frame));
+
+    recorder->close();
+    EXPECT_EQ(21, recorder->getRecordCount());
+    EXPECT_EQ(0, recorder->getDropCount());
+  }
+  source.reset();
+
+  gmTrack::TimeSampleFile file(path);
+  EXPECT_EQ(std::vector<std::string>({ "a" }), file.getKeys());
+  EXPECT_EQ(21, file.size());
+  EXPECT_DOUBLE_EQ(0.0, file.getTime(0));
+
+  auto replay = std::make_shared<gmTrack::FloatRecordedTracker>();
+  replay->setFile(path);
+  replay->setSpeed(2.0);
+  replay->setLoop(false);
+
+  gmCore::Updateable::updateAll(t0);
+  gmCore::Updateable::updateAll(atSeconds(t0, 0.5));
+  EXPECT_NEAR(10.f, replay->get()->at("a").value, 1e-4f);
+
+  // Stays at the last record when not looping
+  gmCore::Updateable::updateAll(atSeconds(t0, 100.0));
+  EXPECT_NEAR(20.f, replay->get()->at("a").value, 1e-4f);
+
+  replay.reset();
+  std::filesystem::remove(path);
+}
+
+TEST(gmTrackTimeSampleTracker, RecordSampleAge) {
+
+  auto path = std::filesystem::temp_directory_path() / "gramods_test_sample_age.gmts";
+
+  // Key a is updated every frame while key b keeps its first sample
+  auto source = std::make_shared<ScriptedFloatTracker>();
+  auto t0 = clock::now();
+  {
+    auto recorder = std::make_shared<gmTrack::TrackerRecorder>();
+    recorder->setFloatTracker(source);
+    recorder->setFile(path);
+    recorder->initialize();
+
+    for (int frame = 0; frame < 5; ++frame) {
+      source->state = gmTrack::FloatTracker::State{
+        { "a", { atSeconds(t0, 0.1 * frame), float(frame) } },
+        { "b", { t0, 1.f } } };
+      gmCore::Updateable::updateAll(atSeconds(t0, 0.1 * frame));
+    }
+
+    recorder->close();
+    EXPECT_EQ(5, recorder->getRecordCount());
+  }
+  source.reset();
+
+  gmTrack::TimeSampleFile file(path);
+  ASSERT_EQ(5, file.size());
+  const auto &keys = file.getKeys();
+  size_t a_idx = std::find(keys.begin(), keys.end(), "a") - keys.begin();
+  size_t b_idx = std::find(keys.begin(), keys.end(), "b") - keys.begin();
+  ASSERT_LT(a_idx, keys.size());
+  ASSERT_LT(b_idx, keys.size());
+  EXPECT_EQ(0.0, file.getAge(4, a_idx));
+  EXPECT_NEAR(0.4, file.getAge(4, b_idx), 1e-6);
+
+  auto replay = std::make_shared<gmTrack::FloatRecordedTracker>();
+  replay->setFile(path);
+  replay->setLoop(false);
+
+  auto t1 = clock::now();
+  gmCore::Updateable::updateAll(t1);
+  gmCore::Updateable::updateAll(atSeconds(t1, 0.3));
+
+  auto state = replay->get();
+  ASSERT_TRUE(state);
+  EXPECT_EQ(atSeconds(t1, 0.3), state->at("a").time);
+  EXPECT_NEAR(0.3, gmCore::TimeTools::durationToSeconds(atSeconds(t1, 0.3) - state->at("b").time),
+              1e-4);
+
+  replay.reset();
+  std::filesystem::remove(path);
+}
+
+TEST(gmTrackTimeSampleTracker, DISABLED_Benchmark30MinutesAt240Hz) {
+
+  const size_t N = 30 * 60 * 240;
+
+  auto tracker = std::make_shared<gmTrack::FloatTimeSampleTracker>();
+  tracker->addKey("a");
+  for (size_t idx = 0; idx < N; ++idx) {
+    tracker->addValue(float(idx));
+    tracker->addTime(idx / 240.0);
+  }
+
+  auto t0 = clock::now();
+  gmCore::Updateable::updateAll(t0);
+
+  // Play the last minute at 60 Hz, where a linear scan is slowest
+  const size_t frames = 60 * 60;
+  auto start = clock::now();
+  for (size_t frame = 0; frame < frames; ++frame)
+    gmCore::Updateable::updateAll(atSeconds(t0, 29 * 60 + frame / 60.0));
+  auto end = clock::now();
+
+  EXPECT_NEAR(N - 240 / 60, tracker->get()->at("a").value, 1.f);
+
+  std::cout << "Playing " << frames << " frames from " << N << " samples: "
+            << gmCore::TimeTools::durationToSeconds(end - start) << " s"
+            << std::endl;
+}
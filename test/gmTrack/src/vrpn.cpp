@@ -7,6 +7,7 @@
 #include <gmCore/OStreamMessageSink.hh>
 #include <gmCore/NullMessageSink.hh>
 #include <gmCore/Updateable.hh>
+#include <gmCore/PreConditionViolation.hh>
 
 #include <memory>
 #include <string>
@@ -82,4 +83,49 @@ TEST(gmTrackVrpn, VrpnTracker) {
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
 }
 
+TEST(gmTrackVrpn, ThreadedVrpnTracker) {
+
+  gmCore::Console::removeAllSinks();
+
+  {
+    vrpn_ConnectionPtr conn = vrpn_ConnectionPtr::create_server_connection(3884);
+    vrpn_Tracker_Server server("TEST_DEVICE", conn.get());
+
+    struct timeval timestamp;
+    vrpn_gettimeofday(&timestamp, NULL);
+
+    vrpn_float64 position[3] = { 0.1, 0.2, 0.3 };
+    vrpn_float64 quaternion[4] = { 0.4, 0.5, 0.6, 0.7 };
+
+    std::optional<gmTrack::PoseVrpnTracker::State> state;
+    {
+      gmTrack::PoseVrpnTracker tracker;
+      tracker.addConnectionString("TEST_DEVICE@localhost:3884");
+      tracker.setThreaded(true);
+      tracker.initialize();
+
+      for (int idx = 0; idx < 20 && !state; ++idx) {
+        server.report_pose(0, timestamp, position, quaternion);
+        server.mainloop();
+        conn->mainloop();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        gmCore::Updateable::updateAll();
+
+        state = tracker.get();
+      }
+
+      EXPECT_THROW(tracker.addConnectionString("OTHER_DEVICE@localhost:3884"),
+                   gmCore::PreConditionViolation);
+    }
+
+    ASSERT_TRUE(state);
+    ASSERT_EQ(1, state->size());
+    Eigen::Vector3f err = state->begin()->second.value.position -
+                          Eigen::Vector3f(0.1f, 0.2f, 0.3f);
+    EXPECT_FLOAT_EQ(err.norm(), 0);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
 #endif